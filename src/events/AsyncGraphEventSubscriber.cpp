@@ -0,0 +1,78 @@
+//
+// Copyright (c) 2015, Deutsches Forschungszentrum für Künstliche Intelligenz GmbH.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+
+#include <envire_core/events/AsyncGraphEventSubscriber.hpp>
+#include <envire_core/events/GraphEvent.hpp>
+#include <envire_core/events/EdgeEvents.hpp>
+#include <memory>
+
+namespace envire { namespace core
+{
+
+AsyncGraphEventSubscriber::AsyncGraphEventSubscriber(GraphEventSubscriber& target,
+                                                     EventExecutor& executor) :
+    GraphEventSubscriber(), target(target), strand(executor)
+{
+    //don't clone events that the target is not interested in
+    setSubscriptionFilter(target.getSubscriptionFilter());
+}
+
+AsyncGraphEventSubscriber::AsyncGraphEventSubscriber(GraphEventPublisher* pPublisher,
+                                                     GraphEventSubscriber& target,
+                                                     EventExecutor& executor) :
+    AsyncGraphEventSubscriber(target, executor)
+{
+    subscribe(pPublisher);
+}
+
+AsyncGraphEventSubscriber::~AsyncGraphEventSubscriber()
+{
+    unsubscribe();
+    strand.wait();
+}
+
+void AsyncGraphEventSubscriber::notifyGraphEvent(const GraphEvent& event)
+{
+    //C++11 lambdas cannot capture by move, thus the event is shared
+    std::shared_ptr<GraphEvent> copy(event.clone());
+    //the edges may have been removed when the copy is delivered
+    clearEdgeDescriptors(*copy);
+    GraphEventSubscriber& target = this->target;
+    strand.post([copy, &target]() { target.notifyGraphEvent(*copy); });
+}
+
+bool AsyncGraphEventSubscriber::supportsBatchedEvents() const
+{
+    return target.supportsBatchedEvents();
+}
+
+void AsyncGraphEventSubscriber::wait()
+{
+    strand.wait();
+}
+
+}}
@@ -0,0 +1,82 @@
+//
+// Copyright (c) 2015, Deutsches Forschungszentrum für Künstliche Intelligenz GmbH.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+
+#pragma once
+
+#include <envire_core/events/GraphEventSubscriber.hpp>
+#include <envire_core/events/EventExecutor.hpp>
+
+namespace envire { namespace core
+{
+
+/**Delivers the events of a publisher to another subscriber on an executor.
+ *
+ * The publisher only clones the event and posts it, thus a slow subscriber
+ * (e.g. a logger or a visualization) does not slow down the modifications
+ * of the graph. The events are delivered in order, even if the executor is
+ * a thread pool that is shared with other subscribers.
+ *
+ * The SubscriptionFilter of @p target is copied when the subscriber is
+ * created, thus uninteresting events are not cloned.
+ *
+ * The @p target must not be subscribed to the publisher itself. It is
+ * called from the executor's threads and must not modify the graph.
+ * Subscribers that have to see the graph in the state of the event, e.g.
+ * Path or TransformCache, have to stay synchronous. The edge may have been
+ * removed by the time an edge event is delivered, thus the edge descriptors
+ * of EdgeAddedEvents and EdgeModifiedEvents are cleared, i.e. set to
+ * GraphTraits::edge_descriptor(). Use the frames of the event instead.
+ *
+ * Example:
+ * @code
+ *   ThreadPoolExecutor pool(2);
+ *   MyLogger logger;
+ *   AsyncGraphEventSubscriber async(&graph, logger, pool);
+ * @endcode
+ */
+class AsyncGraphEventSubscriber : public GraphEventSubscriber
+{
+public:
+    AsyncGraphEventSubscriber(GraphEventSubscriber& target, EventExecutor& executor);
+    AsyncGraphEventSubscriber(GraphEventPublisher* pPublisher,
+                              GraphEventSubscriber& target, EventExecutor& executor);
+    /**Unsubscribes and waits until the pending events have been delivered */
+    virtual ~AsyncGraphEventSubscriber();
+
+    virtual void notifyGraphEvent(const GraphEvent& event) override;
+    virtual bool supportsBatchedEvents() const override;
+
+    /**Blocks until all events that have been published so far have been
+     * delivered to the target. */
+    void wait();
+
+private:
+    GraphEventSubscriber& target;
+    Strand strand;
+};
+
+}}
@@ -0,0 +1,233 @@
+//
+// Copyright (c) 2015, Deutsches Forschungszentrum für Künstliche Intelligenz GmbH.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+
+#include <envire_core/events/ConcurrentGraphEventQueue.hpp>
+#include <envire_core/events/EdgeEvents.hpp>
+
+#include <cstdint>
+#include <thread>
+
+namespace envire { namespace core
+{
+
+namespace
+{
+    std::size_t roundUpToPowerOfTwo(const std::size_t value)
+    {
+        std::size_t result = 2;
+        while(result < value)
+            result <<= 1;
+        return result;
+    }
+}
+
+void ConcurrentGraphEventQueue::Overflow::process(const GraphEvent& event)
+{
+    owner.process(event);
+}
+
+ConcurrentGraphEventQueue::ConcurrentGraphEventQueue(const std::size_t capacity,
+                                                     const OverflowPolicy policy) :
+    GraphEventSubscriber(), policy(policy), mask(roundUpToPowerOfTwo(capacity) - 1),
+    cells(new Cell[mask + 1]), enqueuePos(0), dequeuePos(0), overflowing(false),
+    overflow(new Overflow(*this)), draining(new Overflow(*this)), merges(0),
+    drops(0), overflows(0)
+{
+    for(std::size_t i = 0; i <= mask; ++i)
+    {
+        cells[i].sequence.store(i, std::memory_order_relaxed);
+        cells[i].event = nullptr;
+    }
+}
+
+ConcurrentGraphEventQueue::ConcurrentGraphEventQueue(GraphEventPublisher* pPublisher,
+                                                     const std::size_t capacity,
+                                                     const OverflowPolicy policy) :
+    ConcurrentGraphEventQueue(capacity, policy)
+{
+    subscribe(pPublisher);
+}
+
+ConcurrentGraphEventQueue::~ConcurrentGraphEventQueue()
+{
+    //stop receiving events before the ring is destroyed
+    unsubscribe();
+    GraphEvent* event;
+    while(tryPop(event))
+        delete event;
+}
+
+void ConcurrentGraphEventQueue::notifyGraphEvent(const GraphEvent& event)
+{
+    //the edges may have been removed when the copy is processed
+    std::unique_ptr<GraphEvent> copy(event.clone());
+    clearEdgeDescriptors(*copy);
+
+    if(policy == COALESCE && overflowing.load(std::memory_order_acquire))
+    {
+        //keep the order, once a producer overflowed all events go to the
+        //overflow queue until the consumer took them
+        std::lock_guard<std::mutex> lock(overflowMutex);
+        if(overflowing.load(std::memory_order_relaxed))
+        {
+            overflow->notifyGraphEvent(*copy);
+            ++overflows;
+            return;
+        }
+    }
+
+    while(!tryPush(copy.get()))
+    {
+        switch(policy)
+        {
+            case BLOCK:
+                std::this_thread::yield();
+                break;
+            case DROP_OLDEST:
+            {
+                GraphEvent* oldest;
+                if(tryPop(oldest))
+                {
+                    delete oldest;
+                    ++drops;
+                }
+                break;
+            }
+            case COALESCE:
+            {
+                std::lock_guard<std::mutex> lock(overflowMutex);
+                overflowing.store(true, std::memory_order_release);
+                overflow->notifyGraphEvent(*copy);
+                ++overflows;
+                return;
+            }
+        }
+    }
+    //the ring owns the copy now
+    copy.release();
+}
+
+std::size_t ConcurrentGraphEventQueue::flush()
+{
+    //events that were left over because process() threw are the oldest
+    std::size_t count = draining->size();
+    draining->flush();
+
+    GraphEvent* event;
+    while(tryPop(event))
+    {
+        processAndDelete(event);
+        ++count;
+    }
+
+    if(policy == COALESCE && overflowing.load(std::memory_order_acquire))
+    {
+        //the ring has been drained, the overflow events come next.
+        //Producers use the ring again afterwards.
+        {
+            std::lock_guard<std::mutex> lock(overflowMutex);
+            overflow.swap(draining);
+            overflowing.store(false, std::memory_order_release);
+            merges += draining->getMergeCount();
+            draining->resetStatistics();
+        }
+        count += draining->size();
+        draining->flush();
+    }
+    return count;
+}
+
+std::size_t ConcurrentGraphEventQueue::getMergeCount() const
+{
+    std::lock_guard<std::mutex> lock(overflowMutex);
+    return merges + overflow->getMergeCount();
+}
+
+bool ConcurrentGraphEventQueue::tryPush(GraphEvent* event)
+{
+    std::size_t pos = enqueuePos.load(std::memory_order_relaxed);
+    Cell* cell;
+    while(true)
+    {
+        cell = &cells[pos & mask];
+        const std::size_t sequence = cell->sequence.load(std::memory_order_acquire);
+        const std::intptr_t diff = static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(pos);
+        if(diff == 0)
+        {
+            if(enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                break;
+        }
+        else if(diff < 0)
+        {
+            return false; //full
+        }
+        else
+        {
+            pos = enqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+    cell->event = event;
+    cell->sequence.store(pos + 1, std::memory_order_release);
+    return true;
+}
+
+bool ConcurrentGraphEventQueue::tryPop(GraphEvent*& event)
+{
+    //DROP_OLDEST producers pop as well, thus this has to be multi consumer safe
+    std::size_t pos = dequeuePos.load(std::memory_order_relaxed);
+    Cell* cell;
+    while(true)
+    {
+        cell = &cells[pos & mask];
+        const std::size_t sequence = cell->sequence.load(std::memory_order_acquire);
+        const std::intptr_t diff = static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(pos + 1);
+        if(diff == 0)
+        {
+            if(dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                break;
+        }
+        else if(diff < 0)
+        {
+            return false; //empty
+        }
+        else
+        {
+            pos = dequeuePos.load(std::memory_order_relaxed);
+        }
+    }
+    event = cell->event;
+    cell->sequence.store(pos + mask + 1, std::memory_order_release);
+    return true;
+}
+
+void ConcurrentGraphEventQueue::processAndDelete(GraphEvent* event)
+{
+    std::unique_ptr<GraphEvent> owner(event);
+    process(*owner);
+}
+
+}}
@@ -0,0 +1,156 @@
+//
+// Copyright (c) 2015, Deutsches Forschungszentrum für Künstliche Intelligenz GmbH.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+
+#pragma once
+
+#include <envire_core/events/GraphEventSubscriber.hpp>
+#include <envire_core/events/GraphEventQueue.hpp>
+#include <envire_core/events/GraphEvent.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+
+namespace envire { namespace core
+{
+
+/**Queues events of the graph's thread for a consumer on another thread,
+ * e.g. a visualization or logging thread.
+ *
+ * The threads that modify the graph push clones of the events into a lock
+ * free ring buffer, several of them may do so at once. A single consumer
+ * thread calls flush() to process them. If the consumer does not keep up
+ * and the ring is full, the overflow policy decides what happens:
+ *
+ * - BLOCK: the producer waits until the consumer made room.
+ * - DROP_OLDEST: the oldest queued events are dropped and counted.
+ * - COALESCE: the producer moves on to an unbounded overflow queue that
+ *   merges events like GraphEventQueue. Only the latest modification of
+ *   an edge is kept and events of frames and items that have been added
+ *   and removed again cancel out. The overflow queue is protected by a
+ *   mutex. The consumer only holds it to swap the overflow queue with an
+ *   empty one and processes the taken events afterwards.
+ *
+ * Only BLOCK can stall the producers. The events of one producer are
+ * processed in order, unless events are dropped. The order of events of
+ * different producers is only kept as long as the ring does not overflow.
+ * With COALESCE a producer that is about to push into the ring when
+ * another producer switches to the overflow queue still pushes into the
+ * ring. Its event is processed before the overflow events, although it
+ * may have been pushed after them.
+ *
+ * The edges may have been removed when an event is processed, thus the
+ * edge descriptors of the queued edge events are cleared, i.e. set to
+ * GraphTraits::edge_descriptor().
+ *
+ * @note The consumer must not be the thread that modifies the graph if
+ *       BLOCK is used, it would wait for itself. */
+class ConcurrentGraphEventQueue : public GraphEventSubscriber
+{
+public:
+    enum OverflowPolicy
+    {
+        BLOCK,
+        DROP_OLDEST,
+        COALESCE
+    };
+
+    /** @param capacity the size of the ring buffer, rounded up to a power of two */
+    explicit ConcurrentGraphEventQueue(const std::size_t capacity = 1024,
+                                       const OverflowPolicy policy = BLOCK);
+    ConcurrentGraphEventQueue(GraphEventPublisher* pPublisher,
+                              const std::size_t capacity = 1024,
+                              const OverflowPolicy policy = BLOCK);
+    virtual ~ConcurrentGraphEventQueue();
+
+    /**Called by the producers, i.e. the publisher */
+    virtual void notifyGraphEvent(const GraphEvent& event) override;
+
+    /**Calls process() for all queued events. Must only be called by the
+     * consumer thread.
+     * @return the number of processed events */
+    std::size_t flush();
+
+    /**This callback is called by flush() for each queued event */
+    virtual void process(const GraphEvent& event) = 0;
+
+    std::size_t getCapacity() const { return mask + 1; }
+    OverflowPolicy getOverflowPolicy() const { return policy; }
+    /** @return the number of events dropped by DROP_OLDEST */
+    std::size_t getDropCount() const { return drops; }
+    /** @return the number of events that went to the overflow queue of COALESCE */
+    std::size_t getOverflowCount() const { return overflows; }
+    /** @return the number of overflow events that have been merged */
+    std::size_t getMergeCount() const;
+
+private:
+    /**A cell of the ring. The sequence tells producers and the consumer
+     * whose turn it is, see Dmitry Vyukov's bounded MPMC queue. */
+    struct Cell
+    {
+        std::atomic<std::size_t> sequence;
+        GraphEvent* event;
+    };
+
+    /**The merging queue used by COALESCE. Forwards its events to the
+     * process() of the owner when it is flushed. */
+    class Overflow : public GraphEventQueue
+    {
+    public:
+        explicit Overflow(ConcurrentGraphEventQueue& owner) : owner(owner) {}
+        virtual void process(const GraphEvent& event) override;
+    private:
+        ConcurrentGraphEventQueue& owner;
+    };
+
+    bool tryPush(GraphEvent* event);
+    bool tryPop(GraphEvent*& event);
+    /**Processes and deletes @p event even if process() throws */
+    void processAndDelete(GraphEvent* event);
+
+    const OverflowPolicy policy;
+    std::size_t mask;
+    std::unique_ptr<Cell[]> cells;
+    /**On their own cache lines, producers and consumer should not share them */
+    alignas(64) std::atomic<std::size_t> enqueuePos;
+    alignas(64) std::atomic<std::size_t> dequeuePos;
+
+    alignas(64) std::atomic<bool> overflowing;
+    mutable std::mutex overflowMutex;
+    /**The producers fill overflow, guarded by overflowMutex. flush()
+     * swaps it with draining, which only the consumer uses. */
+    std::unique_ptr<Overflow> overflow;
+    std::unique_ptr<Overflow> draining;
+    /**Merges of the overflow queues that have been swapped out */
+    std::atomic<std::size_t> merges;
+
+    std::atomic<std::size_t> drops;
+    std::atomic<std::size_t> overflows;
+};
+
+}}
@@ -30,6 +30,8 @@
 #include <envire_core/graph/GraphTypes.hpp>
 #include <envire_core/events/GraphEvent.hpp>
 
+#include <vector>
+
 namespace envire { namespace core
 {
     class EdgeEvent : public GraphEvent
@@ -46,20 +48,20 @@ namespace envire { namespace core
             if((event.getType() == EDGE_MODIFIED && type == EDGE_MODIFIED) || event.getType() == EDGE_REMOVED)
             {
                 // check if the edge is the same
-                const EdgeEvent& edge_event = dynamic_cast<const EdgeEvent&>(event);
+                const EdgeEvent& edge_event = static_cast<const EdgeEvent&>(event);
                 if(*this == edge_event)
                     return true;
             }
             return false;
         }
 
-        FrameId origin;/**<Source vertex of the transform */
-        FrameId target; /**<Target vertex of the transform */
+        FrameSymbol origin;/**<Source vertex of the transform */
+        FrameSymbol target; /**<Target vertex of the transform */
 
     protected:
         EdgeEvent(const Type type,
-                    const FrameId& origin,
-                    const FrameId& target) :
+                    const FrameSymbol& origin,
+                    const FrameSymbol& target) :
             GraphEvent(type), origin(origin), target(target) {}
 
 
@@ -74,8 +76,8 @@ namespace envire { namespace core
     class EdgeAddedEvent : public EdgeEvent
     {
     public:
-        EdgeAddedEvent(const FrameId& origin,
-                        const FrameId& target,
+        EdgeAddedEvent(const FrameSymbol& origin,
+                        const FrameSymbol& target,
                         const GraphTraits::edge_descriptor& edge) :
             EdgeEvent(GraphEvent::EDGE_ADDED, origin, target), edge(edge){}
 
@@ -91,8 +93,8 @@ namespace envire { namespace core
     class EdgeModifiedEvent : public EdgeEvent
     {
     public:
-        EdgeModifiedEvent(const FrameId& origin,
-                        const FrameId& target,
+        EdgeModifiedEvent(const FrameSymbol& origin,
+                        const FrameSymbol& target,
                         const GraphTraits::edge_descriptor edge,
                         const GraphTraits::edge_descriptor inverseEdge) :
         EdgeEvent(GraphEvent::EDGE_MODIFIED, origin, target), edge(edge), inverseEdge(inverseEdge){}
@@ -106,13 +108,34 @@ namespace envire { namespace core
         GraphTraits::edge_descriptor inverseEdge;
     };
 
+
+    /**Several edges that have been modified at once, e.g. by
+     * Graph::setEdgeProperties(). Subscribers that do not support batched
+     * events receive the contained EdgeModifiedEvents one by one instead.
+     * @see GraphEventSubscriber::supportsBatchedEvents() */
+    class EdgesModifiedEvent : public GraphEvent
+    {
+    public:
+        EdgesModifiedEvent() : GraphEvent(GraphEvent::EDGES_MODIFIED) {}
+
+        GraphEvent* clone() const
+        {
+            EdgesModifiedEvent* copy = new EdgesModifiedEvent();
+            copy->events = events;
+            return copy;
+        }
+
+        /**In the order of modification */
+        std::vector<EdgeModifiedEvent> events;
+    };
+
     
     class EdgeRemovedEvent : public EdgeEvent
     {
     public:
       //EdgeRemovedEvent does not contain an edge_descriptor because it has already been
       //removed from the graph when the event is raised and thus doesnt exist anymore.
-        EdgeRemovedEvent(const FrameId& origin, const FrameId& target) :
+        EdgeRemovedEvent(const FrameSymbol& origin, const FrameSymbol& target) :
             EdgeEvent(GraphEvent::EDGE_REMOVED, origin, target) {}
 
         GraphEvent* clone() const
@@ -120,4 +143,30 @@ namespace envire { namespace core
             return new EdgeRemovedEvent(origin, target);
         }
     };
+
+    /**Sets the edge descriptors of @p event to GraphTraits::edge_descriptor()
+     * if it is an edge event. Used for copies of events that are processed
+     * later, when the edges might have been removed already. */
+    inline void clearEdgeDescriptors(GraphEvent& event)
+    {
+        switch(event.getType())
+        {
+            case GraphEvent::EDGE_ADDED:
+                static_cast<EdgeAddedEvent&>(event).edge = GraphTraits::edge_descriptor();
+                break;
+            case GraphEvent::EDGE_MODIFIED:
+            {
+                EdgeModifiedEvent& modified = static_cast<EdgeModifiedEvent&>(event);
+                modified.edge = GraphTraits::edge_descriptor();
+                modified.inverseEdge = GraphTraits::edge_descriptor();
+                break;
+            }
+            case GraphEvent::EDGES_MODIFIED:
+                for(EdgeModifiedEvent& modified : static_cast<EdgesModifiedEvent&>(event).events)
+                    clearEdgeDescriptors(modified);
+                break;
+            default:
+                break;
+        }
+    }
 }}
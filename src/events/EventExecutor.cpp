@@ -0,0 +1,158 @@
+//
+// Copyright (c) 2015, Deutsches Forschungszentrum für Künstliche Intelligenz GmbH.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+
+#include <envire_core/events/EventExecutor.hpp>
+#include <glog/logging.h>
+#include <exception>
+#include <utility>
+
+namespace envire { namespace core
+{
+
+ThreadPoolExecutor::ThreadPoolExecutor(const std::size_t numThreads) : stopping(false)
+{
+    const std::size_t count = numThreads > 0 ? numThreads : 1;
+    threads.reserve(count);
+    for(std::size_t i = 0; i < count; ++i)
+        threads.emplace_back(&ThreadPoolExecutor::work, this);
+}
+
+ThreadPoolExecutor::~ThreadPoolExecutor()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    taskAvailable.notify_all();
+    for(std::thread& thread : threads)
+        thread.join();
+}
+
+void ThreadPoolExecutor::post(Task task)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        tasks.push_back(std::move(task));
+    }
+    taskAvailable.notify_one();
+}
+
+void ThreadPoolExecutor::work()
+{
+    while(true)
+    {
+        Task task;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            taskAvailable.wait(lock, [this]() { return stopping || !tasks.empty(); });
+            //the remaining tasks are run before stopping
+            if(tasks.empty())
+                return;
+            task = std::move(tasks.front());
+            tasks.pop_front();
+        }
+        try
+        {
+            task();
+        }
+        catch(const std::exception& ex)
+        {
+            LOG(ERROR) << "Exception in asynchronous task: " << ex.what();
+        }
+        catch(...)
+        {
+            LOG(ERROR) << "Unknown exception in asynchronous task";
+        }
+    }
+}
+
+Strand::Strand(EventExecutor& executor) : executor(executor), running(false)
+{
+}
+
+Strand::~Strand()
+{
+    wait();
+}
+
+void Strand::post(Task task)
+{
+    bool schedule = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        tasks.push_back(std::move(task));
+        if(!running)
+        {
+            running = true;
+            schedule = true;
+        }
+    }
+    if(schedule)
+        executor.post([this]() { run(); });
+}
+
+void Strand::wait()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    idle.wait(lock, [this]() { return !running; });
+}
+
+void Strand::run()
+{
+    //only one run() is scheduled at a time, this keeps the tasks in order
+    while(true)
+    {
+        Task task;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if(tasks.empty())
+            {
+                running = false;
+                //notify while holding the lock, the strand may be destroyed
+                //as soon as wait() returns
+                idle.notify_all();
+                return;
+            }
+            task = std::move(tasks.front());
+            tasks.pop_front();
+        }
+        try
+        {
+            task();
+        }
+        catch(const std::exception& ex)
+        {
+            LOG(ERROR) << "Exception in asynchronous task: " << ex.what();
+        }
+        catch(...)
+        {
+            LOG(ERROR) << "Unknown exception in asynchronous task";
+        }
+    }
+}
+
+}}
@@ -0,0 +1,107 @@
+//
+// Copyright (c) 2015, Deutsches Forschungszentrum für Künstliche Intelligenz GmbH.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace envire { namespace core
+{
+
+/**Runs tasks asynchronously, e.g. the delivery of graph events to an
+ * AsyncGraphEventSubscriber. */
+class EventExecutor
+{
+public:
+    typedef std::function<void()> Task;
+
+    virtual ~EventExecutor() {}
+
+    /**Schedules @p task for execution. Must not block until it is done. */
+    virtual void post(Task task) = 0;
+};
+
+/**Runs tasks on a fixed number of worker threads.
+ * Tasks posted to the pool may run concurrently and in any order, use a
+ * Strand to run them one after another.
+ * Exceptions thrown by tasks are logged and dropped. */
+class ThreadPoolExecutor : public EventExecutor
+{
+public:
+    explicit ThreadPoolExecutor(const std::size_t numThreads = 1);
+    /**Runs all posted tasks and joins the worker threads */
+    virtual ~ThreadPoolExecutor();
+
+    virtual void post(Task task) override;
+
+    std::size_t getNumThreads() const { return threads.size(); }
+
+private:
+    void work();
+
+    std::vector<std::thread> threads;
+    std::mutex mutex;
+    std::condition_variable taskAvailable;
+    std::deque<Task> tasks;
+    bool stopping;
+};
+
+/**Runs the posted tasks one after another and in the order they have been
+ * posted, using the threads of another executor.
+ * Several strands may share one thread pool. */
+class Strand : public EventExecutor
+{
+public:
+    explicit Strand(EventExecutor& executor);
+    /**Waits until all posted tasks have run */
+    virtual ~Strand();
+
+    virtual void post(Task task) override;
+
+    /**Blocks until all tasks that have been posted so far have run.
+     * Must not be called from a task of this strand. */
+    void wait();
+
+private:
+    /**Runs the queued tasks on the underlying executor */
+    void run();
+
+    EventExecutor& executor;
+    std::mutex mutex;
+    std::condition_variable idle;
+    std::deque<Task> tasks;
+    /**True while run() is scheduled or running */
+    bool running;
+};
+
+}}
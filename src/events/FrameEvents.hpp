@@ -40,24 +40,24 @@ namespace envire { namespace core
         {
             if(type == FRAME_ADDED && event.getType() == FRAME_REMOVED)
             {
-                const FrameEvent& frame_event = dynamic_cast<const FrameEvent&>(event);
+                const FrameEvent& frame_event = static_cast<const FrameEvent&>(event);
                 if(frame == frame_event.frame)
                     return true;
             }
             return false;
         }
 
-        FrameId frame;
+        FrameSymbol frame;
 
     protected:
-        explicit FrameEvent(const Type type, const FrameId& addedFrame) :
+        explicit FrameEvent(const Type type, const FrameSymbol& addedFrame) :
                     GraphEvent(type), frame(addedFrame){}
     };
 
     class FrameAddedEvent : public FrameEvent
     {
     public:
-      explicit FrameAddedEvent(const FrameId& addedFrame) :
+      explicit FrameAddedEvent(const FrameSymbol& addedFrame) :
         FrameEvent(GraphEvent::FRAME_ADDED, addedFrame) {}
 
         GraphEvent* clone() const
@@ -69,7 +69,7 @@ namespace envire { namespace core
     class FrameRemovedEvent : public FrameEvent
     {
     public:
-      explicit FrameRemovedEvent(const FrameId& removedFrame) :
+      explicit FrameRemovedEvent(const FrameSymbol& removedFrame) :
         FrameEvent(GraphEvent::FRAME_REMOVED, removedFrame) {}
 
         GraphEvent* clone() const
@@ -54,6 +54,9 @@ std::ostream& operator<<(std::ostream& ostream, const GraphEvent& graph_event)
             break;
         case GraphEvent::ITEM_REMOVED_FROM_FRAME:
             ostream << "ITEM_REMOVED_FROM_FRAME";
+            break;
+        case GraphEvent::EDGES_MODIFIED:
+            ostream << "EDGES_MODIFIED";
     }
     return ostream;
 }
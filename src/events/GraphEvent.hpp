@@ -30,7 +30,11 @@
 namespace envire { namespace core
 {
 
-    /** TODO comment
+    /** Base class of all events of the graph.
+     *
+     * The type identifies the class of an event, e.g. an event of type
+     * EDGE_ADDED is an EdgeAddedEvent. Dispatchers rely on this and cast
+     * events using static_cast, thus derived events must not change the type.
      */
     class GraphEvent
     {
@@ -44,7 +48,8 @@ namespace envire { namespace core
             ITEM_ADDED_TO_FRAME,
             ITEM_REMOVED_FROM_FRAME,
             FRAME_ADDED,
-            FRAME_REMOVED
+            FRAME_REMOVED,
+            EDGES_MODIFIED /**<several EDGE_MODIFIED events at once */
         };
 
         GraphEvent() = delete;
@@ -43,28 +43,32 @@ GraphEventDispatcher::GraphEventDispatcher()
 
 void GraphEventDispatcher::notifyGraphEvent(const GraphEvent& event)
 {
+    //the type determines the class of the event, thus no dynamic_cast is needed
     switch(event.getType())
     {
     case GraphEvent::EDGE_ADDED:
-        edgeAdded(dynamic_cast<const EdgeAddedEvent&>(event));
+        edgeAdded(static_cast<const EdgeAddedEvent&>(event));
         break;
     case GraphEvent::EDGE_MODIFIED:
-        edgeModified(dynamic_cast<const EdgeModifiedEvent&>(event));
+        edgeModified(static_cast<const EdgeModifiedEvent&>(event));
         break;
     case GraphEvent::EDGE_REMOVED:
-        edgeRemoved(dynamic_cast<const EdgeRemovedEvent&>(event));
+        edgeRemoved(static_cast<const EdgeRemovedEvent&>(event));
         break;
     case GraphEvent::FRAME_ADDED:
-        frameAdded(dynamic_cast<const FrameAddedEvent&>(event));
+        frameAdded(static_cast<const FrameAddedEvent&>(event));
         break;
     case GraphEvent::FRAME_REMOVED:
-        frameRemoved(dynamic_cast<const FrameRemovedEvent&>(event));
+        frameRemoved(static_cast<const FrameRemovedEvent&>(event));
         break;
     case GraphEvent::ITEM_ADDED_TO_FRAME:
-        itemAdded(dynamic_cast<const ItemAddedEvent&>(event));
+        itemAdded(static_cast<const ItemAddedEvent&>(event));
         break;
     case GraphEvent::ITEM_REMOVED_FROM_FRAME:
-        itemRemoved(dynamic_cast<const ItemRemovedEvent&>(event));
+        itemRemoved(static_cast<const ItemRemovedEvent&>(event));
+        break;
+    case GraphEvent::EDGES_MODIFIED:
+        edgesModified(static_cast<const EdgesModifiedEvent&>(event));
         break;
     default:
       break;
@@ -73,5 +77,10 @@ void GraphEventDispatcher::notifyGraphEvent(const GraphEvent& event)
     }
 }
 
-
-
+void GraphEventDispatcher::edgesModified(const EdgesModifiedEvent& e)
+{
+    for(const EdgeModifiedEvent& event : e.events)
+    {
+        edgeModified(event);
+    }
+}
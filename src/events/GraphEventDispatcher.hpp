@@ -34,6 +34,7 @@ namespace envire { namespace core
     class EdgeAddedEvent;
     class EdgeRemovedEvent;
     class EdgeModifiedEvent;
+    class EdgesModifiedEvent;
     class ItemRemovedEvent;
     class FrameAddedEvent;
     class FrameRemovedEvent;
@@ -58,11 +59,15 @@ namespace envire { namespace core
         GraphEventDispatcher();
         virtual ~GraphEventDispatcher() {}
         virtual void notifyGraphEvent(const GraphEvent& event);
+        virtual bool supportsBatchedEvents() const { return true; }
 
     protected:
         virtual void edgeAdded(const EdgeAddedEvent& e) {}
         virtual void edgeRemoved(const EdgeRemovedEvent& e) {}
         virtual void edgeModified(const EdgeModifiedEvent& e) {}
+        /**Calls edgeModified() for each event by default. Override it to
+         * handle all modified edges in a single pass. */
+        virtual void edgesModified(const EdgesModifiedEvent& e);
         virtual void frameAdded(const FrameAddedEvent& e) {}
         virtual void frameRemoved(const FrameRemovedEvent& e) {}
         virtual void itemAdded(const ItemAddedEvent& e) {}
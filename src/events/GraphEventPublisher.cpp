@@ -33,27 +33,145 @@
 #include <algorithm>
 #include <envire_core/events/GraphEventPublisher.hpp>
 #include <envire_core/events/GraphEventSubscriber.hpp>
+#include <envire_core/events/EdgeEvents.hpp>
+#include <envire_core/events/FrameEvents.hpp>
+#include <envire_core/events/ItemAddedEvent.hpp>
+#include <envire_core/events/ItemRemovedEvent.hpp>
+#include <limits>
 #include <cassert>
 
 using namespace envire::core;
 using namespace std;
 
+namespace
+{
+    /**The frames and item type of an event, i.e. the keys of the routing tables */
+    struct RoutingKeys
+    {
+        const FrameSymbol* frames[2] = {nullptr, nullptr};
+        const ItemBase* item = nullptr;
+
+        explicit RoutingKeys(const GraphEvent& e)
+        {
+            switch(e.getType())
+            {
+                case GraphEvent::EDGE_ADDED:
+                case GraphEvent::EDGE_MODIFIED:
+                case GraphEvent::EDGE_REMOVED:
+                {
+                    const EdgeEvent& edgeEvent = static_cast<const EdgeEvent&>(e);
+                    frames[0] = &edgeEvent.origin;
+                    frames[1] = &edgeEvent.target;
+                    break;
+                }
+                case GraphEvent::FRAME_ADDED:
+                case GraphEvent::FRAME_REMOVED:
+                    frames[0] = &static_cast<const FrameEvent&>(e).frame;
+                    break;
+                case GraphEvent::ITEM_ADDED_TO_FRAME:
+                {
+                    const ItemAddedEvent& itemEvent = static_cast<const ItemAddedEvent&>(e);
+                    frames[0] = &itemEvent.frame;
+                    item = itemEvent.item.get();
+                    break;
+                }
+                case GraphEvent::ITEM_REMOVED_FROM_FRAME:
+                {
+                    const ItemRemovedEvent& itemEvent = static_cast<const ItemRemovedEvent&>(e);
+                    frames[0] = &itemEvent.frame;
+                    item = itemEvent.item.get();
+                    break;
+                }
+                case GraphEvent::EDGES_MODIFIED:
+                    break;
+            }
+        }
+    };
+
+    /**@return the routes with an order >= @p order */
+    template <class ROUTE>
+    typename std::vector<ROUTE>::const_iterator firstRoute(const std::vector<ROUTE>& routes,
+                                                          const std::uint64_t order)
+    {
+        return std::lower_bound(routes.begin(), routes.end(), order,
+                                [](const ROUTE& route, const std::uint64_t value)
+                                { return route.order < value; });
+    }
+
+    /**Inserts @p route sorted by order unless the subscriber is in @p routes already */
+    template <class ROUTE>
+    void insertRoute(std::vector<ROUTE>& routes, const ROUTE& route)
+    {
+        auto pos = firstRoute(routes, route.order);
+        if(pos == routes.end() || pos->order != route.order)
+            routes.insert(routes.begin() + (pos - routes.begin()), route);
+    }
+
+    template <class ROUTE>
+    void eraseRoute(std::vector<ROUTE>& routes, const std::uint64_t order)
+    {
+        auto pos = firstRoute(routes, order);
+        if(pos != routes.end() && pos->order == order)
+            routes.erase(routes.begin() + (pos - routes.begin()));
+    }
 
-GraphEventPublisher::GraphEventPublisher() : insideNotify(false)
+    template <class MAP, class KEY>
+    void eraseRoute(MAP& map, const KEY& key, const std::uint64_t order)
+    {
+        auto it = map.find(key);
+        if(it == map.end())
+            return;
+        eraseRoute(it->second, order);
+        if(it->second.empty())
+            map.erase(it);
+    }
+
+    bool isItemEvent(const GraphEvent::Type type)
+    {
+        return type == GraphEvent::ITEM_ADDED_TO_FRAME || type == GraphEvent::ITEM_REMOVED_FROM_FRAME;
+    }
+
+    /**The publishers whose notify() is running on this thread */
+    thread_local std::vector<const GraphEventPublisher*> notifyingPublishers;
+
+    /**Marks a publisher as notifying on this thread while it exists */
+    struct NotifyScope
+    {
+        explicit NotifyScope(const GraphEventPublisher* publisher)
+        {
+            notifyingPublishers.push_back(publisher);
+        }
+        ~NotifyScope()
+        {
+            notifyingPublishers.pop_back();
+        }
+    };
+}
+
+
+GraphEventPublisher::GraphEventPublisher() : numPrioritized(0), pendingChanges(false), nextOrder(0), observedTypes(0)
 {
     subscribers.reserve(10000);
 }
 
-void GraphEventPublisher::subscribe(GraphEventSubscriber* pSubscriber, bool publish_current_state)
+void GraphEventPublisher::subscribe(GraphEventSubscriber* pSubscriber, bool publish_current_state,
+                                    bool prioritized)
 {
     assert(nullptr != pSubscriber);
     if(publish_current_state)
         publishCurrentState(pSubscriber);
 
-    if(insideNotify)
-      toBeSubscribed.push_back(pSubscriber);
+    if(isNotifying())
+    {
+      std::lock_guard<std::mutex> lock(pendingMutex);
+      toBeSubscribed.emplace_back(pSubscriber, prioritized);
+      pendingChanges = true;
+    }
     else
-      subscribers.push_back(pSubscriber);
+    {
+      boost::unique_lock<boost::shared_mutex> lock(routesMutex);
+      subscribeInternal(pSubscriber, prioritized);
+    }
 }
 
 void GraphEventPublisher::unsubscribe(GraphEventSubscriber* pSubscriber, bool unpublish_current_state)
@@ -63,45 +181,251 @@ void GraphEventPublisher::unsubscribe(GraphEventSubscriber* pSubscriber, bool un
     if(unpublish_current_state)
         unpublishCurrentState(pSubscriber);
 
-    if(insideNotify)
+    if(isNotifying())
     {
+      std::lock_guard<std::mutex> lock(pendingMutex);
       toBeUnsubscribed.push_back(pSubscriber);
+      pendingChanges = true;
     }
     else
     {
+      boost::unique_lock<boost::shared_mutex> lock(routesMutex);
       unsubscribeInternal(pSubscriber);
     }
 }
 
+void GraphEventPublisher::updateSubscriptionFilter(GraphEventSubscriber* pSubscriber)
+{
+    assert(nullptr != pSubscriber);
+    if(isNotifying())
+    {
+      std::lock_guard<std::mutex> lock(pendingMutex);
+      toBeRefiltered.push_back(pSubscriber);
+      pendingChanges = true;
+      return;
+    }
+    boost::unique_lock<boost::shared_mutex> lock(routesMutex);
+    refilter(pSubscriber);
+}
+
+void GraphEventPublisher::refilter(GraphEventSubscriber* pSubscriber)
+{
+    auto it = subscriptions.find(pSubscriber);
+    if(it == subscriptions.end())
+      return;
+    removeRoutes(pSubscriber, it->second);
+    it->second.filter = pSubscriber->getSubscriptionFilter();
+    addRoutes(pSubscriber, it->second);
+}
+
+bool GraphEventPublisher::accepts(const SubscriptionFilter& filter, const GraphEvent& e)
+{
+    if(!filter.acceptsType(e.getType()))
+        return false;
+    const RoutingKeys keys(e);
+    if(!filter.getFrames().empty() && keys.frames[0] != nullptr &&
+       !filter.acceptsFrame(*keys.frames[0]) &&
+       (keys.frames[1] == nullptr || !filter.acceptsFrame(*keys.frames[1])))
+        return false;
+    return keys.item == nullptr || filter.acceptsItemType(keys.item->getTypeIndex());
+}
+
 void GraphEventPublisher::notify(const GraphEvent& e)
 {
-    insideNotify = true;
-    
-    for(GraphEventSubscriber* pSubscriber : subscribers)
+    notifyOrders(e, 0, numeric_limits<std::uint64_t>::max());
+}
+
+void GraphEventPublisher::notifyPrioritized(const GraphEvent& e)
+{
+    notifyOrders(e, 0, unprioritizedOrder);
+}
+
+void GraphEventPublisher::notifyUnprioritized(const GraphEvent& e)
+{
+    notifyOrders(e, unprioritizedOrder, numeric_limits<std::uint64_t>::max());
+}
+
+void GraphEventPublisher::notifyOrders(const GraphEvent& e, std::uint64_t begin, std::uint64_t end)
+{
+    if(!isObserved(e.getType()))
+        return;
+
+    if(isNotifying())
     {
-        pSubscriber->notifyGraphEvent(e);
+        //an event handler notifies, the outermost notify() holds the lock
+        //and updates the subscribers
+        routeEvent(e, begin, end);
+        return;
     }
-    
-    //update subscribers list (it might have been changed by event handlers)
-    //NOTE This is ***not*** meant to handle multithreading issues. It is only
-    //     meant to handle recursions in the same thread. This does ***not*** make
-    //     it thread-safe.
-    for(GraphEventSubscriber* pSubscriber : toBeSubscribed)
+
     {
-        subscribers.push_back(pSubscriber);
+        boost::shared_lock<boost::shared_mutex> lock(routesMutex);
+        NotifyScope scope(this);
+        routeEvent(e, begin, end);
     }
-    toBeSubscribed.clear();
-    
-    for(GraphEventSubscriber* pSubscriber : toBeUnsubscribed)
+
+    //update the subscriptions, they might have been changed by event handlers.
+    //Items may be added from several threads at once, the changes are
+    //applied by whoever gets here first.
+    if(pendingChanges)
+        applyPendingChanges();
+}
+
+void GraphEventPublisher::routeEvent(const GraphEvent& e, std::uint64_t begin, std::uint64_t end)
+{
+    if(e.getType() != GraphEvent::EDGES_MODIFIED ||
+       routes[GraphEvent::EDGE_MODIFIED].byFrame.empty())
+    {
+        route(e, begin, end, true);
+        return;
+    }
+
+    //subscribers that filter frames receive the interesting events one by
+    //one. The batch and the single events are routed separately, thus the
+    //prioritized subscribers are done before the others.
+    auto routeSplit = [&](const std::uint64_t from, const std::uint64_t to)
+    {
+        if(from >= to)
+            return;
+        route(e, from, to, true);
+        for(const EdgeModifiedEvent& event : static_cast<const EdgesModifiedEvent&>(e).events)
+        {
+            route(event, from, to, false);
+        }
+    };
+    const std::uint64_t split = std::min(std::max(begin, std::uint64_t(unprioritizedOrder)), end);
+    routeSplit(begin, split);
+    routeSplit(split, end);
+}
+
+bool GraphEventPublisher::isNotifying() const
+{
+    return std::find(notifyingPublishers.begin(), notifyingPublishers.end(), this) !=
+           notifyingPublishers.end();
+}
+
+void GraphEventPublisher::applyPendingChanges()
+{
+    boost::unique_lock<boost::shared_mutex> routesLock(routesMutex);
+    std::vector<std::pair<GraphEventSubscriber*, bool>> subscribed;
+    std::vector<GraphEventSubscriber*> unsubscribed;
+    std::vector<GraphEventSubscriber*> refiltered;
+    {
+        std::lock_guard<std::mutex> lock(pendingMutex);
+        subscribed.swap(toBeSubscribed);
+        unsubscribed.swap(toBeUnsubscribed);
+        refiltered.swap(toBeRefiltered);
+        pendingChanges = false;
+    }
+
+    for(const auto& subscription : subscribed)
+    {
+        subscribeInternal(subscription.first, subscription.second);
+    }
+    for(GraphEventSubscriber* pSubscriber : unsubscribed)
     {
         unsubscribeInternal(pSubscriber);
-    }    
-    
-    insideNotify = false;
+    }
+    for(GraphEventSubscriber* pSubscriber : refiltered)
+    {
+        refilter(pSubscriber);
+    }
+}
+
+void GraphEventPublisher::route(const GraphEvent& e, std::uint64_t begin, std::uint64_t end,
+                                bool includeAll)
+{
+    const RoutingTable& table = routes[e.getType()];
+    const RoutingKeys keys(e);
+
+    //the candidate lists, each sorted by order
+    const RouteList* lists[4];
+    std::size_t numLists = 0;
+    if(includeAll && !table.all.empty())
+        lists[numLists++] = &table.all;
+    if(!table.byFrame.empty())
+    {
+        for(const FrameSymbol* frame : keys.frames)
+        {
+            if(frame == nullptr)
+                continue;
+            auto it = table.byFrame.find(*frame);
+            if(it != table.byFrame.end())
+                lists[numLists++] = &it->second;
+        }
+    }
+    std::type_index itemType(typeid(void));
+    if(keys.item != nullptr)
+    {
+        itemType = keys.item->getTypeIndex();
+        if(!table.byItemType.empty())
+        {
+            auto it = table.byItemType.find(itemType);
+            if(it != table.byItemType.end())
+                lists[numLists++] = &it->second;
+        }
+    }
+
+    //merge the lists by order. A subscriber that accepts both frames of
+    //an edge is in two lists but is notified once.
+    RouteList::const_iterator heads[4];
+    RouteList::const_iterator ends[4];
+    for(std::size_t i = 0; i < numLists; ++i)
+    {
+        heads[i] = firstRoute(*lists[i], begin);
+        ends[i] = lists[i]->end();
+    }
+    std::uint64_t lastOrder = numeric_limits<std::uint64_t>::max();
+    while(true)
+    {
+        const Route* next = nullptr;
+        std::size_t nextList = 0;
+        for(std::size_t i = 0; i < numLists; ++i)
+        {
+            if(heads[i] != ends[i] && (next == nullptr || heads[i]->order < next->order))
+            {
+                next = &*heads[i];
+                nextList = i;
+            }
+        }
+        if(next == nullptr || next->order >= end)
+            break;
+        ++heads[nextList];
+        if(next->order == lastOrder)
+            continue;
+        lastOrder = next->order;
+        //subscribers indexed by frame may filter item types as well
+        if(keys.item != nullptr && !next->filter->acceptsItemType(itemType))
+            continue;
+        deliver(next->pSubscriber, e);
+    }
 }
 
 void GraphEventPublisher::notifySubscriber(GraphEventSubscriber* pSubscriber, const GraphEvent& e)
 {
+    if(e.getType() == GraphEvent::EDGES_MODIFIED && !pSubscriber->getSubscriptionFilter().getFrames().empty())
+    {
+        for(const EdgeModifiedEvent& event : static_cast<const EdgesModifiedEvent&>(e).events)
+        {
+            notifySubscriber(pSubscriber, event);
+        }
+        return;
+    }
+    if(accepts(pSubscriber->getSubscriptionFilter(), e))
+        deliver(pSubscriber, e);
+}
+
+void GraphEventPublisher::deliver(GraphEventSubscriber* pSubscriber, const GraphEvent& e)
+{
+    if(e.getType() == GraphEvent::EDGES_MODIFIED && !pSubscriber->supportsBatchedEvents())
+    {
+        //fallback for subscribers that only know single edge events
+        for(const EdgeModifiedEvent& event : static_cast<const EdgesModifiedEvent&>(e).events)
+        {
+            pSubscriber->notifyGraphEvent(event);
+        }
+        return;
+    }
     pSubscriber->notifyGraphEvent(e);
 }
 
@@ -115,11 +439,112 @@ GraphEventPublisher::~GraphEventPublisher()
     }
 }
 
+void GraphEventPublisher::subscribeInternal(GraphEventSubscriber* pSubscriber, bool prioritized)
+{
+    if(subscriptions.count(pSubscriber) > 0)
+      unsubscribeInternal(pSubscriber);
+
+    if(prioritized)
+    {
+      subscribers.insert(subscribers.begin() + numPrioritized, pSubscriber);
+      ++numPrioritized;
+    }
+    else
+      subscribers.push_back(pSubscriber);
+
+    Subscription& subscription = subscriptions[pSubscriber];
+    subscription.order = (prioritized ? 0 : unprioritizedOrder) + nextOrder++;
+    subscription.filter = pSubscriber->getSubscriptionFilter();
+    addRoutes(pSubscriber, subscription);
+}
+
 void GraphEventPublisher::unsubscribeInternal(GraphEventSubscriber* pSubscriber)
 {
     auto pos = std::find(subscribers.begin(), subscribers.end(), pSubscriber);
     if(pos != subscribers.end())
     {
+      if(static_cast<std::size_t>(pos - subscribers.begin()) < numPrioritized)
+        --numPrioritized;
       subscribers.erase(pos);
     }  
+
+    auto it = subscriptions.find(pSubscriber);
+    if(it != subscriptions.end())
+    {
+      removeRoutes(pSubscriber, it->second);
+      subscriptions.erase(it);
+    }
+}
+
+void GraphEventPublisher::addRoutes(GraphEventSubscriber* pSubscriber, const Subscription& subscription)
+{
+    const SubscriptionFilter& filter = subscription.filter;
+    const Route route{subscription.order, pSubscriber, &filter};
+    for(std::size_t type = 0; type < numEventTypes; ++type)
+    {
+        const GraphEvent::Type eventType = static_cast<GraphEvent::Type>(type);
+        if(!filter.acceptsType(eventType))
+            continue;
+        RoutingTable& table = routes[type];
+        if(!filter.getFrames().empty())
+        {
+            //batched events are split and routed as EDGE_MODIFIED
+            if(eventType == GraphEvent::EDGES_MODIFIED)
+                continue;
+            for(const FrameSymbol& frame : filter.getFrames())
+                insertRoute(table.byFrame[frame], route);
+        }
+        else if(isItemEvent(eventType) && !filter.getItemTypes().empty())
+        {
+            for(const std::type_index& itemType : filter.getItemTypes())
+                insertRoute(table.byItemType[itemType], route);
+        }
+        else
+        {
+            insertRoute(table.all, route);
+        }
+    }
+    updateObservedTypes();
+}
+
+void GraphEventPublisher::removeRoutes(GraphEventSubscriber* pSubscriber, const Subscription& subscription)
+{
+    const SubscriptionFilter& filter = subscription.filter;
+    for(std::size_t type = 0; type < numEventTypes; ++type)
+    {
+        const GraphEvent::Type eventType = static_cast<GraphEvent::Type>(type);
+        if(!filter.acceptsType(eventType))
+            continue;
+        RoutingTable& table = routes[type];
+        if(!filter.getFrames().empty())
+        {
+            for(const FrameSymbol& frame : filter.getFrames())
+                eraseRoute(table.byFrame, frame, subscription.order);
+        }
+        else if(isItemEvent(eventType) && !filter.getItemTypes().empty())
+        {
+            for(const std::type_index& itemType : filter.getItemTypes())
+                eraseRoute(table.byItemType, itemType, subscription.order);
+        }
+        else
+        {
+            eraseRoute(table.all, subscription.order);
+        }
+    }
+    updateObservedTypes();
+}
+
+void GraphEventPublisher::updateObservedTypes()
+{
+    std::uint32_t mask = 0;
+    for(std::size_t type = 0; type < numEventTypes; ++type)
+    {
+        const RoutingTable& table = routes[type];
+        if(!table.all.empty() || !table.byFrame.empty() || !table.byItemType.empty())
+            mask |= SubscriptionFilter::maskOf(static_cast<GraphEvent::Type>(type));
+    }
+    //batched events are split for subscribers that filter frames
+    if(!routes[GraphEvent::EDGE_MODIFIED].byFrame.empty())
+        mask |= SubscriptionFilter::maskOf(GraphEvent::EDGES_MODIFIED);
+    observedTypes.store(mask, std::memory_order_relaxed);
 }
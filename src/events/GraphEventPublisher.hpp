@@ -32,8 +32,18 @@
  */
 
 #pragma once
+#include <array>
+#include <atomic>
+#include <mutex>
 #include <vector>
+#include <utility>
+#include <cstddef>
+#include <cstdint>
+#include <typeindex>
+#include <unordered_map>
 #include <envire_core/events/GraphEvent.hpp>
+#include <envire_core/events/SubscriptionFilter.hpp>
+#include <boost/thread/shared_mutex.hpp>
 
 namespace envire { namespace core
 {
@@ -44,30 +54,134 @@ namespace envire { namespace core
      * Base class for frame-event publishers.
      * Handles the subscription and notification of subscribers.
      * If the publisher is destroyed. All remaining subscribers will be unsubscribed.
+     *
+     * The SubscriptionFilter of each subscriber is stored in routing tables
+     * indexed by event type, frame and item type. Thus an event is only
+     * delivered to the interested subscribers, no matter how many other
+     * subscribers there are.
+     *
+     * notify() may be called from several threads at once. (Un)subscribing
+     * waits until the running notify() calls have finished. If an event
+     * handler changes the subscriptions of the publisher that notifies it,
+     * the change is applied once the outermost notify() of that thread has
+     * finished.
      */
     class GraphEventPublisher
     {
     private:
       std::vector<GraphEventSubscriber*> subscribers;
+      /**The first numPrioritized entries of subscribers are prioritized */
+      std::size_t numPrioritized;
       
-      /**Is true while notify() is called. Is used to detect if the subscriber
-       * list is modified while inside a notify() call.*/
-      bool insideNotify;
-      /**Temporarly stores subscribers that subscribe while inside notify().
-       * They will be moved to the subcribers list once notify() has finished*/
-      std::vector<GraphEventSubscriber*> toBeSubscribed;
+      /**Guards the subscribers and the routing tables. notify() holds it
+       * shared, thus items may be added from several threads at once and
+       * their events are routed concurrently. Changing the subscriptions
+       * holds it exclusively.*/
+      boost::shared_mutex routesMutex;
+      /**Temporarly stores the subscription changes that event handlers make
+       * while inside notify(). They are applied once the outermost notify()
+       * of the thread has finished. Guarded by pendingMutex.*/
+      std::vector<std::pair<GraphEventSubscriber*, bool>> toBeSubscribed;
       std::vector<GraphEventSubscriber*> toBeUnsubscribed;
+      std::vector<GraphEventSubscriber*> toBeRefiltered;
+      std::mutex pendingMutex;
+      /**True if one of the lists above is not empty */
+      std::atomic<bool> pendingChanges;
+
+      /**A subscriber in a routing table. Tables are sorted by order, which
+       * is the order of notification. */
+      struct Route
+      {
+        std::uint64_t order;
+        GraphEventSubscriber* pSubscriber;
+        const SubscriptionFilter* filter;
+      };
+      using RouteList = std::vector<Route>;
+
+      /**The routes of one event type */
+      struct RoutingTable
+      {
+        /**Subscribers that accept all frames and item types */
+        RouteList all;
+        /**Subscribers that accept some frames */
+        std::unordered_map<FrameSymbol, RouteList> byFrame;
+        /**Subscribers that accept all frames but only some item types */
+        std::unordered_map<std::type_index, RouteList> byItemType;
+      };
+
+      struct Subscription
+      {
+        std::uint64_t order;
+        /**Copy of the subscriber's filter, the routes point to it */
+        SubscriptionFilter filter;
+      };
+
+      static const std::size_t numEventTypes = GraphEvent::EDGES_MODIFIED + 1;
+      /**Added to the order of subscribers that are not prioritized */
+      static const std::uint64_t unprioritizedOrder = std::uint64_t(1) << 63;
+
+      std::array<RoutingTable, numEventTypes> routes;
+      std::unordered_map<GraphEventSubscriber*, Subscription> subscriptions;
+      std::uint64_t nextOrder;
+      /**Mask of the event types that have routes. Atomic because items
+       * may be added (and thus isObserved() called) from several threads.*/
+      std::atomic<std::uint32_t> observedTypes;
+
+      void addRoutes(GraphEventSubscriber* pSubscriber, const Subscription& subscription);
+      void removeRoutes(GraphEventSubscriber* pSubscriber, const Subscription& subscription);
+      void updateObservedTypes();
+      /**Notifies the subscribers with an order in [begin, end) that accept @p e.
+       * @param includeAll if false only the subscribers that filter frames are notified */
+      void route(const GraphEvent& e, std::uint64_t begin, std::uint64_t end, bool includeAll);
+      /**Notifies the subscribers in [begin, end) and updates the subscriptions afterwards */
+      void notifyOrders(const GraphEvent& e, std::uint64_t begin, std::uint64_t end);
+      /**Routes @p e and the single events of batched events */
+      void routeEvent(const GraphEvent& e, std::uint64_t begin, std::uint64_t end);
+      /** @return true if the calling thread is inside notify() of this publisher */
+      bool isNotifying() const;
+      /**Applies the subscription changes that have been deferred by
+       * event handlers */
+      void applyPendingChanges();
+      /**Replaces the routes of @p pSubscriber, routesMutex has to be locked */
+      void refilter(GraphEventSubscriber* pSubscriber);
+      /**Notifies without checking the filter */
+      static void deliver(GraphEventSubscriber* pSubscriber, const GraphEvent& e);
 
     public:
-        /**Subscribes the @param handler to all events by this event source */
-        void subscribe(GraphEventSubscriber* pSubscriber, bool publish_current_state = false);
-        void unsubscribe(GraphEventSubscriber* pSubscriber, bool unpublish_current_state = false);
+        /**Subscribes the @param handler to all events by this event source.
+         * @param prioritized Prioritized subscribers are notified before all
+         *                    other subscribers. This is meant for caches that
+         *                    have to be invalidated before anyone else reacts
+         *                    to the event.*/
+        virtual void subscribe(GraphEventSubscriber* pSubscriber, bool publish_current_state = false,
+                               bool prioritized = false);
+        virtual void unsubscribe(GraphEventSubscriber* pSubscriber, bool unpublish_current_state = false);
+        /**Updates the routing of @p pSubscriber after its SubscriptionFilter
+         * has changed. Called by GraphEventSubscriber::setSubscriptionFilter() */
+        virtual void updateSubscriptionFilter(GraphEventSubscriber* pSubscriber);
+
+        /** @return true if @p filter accepts @p e */
+        static bool accepts(const SubscriptionFilter& filter, const GraphEvent& e);
+
+        /** @return true if at least one subscriber accepts events of @p type.
+         *          Publishers should not create events that nobody observes. */
+        bool isObserved(const GraphEvent::Type type) const
+        {
+            return (observedTypes.load(std::memory_order_relaxed) & SubscriptionFilter::maskOf(type)) != 0;
+        }
 
     protected:
         /**Notify all subscribers about a certain graph event */
         void notify(const GraphEvent& e);
+        
+        /**Notify only the prioritized subscribers about a certain graph event */
+        void notifyPrioritized(const GraphEvent& e);
+        
+        /**Notify all subscribers that are not prioritized about a certain graph event */
+        void notifyUnprioritized(const GraphEvent& e);
 
-        /**Notify the given subscriber about a certain graph event */
+        /**Notify the given subscriber about a certain graph event if its
+         * filter accepts the event */
         void notifySubscriber(GraphEventSubscriber* pSubscriber, const GraphEvent& e);
 
         /**
@@ -81,6 +195,7 @@ namespace envire { namespace core
          */
         virtual void unpublishCurrentState(GraphEventSubscriber* pSubscriber) = 0;
         
+        void subscribeInternal(GraphEventSubscriber* pSubscriber, bool prioritized);
         void unsubscribeInternal(GraphEventSubscriber* pSubscriber);
 
         //there is no use in creating an instance of the publisher
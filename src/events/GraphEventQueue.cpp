@@ -25,64 +25,323 @@
 //
 
 #include <envire_core/events/GraphEventQueue.hpp>
+#include <envire_core/events/EdgeEvents.hpp>
+#include <envire_core/events/FrameEvents.hpp>
+#include <envire_core/events/ItemAddedEvent.hpp>
+#include <envire_core/events/ItemRemovedEvent.hpp>
+
+#include <algorithm>
+#include <new>
+#include <type_traits>
 #include <typeinfo>
-#include <iostream>
 
-envire::core::GraphEventQueue::GraphEventQueue() : GraphEventSubscriber()
+namespace envire { namespace core
+{
+
+namespace
 {
+    const std::uint32_t noSlot = 0xFFFFFFFF;
+    const std::uint32_t chunkSize = 256;
+
+    template <class... EVENTS>
+    struct MaxSize;
+
+    template <class EVENT>
+    struct MaxSize<EVENT>
+    {
+        static const std::size_t value = sizeof(EVENT);
+    };
+
+    template <class EVENT, class... EVENTS>
+    struct MaxSize<EVENT, EVENTS...>
+    {
+        static const std::size_t value = sizeof(EVENT) > MaxSize<EVENTS...>::value ?
+                                         sizeof(EVENT) : MaxSize<EVENTS...>::value;
+    };
+
+    using EventStorage = std::aligned_storage<MaxSize<EdgeAddedEvent, EdgeModifiedEvent, EdgesModifiedEvent,
+                                                      EdgeRemovedEvent, FrameAddedEvent, FrameRemovedEvent,
+                                                      ItemAddedEvent, ItemRemovedEvent>::value>::type;
+
+    /**Copies @p event into @p memory if it is one of the known event types.
+     * Subclasses of them are not copied, they would be sliced.
+     * @return the copy or nullptr */
+    template <class EVENT>
+    GraphEvent* copyInto(const GraphEvent& event, void* memory)
+    {
+        if(typeid(event) != typeid(EVENT))
+            return nullptr;
+        return new(memory) EVENT(static_cast<const EVENT&>(event));
+    }
+
+    GraphEvent* copyInto(const GraphEvent& event, void* memory)
+    {
+        switch(event.getType())
+        {
+            case GraphEvent::EDGE_ADDED: return copyInto<EdgeAddedEvent>(event, memory);
+            case GraphEvent::EDGE_REMOVED: return copyInto<EdgeRemovedEvent>(event, memory);
+            case GraphEvent::EDGE_MODIFIED: return copyInto<EdgeModifiedEvent>(event, memory);
+            case GraphEvent::EDGES_MODIFIED: return copyInto<EdgesModifiedEvent>(event, memory);
+            case GraphEvent::ITEM_ADDED_TO_FRAME: return copyInto<ItemAddedEvent>(event, memory);
+            case GraphEvent::ITEM_REMOVED_FROM_FRAME: return copyInto<ItemRemovedEvent>(event, memory);
+            case GraphEvent::FRAME_ADDED: return copyInto<FrameAddedEvent>(event, memory);
+            case GraphEvent::FRAME_REMOVED: return copyInto<FrameRemovedEvent>(event, memory);
+        }
+        return nullptr;
+    }
+
+    const void* symbolAddress(const FrameSymbol& symbol)
+    {
+        return &symbol.str();
+    }
 }
 
-envire::core::GraphEventQueue::GraphEventQueue(envire::core::GraphEventPublisher* pPublisher) :
-                                GraphEventSubscriber(pPublisher)
+struct GraphEventQueue::Slot
+{
+    EventStorage storage;
+    /**Points into storage or to a clone on the heap */
+    GraphEvent* event = nullptr;
+    bool pooled = false;
+    bool keyed = false;
+    Key key;
+    SlotIndex prev = noSlot;
+    SlotIndex next = noSlot;
+    SlotIndex keyPrev = noSlot;
+    SlotIndex keyNext = noSlot;
+};
+
+GraphEventQueue::GraphEventQueue() : GraphEventSubscriber(), head(noSlot), tail(noSlot)
 {
 }
 
-envire::core::GraphEventQueue::~GraphEventQueue()
+GraphEventQueue::GraphEventQueue(GraphEventPublisher* pPublisher) :
+                                GraphEventSubscriber(pPublisher), head(noSlot), tail(noSlot)
 {
 }
 
-void envire::core::GraphEventQueue::notifyGraphEvent(const envire::core::GraphEvent& event)
+GraphEventQueue::~GraphEventQueue()
 {
-    std::list<GraphEvent*>::iterator it = event_queue.begin();
+    while(head != noSlot)
+    {
+        const SlotIndex first = head;
+        unlink(first);
+        release(first);
+    }
+}
+
+void GraphEventQueue::notifyGraphEvent(const GraphEvent& event)
+{
+    Key key;
+    const bool keyed = makeKey(event, key);
     bool skip_event = false;
-    while(it != event_queue.end())
+    if(keyed)
     {
-        // check if the new event supersedes one of the existing events
-        if((*it)->mergeable(event))
+        auto entry = slotsByKey.find(key);
+        SlotIndex queued = entry == slotsByKey.end() ? noSlot : entry->second;
+        while(queued != noSlot)
         {
-            // in this case the remove event deosn't need to be published
-            if(((*it)->getType() == GraphEvent::EDGE_ADDED && event.getType() == GraphEvent::EDGE_REMOVED) ||
-                ((*it)->getType() == GraphEvent::FRAME_ADDED && event.getType() == GraphEvent::FRAME_REMOVED) ||
-                ((*it)->getType() == GraphEvent::ITEM_ADDED_TO_FRAME && event.getType() == GraphEvent::ITEM_REMOVED_FROM_FRAME)
-            )
+            const SlotIndex next = slot(queued).keyNext;
+            const GraphEvent& queuedEvent = *slot(queued).event;
+            if(supersedes(event, queuedEvent))
             {
-                skip_event = true;
+                // in this case the remove event doesn't need to be published
+                if(cancels(event, queuedEvent))
+                {
+                    skip_event = true;
+                }
+                unlink(queued);
+                release(queued);
+                ++merges;
             }
+            queued = next;
+        }
+    }
 
-            it = event_queue.erase(it);
+    if(skip_event)
+    {
+        ++merges;
+        return;
+    }
+
+    const SlotIndex added = allocate(event);
+    Slot& s = slot(added);
+    s.prev = tail;
+    if(tail != noSlot)
+        slot(tail).next = added;
+    else
+        head = added;
+    tail = added;
+    if(keyed)
+    {
+        s.keyed = true;
+        s.key = key;
+        SlotIndex& first = slotsByKey.emplace(key, noSlot).first->second;
+        s.keyNext = first;
+        if(first != noSlot)
+            slot(first).keyPrev = added;
+        first = added;
+    }
+    ++numQueued;
+    maxQueued = std::max(maxQueued, numQueued);
+}
+
+void GraphEventQueue::flush()
+{
+    //process() may cause new events, they are processed as well
+    while(head != noSlot)
+    {
+        const SlotIndex first = head;
+        unlink(first);
+        try
+        {
+            process(*slot(first).event);
         }
-        else
+        catch(...)
+        {
+            release(first);
+            throw;
+        }
+        release(first);
+    }
+    slotsByKey.clear();
+}
+
+void GraphEventQueue::resetStatistics()
+{
+    maxQueued = numQueued;
+    merges = 0;
+}
+
+bool GraphEventQueue::makeKey(const GraphEvent& event, Key& key)
+{
+    switch(event.getType())
+    {
+        case GraphEvent::EDGE_ADDED:
+        case GraphEvent::EDGE_REMOVED:
+        case GraphEvent::EDGE_MODIFIED:
         {
-            it++;
+            //edges have no direction, (a, b) and (b, a) are the same key
+            const EdgeEvent& edge = static_cast<const EdgeEvent&>(event);
+            const void* origin = symbolAddress(edge.origin);
+            const void* target = symbolAddress(edge.target);
+            key.kind = Key::EDGE;
+            key.a = std::min(origin, target, std::less<const void*>());
+            key.b = std::max(origin, target, std::less<const void*>());
+            return true;
         }
+        case GraphEvent::FRAME_ADDED:
+        case GraphEvent::FRAME_REMOVED:
+            key.kind = Key::FRAME;
+            key.a = symbolAddress(static_cast<const FrameEvent&>(event).frame);
+            key.b = nullptr;
+            return true;
+        case GraphEvent::ITEM_ADDED_TO_FRAME:
+        {
+            const ItemAddedEvent& added = static_cast<const ItemAddedEvent&>(event);
+            key.kind = Key::ITEM;
+            key.a = symbolAddress(added.frame);
+            key.b = added.item.get();
+            return true;
+        }
+        case GraphEvent::ITEM_REMOVED_FROM_FRAME:
+        {
+            const ItemRemovedEvent& removed = static_cast<const ItemRemovedEvent&>(event);
+            key.kind = Key::ITEM;
+            key.a = symbolAddress(removed.frame);
+            key.b = removed.item.get();
+            return true;
+        }
+        default:
+            return false;
     }
+}
 
-    if(!skip_event)
+bool GraphEventQueue::supersedes(const GraphEvent& event, const GraphEvent& queued)
+{
+    //events with the same key refer to the same edge, frame or item
+    switch(event.getType())
     {
-        event_queue.push_back(event.clone());
+        case GraphEvent::EDGE_MODIFIED:
+            return queued.getType() == GraphEvent::EDGE_MODIFIED;
+        case GraphEvent::EDGE_REMOVED:
+            return true;
+        case GraphEvent::FRAME_REMOVED:
+            return queued.getType() == GraphEvent::FRAME_ADDED;
+        case GraphEvent::ITEM_REMOVED_FROM_FRAME:
+            return queued.getType() == GraphEvent::ITEM_ADDED_TO_FRAME;
+        default:
+            return false;
     }
 }
 
-void envire::core::GraphEventQueue::flush()
+bool GraphEventQueue::cancels(const GraphEvent& event, const GraphEvent& queued)
 {
-    std::list<GraphEvent*>::iterator it = event_queue.begin();
-    while(it != event_queue.end())
+    return (queued.getType() == GraphEvent::EDGE_ADDED && event.getType() == GraphEvent::EDGE_REMOVED) ||
+           (queued.getType() == GraphEvent::FRAME_ADDED && event.getType() == GraphEvent::FRAME_REMOVED) ||
+           (queued.getType() == GraphEvent::ITEM_ADDED_TO_FRAME && event.getType() == GraphEvent::ITEM_REMOVED_FROM_FRAME);
+}
+
+GraphEventQueue::Slot& GraphEventQueue::slot(const SlotIndex index)
+{
+    return chunks[index / chunkSize][index % chunkSize];
+}
+
+GraphEventQueue::SlotIndex GraphEventQueue::allocate(const GraphEvent& event)
+{
+    if(freeSlots.empty())
     {
-        envire::core::GraphEvent* event = *it;
-        process(*event);
+        const SlotIndex first = static_cast<SlotIndex>(chunks.size() * chunkSize);
+        chunks.emplace_back(new Slot[chunkSize]);
+        freeSlots.reserve(chunks.size() * chunkSize);
+        for(SlotIndex i = chunkSize; i > 0; --i)
+            freeSlots.push_back(first + i - 1);
+    }
+    const SlotIndex index = freeSlots.back();
+    Slot& s = slot(index);
+    s.event = copyInto(event, &s.storage);
+    s.pooled = s.event != nullptr;
+    if(!s.pooled)
+        s.event = event.clone();
+    freeSlots.pop_back();
+    return index;
+}
 
-        // delete event
-        it = event_queue.erase(it);
-        delete event;
+void GraphEventQueue::release(const SlotIndex index)
+{
+    Slot& s = slot(index);
+    if(s.pooled)
+        s.event->~GraphEvent();
+    else
+        delete s.event;
+    s.event = nullptr;
+    freeSlots.push_back(index);
+}
+
+void GraphEventQueue::unlink(const SlotIndex index)
+{
+    Slot& s = slot(index);
+    if(s.prev != noSlot)
+        slot(s.prev).next = s.next;
+    else
+        head = s.next;
+    if(s.next != noSlot)
+        slot(s.next).prev = s.prev;
+    else
+        tail = s.prev;
+    s.prev = s.next = noSlot;
+
+    if(s.keyed)
+    {
+        if(s.keyPrev != noSlot)
+            slot(s.keyPrev).keyNext = s.keyNext;
+        else
+            slotsByKey[s.key] = s.keyNext;
+        if(s.keyNext != noSlot)
+            slot(s.keyNext).keyPrev = s.keyPrev;
+        s.keyPrev = s.keyNext = noSlot;
+        s.keyed = false;
     }
-}
\ No newline at end of file
+    --numQueued;
+}
+
+}}
@@ -28,11 +28,30 @@
 
 #include <envire_core/events/GraphEventSubscriber.hpp>
 #include <envire_core/events/GraphEvent.hpp>
-#include <list>
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <unordered_map>
+#include <vector>
 
 namespace envire { namespace core
 {
 
+/**Queues events until flush() is called.
+ *
+ * Events that supersede queued events are merged with them, e.g. removing
+ * an edge drops all queued events of the edge and removing a frame that has
+ * been added in the meantime drops both events. The queued events are
+ * indexed by edge, frame and item, thus merging does not depend on the
+ * number of queued events.
+ *
+ * The events are copied into pooled slots that are reused after flush().
+ * Thus a queue that is flushed regularly does not allocate memory for the
+ * known event types.
+ *
+ * @note The merge rules are the ones of GraphEvent::mergeable() of the
+ *       known event types, mergeable() itself is not called. */
 class GraphEventQueue : public GraphEventSubscriber
 {
 public:
@@ -49,8 +68,72 @@ public:
     /** This callback is called with each queued event when flush() is called */
     virtual void process( const GraphEvent& event ) = 0;
 
+    /** @return the number of queued events */
+    std::size_t size() const { return numQueued; }
+    /** @return the largest number of queued events since the last resetStatistics() */
+    std::size_t getMaxSize() const { return maxQueued; }
+    /** @return the number of events that have been dropped because they
+     *          were superseded or cancelled out by another event */
+    std::size_t getMergeCount() const { return merges; }
+    void resetStatistics();
+
 private:
-    std::list<GraphEvent*> event_queue;
+    struct Slot;
+    using SlotIndex = std::uint32_t;
+
+    /**Identifies the edge, frame or item an event refers to */
+    struct Key
+    {
+        enum Kind : std::uint8_t { EDGE, FRAME, ITEM };
+        Kind kind;
+        const void* a;
+        const void* b;
+
+        bool operator==(const Key& other) const
+        {
+            return kind == other.kind && a == other.a && b == other.b;
+        }
+    };
+
+    struct KeyHash
+    {
+        std::size_t operator()(const Key& key) const
+        {
+            const std::size_t a = std::hash<const void*>()(key.a);
+            const std::size_t b = std::hash<const void*>()(key.b);
+            return (a ^ (b + 0x9e3779b97f4a7c15ULL + (a << 6) + (a >> 2))) + key.kind;
+        }
+    };
+
+    /** @return true if @p event has a key, i.e. if it might be merged */
+    static bool makeKey(const GraphEvent& event, Key& key);
+    /** @return true if @p queued is superseded by @p event */
+    static bool supersedes(const GraphEvent& event, const GraphEvent& queued);
+    /** @return true if @p event cancels @p queued out, i.e. @p event
+     *          does not need to be queued either */
+    static bool cancels(const GraphEvent& event, const GraphEvent& queued);
+
+    Slot& slot(const SlotIndex index);
+    /** @return a free slot that holds a copy of @p event */
+    SlotIndex allocate(const GraphEvent& event);
+    /**Destroys the event and returns the slot to the free list */
+    void release(const SlotIndex index);
+    /**Removes the slot from the queue and the index */
+    void unlink(const SlotIndex index);
+
+    /**The slots are allocated in chunks that never move */
+    std::vector<std::unique_ptr<Slot[]>> chunks;
+    std::vector<SlotIndex> freeSlots;
+    /**Queue order, a doubly linked list through the slots */
+    SlotIndex head;
+    SlotIndex tail;
+    /**First slot of each key. The slots of a key are linked as well.
+     * Keys without slots are kept until the queue is empty. */
+    std::unordered_map<Key, SlotIndex, KeyHash> slotsByKey;
+
+    std::size_t numQueued = 0;
+    std::size_t maxQueued = 0;
+    std::size_t merges = 0;
 };
 
-}}
\ No newline at end of file
+}}
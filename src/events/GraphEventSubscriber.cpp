@@ -40,7 +40,8 @@ GraphEventSubscriber::GraphEventSubscriber() : pPublisher(nullptr)
 {
 }
 
-void GraphEventSubscriber::subscribe(GraphEventPublisher* pPublisher, bool publish_current_state)
+void GraphEventSubscriber::subscribe(GraphEventPublisher* pPublisher, bool publish_current_state,
+                                     bool prioritized)
 {
     assert(pPublisher != nullptr);
     // unsubscribe if already subscribed
@@ -48,7 +49,7 @@ void GraphEventSubscriber::subscribe(GraphEventPublisher* pPublisher, bool publi
         this->pPublisher->unsubscribe(this, publish_current_state);
     // subscribe to new publisher
     this->pPublisher = pPublisher;
-    this->pPublisher->subscribe(this, publish_current_state);
+    this->pPublisher->subscribe(this, publish_current_state, prioritized);
 }
 
 void GraphEventSubscriber::unsubscribe()
@@ -60,6 +61,13 @@ void GraphEventSubscriber::unsubscribe()
     }  
 }
 
+void GraphEventSubscriber::setSubscriptionFilter(const SubscriptionFilter& filter)
+{
+    this->filter = filter;
+    if(nullptr != pPublisher)
+      pPublisher->updateSubscriptionFilter(this);
+}
+
 GraphEventSubscriber::~GraphEventSubscriber()
 {
     unsubscribe();
@@ -25,6 +25,8 @@
 //
 
 #pragma once
+#include <envire_core/events/SubscriptionFilter.hpp>
+
 namespace envire { namespace core
 {
     class GraphEvent;
@@ -44,14 +46,25 @@ namespace envire { namespace core
         GraphEventSubscriber(GraphEventPublisher* pPublisher);
         /**Creates a subscriber that is not subscribed to any publisher. */
         GraphEventSubscriber();
-        /**Subscribe to the specified publisher. Only works if not subscribed already.*/
-        void subscribe(GraphEventPublisher* pPublisher, bool publish_current_state = false);
+        /**Subscribe to the specified publisher. Only works if not subscribed already.
+         * @see GraphEventPublisher::subscribe() */
+        void subscribe(GraphEventPublisher* pPublisher, bool publish_current_state = false,
+                       bool prioritized = false);
         /**unsubscribe from the current publisher. Does nothing if not subscribed. */
         virtual void unsubscribe();
         /**This method is called by the publisher whenever a new event occurs */
         virtual void notifyGraphEvent(const GraphEvent& event) = 0;
+        /** @return true if notifyGraphEvent() handles batched events like the
+         *          EdgesModifiedEvent. Otherwise the publisher splits them
+         *          into single events. */
+        virtual bool supportsBatchedEvents() const { return false; }
+        /**Restricts the events that the publisher delivers to this subscriber.
+         * Updates the routing of the publisher if subscribed. */
+        void setSubscriptionFilter(const SubscriptionFilter& filter);
+        const SubscriptionFilter& getSubscriptionFilter() const { return filter; }
         virtual ~GraphEventSubscriber();
     private:
       GraphEventPublisher* pPublisher;
+      SubscriptionFilter filter;
     };
 }}
@@ -50,32 +50,40 @@ namespace envire { namespace core
         {
             static_assert(std::is_base_of<ItemBase, T>::value,
                           "T should derive from ItemBase"); 
+            setSubscriptionFilter(itemFilter());
         }
         
         /**Create a dispatcher that is not subscribed to anything, yet*/
-        GraphItemEventDispatcher() : GraphEventSubscriber(), itemType(typeid(T)) {}
+        GraphItemEventDispatcher() : GraphEventSubscriber(), itemType(typeid(T))
+        {
+            setSubscriptionFilter(itemFilter());
+        }
 
         virtual ~GraphItemEventDispatcher() {}
         
+        /**Batched events only contain edge events, which are ignored anyway */
+        virtual bool supportsBatchedEvents() const override { return true; }
+        
         void notifyGraphEvent(const GraphEvent& event)
         {
             switch(event.getType())
             {
                 case GraphEvent::ITEM_ADDED_TO_FRAME:
                 {
-                    const ItemAddedEvent& itemEvent = dynamic_cast<const ItemAddedEvent&>(event);
+                    const ItemAddedEvent& itemEvent = static_cast<const ItemAddedEvent&>(event);
                     if(itemEvent.item->getTypeIndex() == itemType)
                     {
-                        itemAdded(TypedItemAddedEvent<T>(itemEvent.frame, boost::dynamic_pointer_cast<T>(itemEvent.item)));
+                        //the item is a T, its type index has been checked
+                        itemAdded(TypedItemAddedEvent<T>(itemEvent.frame, boost::static_pointer_cast<T>(itemEvent.item)));
                     }
                 }
                     break;
                 case GraphEvent::ITEM_REMOVED_FROM_FRAME:  
                 {
-                    const ItemRemovedEvent itemEvent =  dynamic_cast<const ItemRemovedEvent&>(event);
+                    const ItemRemovedEvent& itemEvent = static_cast<const ItemRemovedEvent&>(event);
                     if(itemEvent.item->getTypeIndex() == itemType)
                     {
-                        itemRemoved(TypedItemRemovedEvent<T>(itemEvent.frame, boost::dynamic_pointer_cast<T>(itemEvent.item)));
+                        itemRemoved(TypedItemRemovedEvent<T>(itemEvent.frame, boost::static_pointer_cast<T>(itemEvent.item)));
                     }
                 }
                     break;
@@ -90,6 +98,15 @@ namespace envire { namespace core
         virtual void itemRemoved(const TypedItemRemovedEvent<T>& event) {}
         
     private:
+        /**Only the events of items of type T are routed to this dispatcher */
+        static SubscriptionFilter itemFilter()
+        {
+            SubscriptionFilter filter;
+            filter.setEvents({GraphEvent::ITEM_ADDED_TO_FRAME, GraphEvent::ITEM_REMOVED_FROM_FRAME});
+            filter.addItemType<T>();
+            return filter;
+        }
+
         std::type_index itemType;
     };
 }}
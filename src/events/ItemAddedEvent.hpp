@@ -28,21 +28,33 @@
 #include <typeindex>
 #include <envire_core/items/ItemBase.hpp>
 #include <envire_core/events/GraphEvent.hpp>
+#include <envire_core/events/ItemRemovedEvent.hpp>
 
 namespace envire { namespace core
 {
     class ItemAddedEvent : public GraphEvent
     {
     public:
-      ItemAddedEvent(const FrameId& frame, const ItemBase::Ptr item) :
+      ItemAddedEvent(const FrameSymbol& frame, const ItemBase::Ptr& item) :
         GraphEvent(GraphEvent::ITEM_ADDED_TO_FRAME), frame(frame), item(item){}
 
+        virtual bool mergeable(const GraphEvent& event)
+        {
+            //removing the item again cancels this event out
+            if(event.getType() == ITEM_REMOVED_FROM_FRAME)
+            {
+                const ItemRemovedEvent& removed = static_cast<const ItemRemovedEvent&>(event);
+                return frame == removed.frame && item == removed.item;
+            }
+            return false;
+        }
+
         GraphEvent* clone() const
         {
             return new ItemAddedEvent(frame, item);
         }
 
-      FrameId frame;/**<frame that the item has been added to.*/
+      FrameSymbol frame;/**<frame that the item has been added to.*/
       ItemBase::Ptr item; /**<The item */
     };
     
@@ -50,14 +62,14 @@ namespace envire { namespace core
     template <class T>
     struct TypedItemAddedEvent 
     {
-      TypedItemAddedEvent(const FrameId& frame, const ItemBase::PtrType<T> item) : frame(frame), item(item) {}
+      TypedItemAddedEvent(const FrameSymbol& frame, const ItemBase::PtrType<T>& item) : frame(frame), item(item) {}
 
         GraphEvent* clone() const
         {
             return new ItemAddedEvent(frame, item);
         }
 
-      FrameId frame;
+      FrameSymbol frame;
       ItemBase::PtrType<T> item;
     };
 }}
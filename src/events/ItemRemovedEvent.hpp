@@ -33,7 +33,7 @@ namespace envire { namespace core
     class ItemRemovedEvent : public GraphEvent
     {
     public:
-      ItemRemovedEvent(const FrameId& frame, const ItemBase::Ptr item) :
+      ItemRemovedEvent(const FrameSymbol& frame, const ItemBase::Ptr& item) :
           GraphEvent(GraphEvent::ITEM_REMOVED_FROM_FRAME), frame(frame), item(item){}
 
         GraphEvent* clone() const
@@ -41,7 +41,7 @@ namespace envire { namespace core
             return new ItemRemovedEvent(frame, item);
         }
 
-      FrameId frame;/**<frame that the no longer contains the item.*/
+      FrameSymbol frame;/**<frame that the no longer contains the item.*/
       /**The item that has been removed.
        * @note Since the item has already been removed, item->getFrame() will
        *       not return a valid value.*/
@@ -52,14 +52,14 @@ namespace envire { namespace core
     template <class T>
     struct TypedItemRemovedEvent 
     {
-      TypedItemRemovedEvent(const FrameId& frame, const ItemBase::PtrType<T> item) : frame(frame), item(item) {}
+      TypedItemRemovedEvent(const FrameSymbol& frame, const ItemBase::PtrType<T>& item) : frame(frame), item(item) {}
 
         GraphEvent* clone() const
         {
             return new TypedItemRemovedEvent(frame, item);
         }
 
-      FrameId frame;
+      FrameSymbol frame;
       ItemBase::PtrType<T> item;
     };
 }}
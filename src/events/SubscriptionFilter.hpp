@@ -0,0 +1,117 @@
+//
+// Copyright (c) 2015, Deutsches Forschungszentrum für Künstliche Intelligenz GmbH.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+
+#pragma once
+
+#include <envire_core/events/GraphEvent.hpp>
+#include <envire_core/items/FrameSymbol.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <initializer_list>
+#include <typeindex>
+#include <vector>
+
+namespace envire { namespace core
+{
+
+/**Describes which events a GraphEventSubscriber is interested in.
+ *
+ * The publisher keeps routing tables of the filters and only notifies the
+ * subscribers that are interested in an event. An event is delivered if
+ * - its type is in the event mask and
+ * - the frame set is empty or contains the frame of a frame or item event
+ *   or one of the frames of an edge event and
+ * - it is no item event, or the item type set is empty or contains the
+ *   type of the item.
+ *
+ * Subscribers that restrict the frames receive EdgesModifiedEvents split
+ * into single EdgeModifiedEvents.
+ *
+ * The default filter accepts all events.
+ * @see GraphEventSubscriber::setSubscriptionFilter() */
+class SubscriptionFilter
+{
+public:
+    static const std::uint32_t allEvents = (1u << (GraphEvent::EDGES_MODIFIED + 1)) - 1;
+
+    SubscriptionFilter() : eventMask(allEvents) {}
+
+    static std::uint32_t maskOf(const GraphEvent::Type type) { return 1u << type; }
+
+    /**Only accept events of @p types. EDGE_MODIFIED implies EDGES_MODIFIED */
+    SubscriptionFilter& setEvents(std::initializer_list<GraphEvent::Type> types)
+    {
+        eventMask = 0;
+        for(const GraphEvent::Type type : types)
+            eventMask |= maskOf(type);
+        if(eventMask & maskOf(GraphEvent::EDGE_MODIFIED))
+            eventMask |= maskOf(GraphEvent::EDGES_MODIFIED);
+        return *this;
+    }
+
+    SubscriptionFilter& addFrame(const FrameSymbol& frame)
+    {
+        if(std::find(frames.begin(), frames.end(), frame) == frames.end())
+            frames.push_back(frame);
+        return *this;
+    }
+
+    template <class T>
+    SubscriptionFilter& addItemType()
+    {
+        return addItemType(std::type_index(typeid(T)));
+    }
+
+    SubscriptionFilter& addItemType(const std::type_index& type)
+    {
+        if(std::find(itemTypes.begin(), itemTypes.end(), type) == itemTypes.end())
+            itemTypes.push_back(type);
+        return *this;
+    }
+
+    bool acceptsType(const GraphEvent::Type type) const { return (eventMask & maskOf(type)) != 0; }
+    bool acceptsFrame(const FrameSymbol& frame) const
+    {
+        return frames.empty() || std::find(frames.begin(), frames.end(), frame) != frames.end();
+    }
+    bool acceptsItemType(const std::type_index& type) const
+    {
+        return itemTypes.empty() || std::find(itemTypes.begin(), itemTypes.end(), type) != itemTypes.end();
+    }
+
+    std::uint32_t getEventMask() const { return eventMask; }
+    const std::vector<FrameSymbol>& getFrames() const { return frames; }
+    const std::vector<std::type_index>& getItemTypes() const { return itemTypes; }
+
+private:
+    std::uint32_t eventMask;
+    std::vector<FrameSymbol> frames;
+    std::vector<std::type_index> itemTypes;
+};
+
+}}
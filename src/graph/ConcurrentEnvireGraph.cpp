@@ -0,0 +1,288 @@
+//
+// Copyright (c) 2015, Deutsches Forschungszentrum für Künstliche Intelligenz GmbH.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+
+#include <envire_core/graph/ConcurrentEnvireGraph.hpp>
+#include <glog/logging.h>
+#include <exception>
+
+namespace envire { namespace core
+{
+
+void ConcurrentEnvireGraph::EventCollector::notifyGraphEvent(const GraphEvent& event)
+{
+    std::unique_ptr<GraphEvent> copy(event.clone());
+    if(mutex != nullptr)
+    {
+        std::lock_guard<std::mutex> lock(*mutex);
+        events.push_back(std::move(copy));
+    }
+    else
+    {
+        events.push_back(std::move(copy));
+    }
+}
+
+ConcurrentEnvireGraph::CacheGuard::~CacheGuard()
+{
+    if(graph.isLazyInverseEdgesEnabled())
+    {
+        LOG(ERROR) << "ConcurrentEnvireGraph does not support lazy inverse edges, disabling them";
+        graph.disableLazyInverseEdges();
+    }
+    if(graph.isTransformCacheEnabled())
+    {
+        LOG(ERROR) << "ConcurrentEnvireGraph does not support the transform cache, disabling it";
+        graph.disableTransformCache();
+    }
+}
+
+ConcurrentEnvireGraph::ConcurrentEnvireGraph() : collector(pending, &pendingMutex)
+{
+    collector.subscribe(&graph);
+}
+
+ConcurrentEnvireGraph::~ConcurrentEnvireGraph()
+{
+}
+
+bool ConcurrentEnvireGraph::containsFrame(const FrameId& frame) const
+{
+    return read([&](const EnvireGraph& g) { return g.containsFrame(frame); });
+}
+
+bool ConcurrentEnvireGraph::containsEdge(const FrameId& origin, const FrameId& target) const
+{
+    return read([&](const EnvireGraph& g) { return g.containsEdge(origin, target); });
+}
+
+Transform ConcurrentEnvireGraph::getTransform(const FrameId& origin, const FrameId& target) const
+{
+    return read([&](const EnvireGraph& g) { return g.getTransform(origin, target); });
+}
+
+Frame::ItemList ConcurrentEnvireGraph::getItems(const FrameId& frame, const std::type_index& type) const
+{
+    return read([&](const EnvireGraph& g) -> Frame::ItemList
+    {
+        std::unique_lock<std::recursive_mutex> lock(g.lockItems(frame));
+        return g.getItems(frame, type);
+    });
+}
+
+std::size_t ConcurrentEnvireGraph::getTotalItemCount(const FrameId& frame) const
+{
+    return read([&](const EnvireGraph& g) { return g.getTotalItemCount(frame); });
+}
+
+std::size_t ConcurrentEnvireGraph::num_vertices() const
+{
+    return read([](const EnvireGraph& g) { return g.num_vertices(); });
+}
+
+std::size_t ConcurrentEnvireGraph::num_edges() const
+{
+    return read([](const EnvireGraph& g) { return g.num_edges(); });
+}
+
+void ConcurrentEnvireGraph::addFrame(const FrameId& frame)
+{
+    write([&](EnvireGraph& g) { g.addFrame(frame); });
+}
+
+void ConcurrentEnvireGraph::removeFrame(const FrameId& frame)
+{
+    write([&](EnvireGraph& g) { g.removeFrame(frame); });
+}
+
+void ConcurrentEnvireGraph::disconnectFrame(const FrameId& frame)
+{
+    write([&](EnvireGraph& g) { g.disconnectFrame(frame); });
+}
+
+void ConcurrentEnvireGraph::addTransform(const FrameId& origin, const FrameId& target, const Transform& tf)
+{
+    write([&](EnvireGraph& g) { g.addTransform(origin, target, tf); });
+}
+
+void ConcurrentEnvireGraph::updateTransform(const FrameId& origin, const FrameId& target, const Transform& tf)
+{
+    write([&](EnvireGraph& g) { g.updateTransform(origin, target, tf); });
+}
+
+void ConcurrentEnvireGraph::removeTransform(const FrameId& origin, const FrameId& target)
+{
+    write([&](EnvireGraph& g) { g.removeTransform(origin, target); });
+}
+
+void ConcurrentEnvireGraph::addItemToFrame(const FrameId& frame, ItemBase::Ptr item)
+{
+    modifyItems([&](EnvireGraph& g) { g.addItemToFrame(frame, item); });
+}
+
+void ConcurrentEnvireGraph::removeItemFromFrame(const ItemBase::Ptr item)
+{
+    modifyItems([&](EnvireGraph& g) { g.removeItemFromFrame(item); });
+}
+
+void ConcurrentEnvireGraph::clearFrame(const FrameId& frame)
+{
+    modifyItems([&](EnvireGraph& g) { g.clearFrame(frame); });
+}
+
+std::shared_ptr<const SeqLockTransform> ConcurrentEnvireGraph::enableSeqLock(const FrameId& origin,
+                                                                            const FrameId& target)
+{
+    return write([&](EnvireGraph& g) { return g.enableSeqLock(origin, target); });
+}
+
+bool ConcurrentEnvireGraph::disableSeqLock(const FrameId& origin, const FrameId& target)
+{
+    return write([&](EnvireGraph& g) { return g.disableSeqLock(origin, target); });
+}
+
+void ConcurrentEnvireGraph::subscribe(GraphEventSubscriber* pSubscriber, bool publish_current_state,
+                                      bool prioritized)
+{
+    std::lock_guard<std::recursive_mutex> lock(deliveryMutex);
+    GraphEventPublisher::subscribe(pSubscriber, publish_current_state, prioritized);
+}
+
+void ConcurrentEnvireGraph::unsubscribe(GraphEventSubscriber* pSubscriber, bool unpublish_current_state)
+{
+    std::lock_guard<std::recursive_mutex> lock(deliveryMutex);
+    GraphEventPublisher::unsubscribe(pSubscriber, unpublish_current_state);
+}
+
+void ConcurrentEnvireGraph::updateSubscriptionFilter(GraphEventSubscriber* pSubscriber)
+{
+    std::lock_guard<std::recursive_mutex> lock(deliveryMutex);
+    GraphEventPublisher::updateSubscriptionFilter(pSubscriber);
+}
+
+void ConcurrentEnvireGraph::publishCurrentState(GraphEventSubscriber* pSubscriber)
+{
+    EventList events;
+    collectState(events, true);
+    for(const std::unique_ptr<GraphEvent>& event : events)
+    {
+        notifySubscriber(pSubscriber, *event);
+    }
+}
+
+void ConcurrentEnvireGraph::unpublishCurrentState(GraphEventSubscriber* pSubscriber)
+{
+    EventList events;
+    collectState(events, false);
+    for(const std::unique_ptr<GraphEvent>& event : events)
+    {
+        notifySubscriber(pSubscriber, *event);
+    }
+}
+
+void ConcurrentEnvireGraph::collectState(EventList& events, const bool publish)
+{
+    //called while holding the deliveryMutex. Thus no one else delivers
+    //events, but the pending events might have to be delivered to the
+    //existing subscribers first.
+    const bool nested = deliveringThread == std::this_thread::get_id();
+    while(true)
+    {
+        if(!nested)
+            deliverEvents();
+        boost::unique_lock<boost::shared_mutex> lock(graphMutex);
+        {
+            std::lock_guard<std::mutex> pendingLock(pendingMutex);
+            if(!nested && !pending.empty())
+                continue; //someone modified the graph in the meantime
+        }
+        EventCollector state(events, nullptr);
+        if(publish)
+        {
+            state.subscribe(&graph, true);
+            state.unsubscribe();
+        }
+        else
+        {
+            state.subscribe(&graph);
+            graph.unsubscribe(&state, true);
+        }
+        return;
+    }
+}
+
+void ConcurrentEnvireGraph::deliverEvents()
+{
+    std::lock_guard<std::recursive_mutex> lock(deliveryMutex);
+    if(deliveringThread == std::this_thread::get_id())
+    {
+        //a subscriber modified the graph, the loop below delivers the events
+        return;
+    }
+    deliveringThread = std::this_thread::get_id();
+    EventList events;
+    try
+    {
+        while(true)
+        {
+            {
+                std::lock_guard<std::mutex> pendingLock(pendingMutex);
+                if(pending.empty())
+                    break;
+                events.swap(pending);
+            }
+            for(const std::unique_ptr<GraphEvent>& event : events)
+            {
+                notify(*event);
+            }
+            events.clear();
+        }
+    }
+    catch(...)
+    {
+        deliveringThread = std::thread::id();
+        throw;
+    }
+    deliveringThread = std::thread::id();
+}
+
+void ConcurrentEnvireGraph::deliverEventsAfterFailure()
+{
+    try
+    {
+        deliverEvents();
+    }
+    catch(const std::exception& ex)
+    {
+        LOG(ERROR) << "Exception while delivering the events of a failed modification: " << ex.what();
+    }
+    catch(...)
+    {
+        LOG(ERROR) << "Unknown exception while delivering the events of a failed modification";
+    }
+}
+
+}}
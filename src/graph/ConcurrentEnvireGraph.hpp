@@ -0,0 +1,266 @@
+//
+// Copyright (c) 2015, Deutsches Forschungszentrum für Künstliche Intelligenz GmbH.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+
+#pragma once
+
+#include <envire_core/graph/EnvireGraph.hpp>
+#include <envire_core/events/GraphEventPublisher.hpp>
+#include <envire_core/events/GraphEventSubscriber.hpp>
+
+#include <boost/thread/shared_mutex.hpp>
+#include <boost/thread/locks.hpp>
+
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <typeindex>
+#include <utility>
+#include <vector>
+
+namespace envire { namespace core
+{
+    /**A thread-safe facade for an EnvireGraph.
+     *
+     * Queries take a shared lock and run in parallel, as long as they do not
+     * fill caches (see below). Modifications take an
+     * exclusive lock. Items are an exception, they are added and removed
+     * under the shared lock and the item lock of their frame. Thus drivers
+     * that add items to different frames do not block each other. The events of a modification are collected while the
+     * lock is held and delivered to the subscribers of the facade after it
+     * has been released. Thus subscribers may query or modify the graph.
+     * Events are delivered in the order of the modifications, one thread at
+     * a time. Events caused by a subscriber are delivered after the events
+     * that are currently being delivered.
+     *
+     * Everything that is not wrapped can be done using read() and write().
+     * The graph must not be accessed in any other way.
+     * @note Some const queries fill caches. They must not run in parallel
+     *       with the same cache:
+     *         - Lazy inverse edges and the TransformCache of the graph
+     *           modify the graph. They must not be enabled at all, write()
+     *           disables them again and logs an error.
+     *         - getTransform(origin, target, view) fills the root transform
+     *           cache of a TreeView. A view whose transform cache is enabled
+     *           must only be used by one reader at a time, e.g. one view per
+     *           thread.
+     *         - getTransform(path) fills the caches of auto updating paths.
+     *           They are guarded by the PathRegistry, thus shared paths may
+     *           be queried by several readers. Path::getFrames() and the
+     *           other accessors of a shared path are not guarded.
+     * @note Subscribe and unsubscribe using the methods of this class or
+     *       GraphEventSubscriber::subscribe(). */
+    class ConcurrentEnvireGraph : public GraphEventPublisher
+    {
+    public:
+        ConcurrentEnvireGraph();
+        virtual ~ConcurrentEnvireGraph();
+
+        bool containsFrame(const FrameId& frame) const;
+        /** @throw UnknownFrameException if one of the frames does not exist */
+        bool containsEdge(const FrameId& origin, const FrameId& target) const;
+        /** @see TransformGraph::getTransform() */
+        Transform getTransform(const FrameId& origin, const FrameId& target) const;
+        /** @return a copy of the item list, the items are not copied
+         *  @see EnvireGraph::getItems() */
+        Frame::ItemList getItems(const FrameId& frame, const std::type_index& type) const;
+        /** @see EnvireGraph::getTotalItemCount() */
+        std::size_t getTotalItemCount(const FrameId& frame) const;
+        std::size_t num_vertices() const;
+        std::size_t num_edges() const;
+
+        /**Calls @p func with the graph while holding a shared lock.
+         * @p func must not modify the graph or call other methods of
+         * this class.
+         * @return the result of @p func */
+        template <class FUNC>
+        auto read(FUNC func) const -> decltype(func(std::declval<const EnvireGraph&>()));
+
+        void addFrame(const FrameId& frame);
+        void removeFrame(const FrameId& frame);
+        void disconnectFrame(const FrameId& frame);
+        void addTransform(const FrameId& origin, const FrameId& target, const Transform& tf);
+        void updateTransform(const FrameId& origin, const FrameId& target, const Transform& tf);
+        void removeTransform(const FrameId& origin, const FrameId& target);
+        void addItemToFrame(const FrameId& frame, ItemBase::Ptr item);
+        void removeItemFromFrame(const ItemBase::Ptr item);
+        void clearFrame(const FrameId& frame);
+        /**Transforms whose SeqLockTransform is enabled can be read without
+         * taking the lock. Useful for edges that are updated at high rates.
+         * @see TransformGraph::enableSeqLock() */
+        std::shared_ptr<const SeqLockTransform> enableSeqLock(const FrameId& origin, const FrameId& target);
+        /** @see TransformGraph::disableSeqLock() */
+        bool disableSeqLock(const FrameId& origin, const FrameId& target);
+
+        /**Calls @p func with the graph while holding an exclusive lock.
+         * The events are delivered after the lock has been released, even
+         * if @p func throws. In that case exceptions of the subscribers are
+         * logged and dropped, the exception of @p func is passed on.
+         * @p func must not call other methods of this class. Lazy inverse
+         * edges and the TransformCache are disabled again if @p func enables
+         * them, see above.
+         * @return the result of @p func */
+        template <class FUNC>
+        auto write(FUNC func) -> decltype(func(std::declval<EnvireGraph&>()));
+
+        virtual void subscribe(GraphEventSubscriber* pSubscriber, bool publish_current_state = false,
+                               bool prioritized = false) override;
+        virtual void unsubscribe(GraphEventSubscriber* pSubscriber, bool unpublish_current_state = false) override;
+        virtual void updateSubscriptionFilter(GraphEventSubscriber* pSubscriber) override;
+
+    protected:
+        virtual void publishCurrentState(GraphEventSubscriber* pSubscriber) override;
+        virtual void unpublishCurrentState(GraphEventSubscriber* pSubscriber) override;
+
+    private:
+        using EventList = std::vector<std::unique_ptr<GraphEvent>>;
+
+        /**Copies the events of the graph into a list */
+        class EventCollector : public GraphEventSubscriber
+        {
+        public:
+            EventCollector(EventList& events, std::mutex* mutex) : events(events), mutex(mutex) {}
+            virtual void notifyGraphEvent(const GraphEvent& event) override;
+            virtual bool supportsBatchedEvents() const override { return true; }
+        private:
+            EventList& events;
+            std::mutex* mutex;
+        };
+
+        /**Disables lazy inverse edges and the TransformCache when a
+         * modification is done. Parallel queries would fill them. */
+        struct CacheGuard
+        {
+            explicit CacheGuard(EnvireGraph& graph) : graph(graph) {}
+            ~CacheGuard();
+            EnvireGraph& graph;
+        };
+
+        /**Calls @p func and delivers the pending events afterwards. They
+         * are delivered as well if @p func throws, see write().
+         * @return the result of @p func */
+        template <class FUNC>
+        auto deliverAfter(FUNC func) -> decltype(func())
+        {
+            return deliverAfter(func, std::is_void<decltype(func())>());
+        }
+        template <class FUNC>
+        void deliverAfter(FUNC func, std::true_type returnsVoid);
+        template <class FUNC>
+        auto deliverAfter(FUNC func, std::false_type returnsVoid) -> decltype(func());
+        /**Calls @p func and delivers the pending events if it throws */
+        template <class FUNC>
+        auto callOrDeliver(FUNC func) -> decltype(func());
+
+        /**Calls @p func with the graph while holding a shared lock.
+         * @p func may only modify items, they are protected by the item
+         * locks of the EnvireGraph. */
+        template <class FUNC>
+        void modifyItems(FUNC func);
+
+        /**Delivers all pending events. Does nothing if called by a
+         * subscriber while events are delivered. */
+        void deliverEvents();
+        /**Same as deliverEvents() but logs and drops the exceptions of the
+         * subscribers. Used while another exception is passed on. */
+        void deliverEventsAfterFailure();
+        /**Collects the current state of the graph as events.
+         * The pending events are delivered first, thus they are not part
+         * of the state. */
+        void collectState(EventList& events, const bool publish);
+
+        EnvireGraph graph;
+        mutable boost::shared_mutex graphMutex;
+
+        /**Events that have not been delivered yet */
+        EventList pending;
+        std::mutex pendingMutex;
+        EventCollector collector;
+
+        /**Serializes the delivery of events and the subscriber list */
+        std::recursive_mutex deliveryMutex;
+        std::thread::id deliveringThread;
+    };
+
+    template <class FUNC>
+    auto ConcurrentEnvireGraph::read(FUNC func) const -> decltype(func(std::declval<const EnvireGraph&>()))
+    {
+        boost::shared_lock<boost::shared_mutex> lock(graphMutex);
+        return func(static_cast<const EnvireGraph&>(graph));
+    }
+
+    template <class FUNC>
+    void ConcurrentEnvireGraph::modifyItems(FUNC func)
+    {
+        deliverAfter([this, &func]()
+        {
+            boost::shared_lock<boost::shared_mutex> lock(graphMutex);
+            func(graph);
+        });
+    }
+
+    template <class FUNC>
+    auto ConcurrentEnvireGraph::write(FUNC func) -> decltype(func(std::declval<EnvireGraph&>()))
+    {
+        //the events are delivered after the lock has been released
+        return deliverAfter([this, &func]() -> decltype(func(std::declval<EnvireGraph&>()))
+        {
+            boost::unique_lock<boost::shared_mutex> lock(graphMutex);
+            CacheGuard guard(graph);
+            return func(graph);
+        });
+    }
+
+    template <class FUNC>
+    void ConcurrentEnvireGraph::deliverAfter(FUNC func, std::true_type returnsVoid)
+    {
+        callOrDeliver(func);
+        deliverEvents();
+    }
+
+    template <class FUNC>
+    auto ConcurrentEnvireGraph::deliverAfter(FUNC func, std::false_type returnsVoid) -> decltype(func())
+    {
+        decltype(func()) result = callOrDeliver(func);
+        deliverEvents();
+        return result;
+    }
+
+    template <class FUNC>
+    auto ConcurrentEnvireGraph::callOrDeliver(FUNC func) -> decltype(func())
+    {
+        try
+        {
+            return func();
+        }
+        catch(...)
+        {
+            deliverEventsAfterFailure();
+            throw;
+        }
+    }
+}}
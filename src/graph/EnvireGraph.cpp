@@ -47,10 +47,9 @@ EnvireGraph::EnvireGraph(const EnvireGraph &other) : TransformGraph<Frame>()
   //      Therefore, we use copy_graph to copy the graph structure and add the
   //      labels manually
   
-    //copy structure from other into the base directed_graph
-    boost::copy_graph(other, graph());
-    //copy the labels
-    regenerateLabelMap();  
+    copyStructure(other);
+    if(other.isTransformCacheEnabled())
+        enableTransformCache();
 }
 
 
@@ -66,10 +65,9 @@ EnvireGraph::EnvireGraph(const EnvireGraph &other, std::unordered_set<std::type_
   //      Therefore, we use copy_graph to copy the graph structure and add the
   //      labels manually
   
-    //copy structure from other into the base directed_graph
-    boost::copy_graph(other, graph());
-    //copy the labels
-    regenerateLabelMap();    
+    copyStructure(other);
+    if(other.isTransformCacheEnabled())
+        enableTransformCache();
 
     if (filter_list != NULL) {
         // parse through all vertexes (frames) in graph
@@ -117,17 +115,26 @@ void EnvireGraph::addItem(ItemBase::Ptr item)
 
 void EnvireGraph::addItemToFrame(const FrameId& frame, ItemBase::Ptr item)
 {
-    checkFrameValid(frame);
+    const vertex_descriptor vertex = getVertex(frame); //may throw
     const std::type_index i(item->getTypeIndex());
-    (*this)[frame].items[i].push_back(item);
+    std::unique_lock<std::recursive_mutex> lock(lockItems(vertex));
+    Frame& frameProp = graph()[vertex];
+    frameProp.items[i].push_back(item);
     item->setFrame(frame);
-    notify(ItemAddedEvent(frame, item));
+    if(isRecordingUndo())
+    {
+        recordUndo([this, item]() { removeItemFromFrame(item); });
+    }
+    if(isObserved(GraphEvent::ITEM_ADDED_TO_FRAME))
+        notify(ItemAddedEvent(frameProp.id, item));
 }
 
 void EnvireGraph::clearFrame(const FrameId& frame)
 {
-    checkFrameValid(frame);
-    auto& items = (*this)[frame].items;
+    const vertex_descriptor vertex = getVertex(frame); //may throw
+    std::unique_lock<std::recursive_mutex> lock(lockItems(vertex));
+    const FrameSymbol& symbol = graph()[vertex].id;
+    auto& items = graph()[vertex].items;
     
     for(Frame::ItemMap::iterator it = items.begin(); it != items.end();)
     {
@@ -136,7 +143,12 @@ void EnvireGraph::clearFrame(const FrameId& frame)
         {
             ItemBase::Ptr removedItem = *it;
             it = list.erase(it);
-            notify(ItemRemovedEvent(frame, removedItem));
+            if(isRecordingUndo())
+            {
+                recordUndo([this, frame, removedItem]() { addItemToFrame(frame, removedItem); });
+            }
+            if(isObserved(GraphEvent::ITEM_REMOVED_FROM_FRAME))
+                notify(ItemRemovedEvent(symbol, removedItem));
         }
         it = items.erase(it);
     }
@@ -144,6 +156,7 @@ void EnvireGraph::clearFrame(const FrameId& frame)
 
 bool EnvireGraph::containsItems(const vertex_descriptor vertex, const std::type_index& type) const
 {
+  std::unique_lock<std::recursive_mutex> lock(lockItems(vertex));
   const Frame& frame = graph()[vertex];
 
   auto mapEntry = frame.items.find(type);
@@ -171,6 +184,7 @@ size_t EnvireGraph::getTotalItemCount(const FrameId& frame) const
 
 size_t EnvireGraph::getTotalItemCount(const vertex_descriptor vd) const
 {
+    std::unique_lock<std::recursive_mutex> lock(lockItems(vd));
     const Frame& frame = graph()[vd];
     return frame.calculateTotalItemCount();
 }
@@ -183,6 +197,7 @@ std::vector<std::type_index> EnvireGraph::getItemTypes(const FrameId& frame) con
 
 std::vector<std::type_index> EnvireGraph::getItemTypes(const vertex_descriptor vd) const
 {
+    std::unique_lock<std::recursive_mutex> lock(lockItems(vd));
     const Frame& frame = graph()[vd];
     return frame.getItemTypes();
 }
@@ -218,6 +233,7 @@ void EnvireGraph::removeItemFromFrame(const ItemBase::Ptr item)
 {
     const FrameId frameId = item->getFrame();
     const vertex_descriptor frame = getVertex(frameId); //may throw UnknownFrameException
+    std::unique_lock<std::recursive_mutex> lock(lockItems(frame));
     //the const_cast is fine because we are inside the EnvireGraph and know what
     //we are doing. The method returns const because the user should not be
     //able to manipulate the ItemLists directly.
@@ -231,10 +247,25 @@ void EnvireGraph::removeItemFromFrame(const ItemBase::Ptr item)
     items.erase(itemIt);
     
     item->setFrame("");
-    notify(ItemRemovedEvent(frameId, item));
+    if(isRecordingUndo())
+    {
+        recordUndo([this, frameId, item]() { addItemToFrame(frameId, item); });
+    }
+    if(isObserved(GraphEvent::ITEM_REMOVED_FROM_FRAME))
+        notify(ItemRemovedEvent(getFrameSymbol(frame), item));
 
 }
 
+std::unique_lock<std::recursive_mutex> EnvireGraph::lockItems(const FrameId& frame) const
+{
+    return lockItems(getVertex(frame)); //may throw
+}
+
+std::unique_lock<std::recursive_mutex> EnvireGraph::lockItems(const vertex_descriptor frame) const
+{
+    return std::unique_lock<std::recursive_mutex>(itemMutexes[getVertexIndex(frame) % numItemMutexes].mutex);
+}
+
 void EnvireGraph::publishCurrentState(GraphEventSubscriber* pSubscriber)
 {
     // publish vertices and edges
@@ -249,7 +280,7 @@ void EnvireGraph::publishCurrentState(GraphEventSubscriber* pSubscriber)
         {
             for(Frame::ItemList::const_iterator item = item_group->second.begin(); item != item_group->second.end(); item++)
             {
-                notifySubscriber(pSubscriber, ItemAddedEvent(frame.getId(), *item));
+                notifySubscriber(pSubscriber, ItemAddedEvent(frame.id, *item));
             }
         }
     }
@@ -266,7 +297,7 @@ void EnvireGraph::unpublishCurrentState(GraphEventSubscriber* pSubscriber)
         {
             for(Frame::ItemList::const_iterator item = item_group->second.begin(); item != item_group->second.end(); item++)
             {
-                notifySubscriber(pSubscriber, ItemRemovedEvent(frame.getId(), *item));
+                notifySubscriber(pSubscriber, ItemRemovedEvent(frame.id, *item));
             }
         }
     }
@@ -32,6 +32,8 @@
 #include <envire_core/events/ItemRemovedEvent.hpp>
 #include <envire_core/util/Demangle.hpp>
 
+#include <array>
+#include <mutex>
 #include <typeindex>
 #include <typeinfo>
 #include <type_traits>
@@ -190,6 +192,23 @@ public:
     std::vector<std::type_index> getItemTypes(const FrameId& frame) const;
     std::vector<std::type_index> getItemTypes(const vertex_descriptor vd) const;
     
+    /**Locks the items of @p frame.
+     * The item methods lock the items of the frame that they access. Thus
+     * items can be added to and removed from different frames by several
+     * threads at the same time, as long as the frames and edges do not
+     * change, no one subscribes and no transaction is running meanwhile.
+     * The events are sent while the lock is held, thus the events of one
+     * frame arrive in order. Subscribers have to be thread-safe if items
+     * are modified concurrently.
+     * getItems() returns references into the frame, hold this lock while
+     * using them if other threads modify the frame.
+     * @note Several frames share a lock. Subscribers should not modify items
+     *       of other frames while items are modified concurrently, this
+     *       might dead lock.
+     * @throw UnknownFrameException if @p frame is not part of this graph */
+    std::unique_lock<std::recursive_mutex> lockItems(const FrameId& frame) const;
+    std::unique_lock<std::recursive_mutex> lockItems(const vertex_descriptor frame) const;
+    
     
     /**Removes @p frame from the Graph.
     *  A frame can only be removed if there are no edges connected to
@@ -253,6 +272,18 @@ protected:
     virtual void unpublishCurrentState(GraphEventSubscriber* pSubscriber);
     
 private:
+    /**Each lock on its own cache line, threads that lock different frames
+     * should not slow each other down */
+    struct alignas(64) ItemMutex
+    {
+        std::recursive_mutex mutex;
+    };
+    
+    /**The item locks are striped by vertex index. A lock per frame would
+     * have to be kept in sync with the frames. */
+    static const std::size_t numItemMutexes = 64;
+    mutable std::array<ItemMutex, numItemMutexes> itemMutexes;
+    
     /**Grants access to boost serialization */
     friend class boost::serialization::access;
     
@@ -288,9 +319,9 @@ EnvireGraph::getItems(const FrameId& frame) const
 template <class T>
 void EnvireGraph::visitItems(const FrameId& frameId, T func) const
 {
-  checkFrameValid(frameId);
-  const Frame& frame = (*this)[frameId];
-  frame.visitItems(func);
+  const vertex_descriptor vertex = getVertex(frameId); //may throw
+  std::unique_lock<std::recursive_mutex> lock(lockItems(vertex));
+  graph()[vertex].visitItems(func);
 }
 
 template<class T>
@@ -363,10 +394,11 @@ EnvireGraph::ItemIteratorPair<T>
 EnvireGraph::removeItemFromFrame(const FrameId& frameId, ItemIterator<T> item)
 {
     assertDerivesFromItemBase<T>();
-    checkFrameValid(frameId);
+    const vertex_descriptor vertex = getVertex(frameId); //may throw
     assert(frameId.compare(item->getFrame()) == 0);
     
-    Frame& frame = (*this)[frameId];
+    std::unique_lock<std::recursive_mutex> lock(lockItems(vertex));
+    Frame& frame = graph()[vertex];
     const std::type_index key(typeid(T));
     auto mapEntry = frame.items.find(key);
     if(mapEntry == frame.items.end())
@@ -383,7 +415,12 @@ EnvireGraph::removeItemFromFrame(const FrameId& frameId, ItemIterator<T> item)
     ItemBase::Ptr deletedItem = *nonConstBaseIterator;//backup item so we can notify the user
     std::vector<ItemBase::Ptr>::const_iterator next = items.erase(nonConstBaseIterator);
     deletedItem->setFrame("");
-    notify(ItemRemovedEvent(frameId, deletedItem));
+    if(isRecordingUndo())
+    {
+        recordUndo([this, frameId, deletedItem]() { addItemToFrame(frameId, deletedItem); });
+    }
+    if(isObserved(GraphEvent::ITEM_REMOVED_FROM_FRAME))
+        notify(ItemRemovedEvent(frame.id, deletedItem));
     
     ItemIterator<T> nextIt(next, ItemBaseCaster<T>()); 
     ItemIterator<T> endIt(items.cend(), ItemBaseCaster<T>()); 
@@ -428,6 +465,7 @@ template <class T>
 size_t EnvireGraph::getItemCount(const vertex_descriptor vd) const
 {
     assertDerivesFromItemBase<T>();
+    std::unique_lock<std::recursive_mutex> lock(lockItems(vd));
     const Frame& frame = graph()[vd];
     const std::type_index key(typeid(T));
     auto mapEntry = frame.items.find(key);
@@ -26,9 +26,12 @@
 
 #pragma once
 
+#include <functional>
+#include <memory>
 #include <type_traits>
 
 #include <envire_core/events/GraphEventPublisher.hpp>
+#include <envire_core/events/GraphEventQueue.hpp>
 #include <envire_core/events/FrameEvents.hpp>
 #include <envire_core/events/EdgeEvents.hpp>
 
@@ -37,10 +40,14 @@
 #include <boost/concept_check.hpp>
 
 #include <envire_core/graph/GraphTypes.hpp>
+#include <envire_core/graph/GraphStorage.hpp>
 #include <envire_core/graph/TreeView.hpp>
 #include <envire_core/graph/GraphExceptions.hpp>
 #include <envire_core/graph/GraphVisitors.hpp>
+#include <envire_core/graph/PathSearch.hpp>
+#include <envire_core/graph/TraversalWorkspace.hpp>
 #include <envire_core/graph/Path.hpp>
+#include <envire_core/graph/PathRegistry.hpp>
 
 
 namespace envire { namespace core
@@ -56,8 +63,10 @@ namespace envire { namespace core
  * words, new methods use Camel Case separated words
  * 
  * @param FRAME_PROP should follow the FramePropertyConcept (see GraphTypes.hpp)
- * @param EDGE_PROP should follow the EdgePropertyConcept concept (see GraphTypes.hpp) */
-template <class FRAME_PROP, class EDGE_PROP>
+ * @param EDGE_PROP should follow the EdgePropertyConcept concept (see GraphTypes.hpp)
+ * @param STORAGE decides how the graph is searched and traversed.
+ *                Either ListStorage or DenseStorage (see GraphStorage.hpp) */
+template <class FRAME_PROP, class EDGE_PROP, class STORAGE = ListStorage>
 class Graph : public GraphBase<FRAME_PROP, EDGE_PROP>, 
               public envire::core::GraphEventPublisher,
               public envire::core::TreeUpdatePublisher
@@ -73,6 +82,7 @@ public:
      using vertex_iterator = typename Base::vertex_iterator;
      using edge_iterator = typename Base::edge_iterator;
      using Base::vertex;
+     using Base::operator[];
     
     Graph();
     
@@ -130,6 +140,11 @@ public:
      *  @throw NullVertexException if vertex is null_vertex */
     const FrameId& getFrameId(const vertex_descriptor vertex) const;
     
+    /** @return the interned id of the specified @p vertex. This does not
+     *          touch the global symbol table.
+     *  @throw NullVertexException if vertex is null_vertex */
+    const FrameSymbol& getFrameSymbol(const vertex_descriptor vertex) const;
+    
     /** @return true if this graph contains a frame with id @p frameId, false
      *          otherwise.*/
     bool containsFrame(const FrameId& frameId) const;
@@ -185,6 +200,28 @@ public:
     const EDGE_PROP& getEdgeProperty(const vertex_descriptor origin, const vertex_descriptor target) const;
     const EDGE_PROP& getEdgeProperty(const edge_descriptor edge) const;
     
+    /** @return the property of @p edge. If lazy inverse edges are enabled and
+     *          the property is stale, it is calculated from the inverse edge first.*/
+    const EDGE_PROP& operator[](const edge_descriptor edge) const;
+    EDGE_PROP& operator[](const edge_descriptor edge);
+    
+    /**Enables lazy inverse edges.
+     * By default setEdgeProperty() updates both directions of an edge and
+     * calculates prop.inverse() on every update. With lazy inverse edges
+     * only the updated direction is written and the inverse is marked as
+     * stale. It is calculated once it is accessed the next time.
+     * The graph behaves exactly as before, events are unchanged.
+     * @note Const accessors might update stale edges. Thus concurrent reads
+     *       are not safe while lazy inverse edges are enabled. */
+    void enableLazyInverseEdges();
+    /**Calculates all stale edges and disables lazy inverse edges */
+    void disableLazyInverseEdges();
+    bool isLazyInverseEdgesEnabled() const;
+    
+    /**Calculates all stale inverse edges. Needs to be called before the
+     * edge properties are accessed directly, e.g. using boost::edge_bundle.*/
+    void resolveInverseEdges() const;
+    
     /** @throw UnknownFrameException if @p frame does not exist.*/
     const FRAME_PROP& getFrameProperty(const FrameId& frame) const;
     
@@ -206,6 +243,21 @@ public:
                                  const FrameId& target,
                                  const EDGE_PROP& prop);
     
+    /**A single update of setEdgeProperties() */
+    struct EdgePropertyUpdate
+    {
+        vertex_descriptor origin;
+        vertex_descriptor target;
+        EDGE_PROP prop;
+    };
+    
+    /**Sets the properties of several edges at once. Behaves like calling
+     * setEdgeProperty() for each update, but the subscribers are notified
+     * with a single EdgesModifiedEvent. All edges are looked up before
+     * anything is modified, thus either all or none of them are updated.
+     * @throw UnknownEdgeException If one of the edges does not exist */
+    void setEdgeProperties(const std::vector<EdgePropertyUpdate>& updates);
+    
     
     /** @return the source vertex of the @p edge*/
     const vertex_descriptor getSourceVertex(const edge_descriptor edge) const;
@@ -266,10 +318,17 @@ public:
      * 
      * @throw UnknownFrameException if @p origin or @p target don't exist.
      * @param autoUpdating If true, an auto updating path will be returned.
-     *                     I.e. a path that is subscribed to graph and
-     *                     notices when an edge on the path is removed*/
+     *                     I.e. a path that is registered at the graph and
+     *                     notices when an edge on the path is removed.
+     *                     Auto updating paths with the same origin and
+     *                     target are shared, the path is only searched if
+     *                     the shared path is dirty or empty.*/
     Path::Ptr getPath(const FrameId& origin, const FrameId& target,
                                   const bool autoUpdating);
+    
+    /** @return the registry of the auto updating paths or nullptr if no
+     *          auto updating path has been created, yet */
+    const PathRegistry* getPathRegistry() const { return pathRegistry.get(); }
        
     
     /** @return number of frames in this graph*/
@@ -285,7 +344,10 @@ public:
     
     /** Visit Graph in bfs order.
      * This is a wrapper around boost::breadth_first_search that correctly
-     * parameterizes boost::breadth_first_search to work with this graph. */
+     * parameterizes boost::breadth_first_search to work with this graph.
+     * @p visitor are bgl named parameters. visitor(), color_map() and
+     * buffer() are supported, vertex_index_map() is rejected because the
+     * vertex_index of the graph is always used. */
     template <class VISITOR>
     void breadthFirstSearch(const vertex_descriptor root, VISITOR visitor) const;
     
@@ -308,6 +370,78 @@ public:
     template <class VISITOR>
     void visitVertices(VISITOR visitor);
     
+    /**Looks up the edge from @p origin to @p target using the storage policy.
+     * Behaves like boost::edge(origin, target, graph).
+     * @return The edge and true if it exists. false as second element if
+     *         there is no such edge.*/
+    EdgePair findEdge(const vertex_descriptor origin, const vertex_descriptor target) const;
+    
+    /** @return the storage policy of this graph */
+    const STORAGE& getStorage() const;
+    
+    /** @return the index of @p vertex. Indices are dense but might be reused
+     *          after a vertex has been removed. They can be used to store
+     *          per vertex data in a vector.
+     *  @throw NullVertexException if vertex is null_vertex */
+    std::size_t getVertexIndex(const vertex_descriptor vertex) const;
+    
+    /** @return an upper bound for all indices returned by getVertexIndex() */
+    std::size_t getVertexIndexBound() const;
+    
+    /** @return a handle to @p vertex or @p edge that can be used to detect
+     *          whether the element has been removed.
+     *  @note Vertex handles are only available if the storage policy
+     *        supports them, e.g. DenseStorage. Edge handles are supported
+     *        by all storage policies.*/
+    VertexHandle getHandle(const vertex_descriptor vertex) const;
+    EdgeHandle getHandle(const edge_descriptor edge) const;
+    
+    /** @return the vertex referred to by @p handle or null_vertex() if the
+     *          vertex has been removed.*/
+    vertex_descriptor resolve(const VertexHandle handle) const;
+    
+    /** @return the edge referred to by @p handle. The second element is
+     *          false if the edge has been removed.*/
+    EdgePair resolve(const EdgeHandle handle) const;
+    
+    /**Starts a transaction.
+     * Inside a transaction the subscribed TreeViews are not updated and
+     * the subscribers are not notified on every modification. Instead the
+     * TreeViews are rebuilt once and the events are coalesced and published
+     * when the transaction is committed. Events that cancel each other out
+     * (e.g. adding and removing the same edge) are not published at all.
+     * This is meant for building large graphs, e.g. when loading a map.
+     * 
+     * Prioritized subscribers (caches) are still notified immediately.
+     * Queries work as usual inside a transaction, only the TreeViews are
+     * out of date until the transaction ends. Queries that walk a TreeView
+     * do not use its parent edges and cached root transforms, they look
+     * the edges up in the graph instead.
+     * 
+     * @see GraphTransaction for a scoped transaction
+     * @throw TransactionException if a transaction is already active */
+    void beginTransaction();
+    
+    /**Commits the active transaction. Rebuilds all subscribed TreeViews and
+     * publishes the coalesced events.
+     * @throw TransactionException if there is no active transaction */
+    void commitTransaction();
+    
+    /**Rolls the graph back to the state before beginTransaction().
+     * Removed frames and edges are restored using their old properties,
+     * but they get new descriptors. Thus the subscribers are notified about
+     * the removal and the re-adding of those elements. All other events of
+     * the transaction cancel each other out.
+     * Removed items of an EnvireGraph are re-added at the end of their
+     * item list.
+     * The transaction ends even if an undo operation or a subscriber
+     * throws. The exception is passed on, the graph might be only partially
+     * rolled back in that case.
+     * @throw TransactionException if there is no active transaction */
+    void abortTransaction();
+    
+    /** @return true if a transaction is active */
+    bool isInTransaction() const;
     
 protected:
     using map_type = typename GraphBase<FRAME_PROP, EDGE_PROP>::map_type;
@@ -349,14 +483,99 @@ protected:
      */
     virtual void unpublishCurrentState(GraphEventSubscriber* pSubscriber);
     
-    /**Re-generates the content of _map based on the FrameIds.
+    /**Re-generates the content of _map based on the FrameIds,
+     * renumbers the vertex and edge indices and rebuilds the storage.
      * This method is used when de-serializing or copying the graph.*/
     void regenerateLabelMap();
     
+    /**Deep copies the structure and properties of @p other into this graph.
+     * This graph has to be empty.*/
+    void copyStructure(const Graph& other);
+    
+    /**Additional topology information used for searching. Has to be kept
+     * in sync with the graph whenever vertices or edges are added or removed*/
+    STORAGE storage;
+    
+    /**The interned FrameIds of all vertices indexed by vertex index.
+     * Used to create events without interning the ids again. */
+    std::vector<FrameSymbol> frameSymbols;
+    
+    /**Marks the stale edges of lazy inverse edges, indexed by edge index */
+    mutable std::vector<bool> staleEdges;
+    bool lazyInverseEdges = false;
+    
+    /**Recalculates @p edge from its inverse edge if it is stale */
+    void resolveInverseEdge(const edge_descriptor edge) const;
+    /**Sets the stale flag of @p edge */
+    void setStale(const edge_descriptor edge, const bool stale);
+    
+    /**Sets the property of @p originToTarget and updates the inverse edge,
+     * the tree views and the subscribers. */
+    void updateEdgeProperty(const edge_descriptor originToTarget,
+                            const edge_descriptor targetToOrigin,
+                            const EDGE_PROP& prop);
+    
+    /**Same as updateEdgeProperty() but does not notify the subscribers */
+    void writeEdgeProperty(const edge_descriptor originToTarget,
+                           const edge_descriptor targetToOrigin,
+                           const EDGE_PROP& prop);
+    
     
     /**TreeViews that need to be updated when the graph is modified */
     std::vector<TreeView*> subscribedTreeViews;
     
+    /**Notifies the subscribers about @p e.
+     * Inside a transaction only the prioritized subscribers are notified,
+     * the event is queued for all others.
+     * Does nothing if no subscriber is interested in the type of @p e.
+     * Call sites where creating the event is not free should check
+     * isObserved() themselves.
+     * @note This hides GraphEventPublisher::notify() on purpose. All events
+     *       of the graph and its subclasses should be sent using this method.*/
+    void notify(const GraphEvent& e);
+    
+    /** @return true if modifications should record how to undo them.
+     *          This is the case inside a transaction unless the transaction
+     *          is being rolled back.*/
+    bool isRecordingUndo() const;
+    
+    /**Adds @p undo to the undo log of the active transaction.
+     * On abort the undo log is replayed in reverse order.
+     * Subclasses that modify the graph without calling the methods of this
+     * class have to record their modifications here.
+     * Should only be called if isRecordingUndo() is true. */
+    void recordUndo(std::function<void()> undo);
+    
+    /**Collects the events of a transaction until it ends */
+    class TransactionEvents : public GraphEventQueue
+    {
+    public:
+        explicit TransactionEvents(Graph& graph) : graph(graph) {}
+        /**The prioritized subscribers have been notified already */
+        virtual void process(const GraphEvent& event) { graph.notifyUnprioritized(event); }
+    private:
+        Graph& graph;
+    };
+    
+    struct Transaction
+    {
+        explicit Transaction(Graph& graph) : events(graph) {}
+        TransactionEvents events;
+        std::vector<std::function<void()>> undoLog;
+        /**TreeViews whose root frame has been removed during the transaction */
+        std::vector<std::pair<TreeView*, FrameId>> removedRoots;
+        bool rollingBack = false;
+    };
+    
+    /**The active transaction or nullptr */
+    std::unique_ptr<Transaction> transaction;
+    
+    /**Manages the auto updating paths. Created with the first one */
+    std::unique_ptr<PathRegistry> pathRegistry;
+    
+    /**Rebuilds the TreeViews and publishes the events of the transaction */
+    void endTransaction();
+    
 private:
     /**Grants access to boost serialization */
     friend class boost::serialization::access;
@@ -381,8 +600,8 @@ private:
 
 
 
-template <class F, class E>
-Graph<F,E>::Graph()
+template <class F, class E, class S>
+Graph<F,E,S>::Graph()
 {
     /**These asserts are important because:
      *   * we are handing out vertex_descriptor and edge_descriptor to the user.
@@ -399,8 +618,8 @@ Graph<F,E>::Graph()
     BOOST_CONCEPT_ASSERT((FramePropertyConcept<F>));
 }
 
-template <class F, class E>
-Graph<F,E>::Graph(const Graph<F, E>& other) : Base()
+template <class F, class E, class S>
+Graph<F,E,S>::Graph(const Graph<F,E,S>& other) : Base()
 {
   //NOTE: we are explicitly avoiding calling any copy constructor because boost
   //      graphs are not deep copied by default. To achieve deep copies
@@ -411,14 +630,28 @@ Graph<F,E>::Graph(const Graph<F, E>& other) : Base()
   //      Therefore, we use copy_graph to copy the graph structure and add the
   //      labels manually
   
-  //copy structure from other into the base directed_graph
-  boost::copy_graph(other, graph());
-  //copy the labels
-  regenerateLabelMap();
+  copyStructure(other);
+}
+
+template <class F, class E, class S>
+void Graph<F,E,S>::copyStructure(const Graph<F,E,S>& other)
+{
+    //the stale flags are indexed by edge index, which is not copied
+    other.resolveInverseEdges();
+    lazyInverseEdges = other.lazyInverseEdges;
+    //copy_graph maps the vertices of other using a vector that is indexed by
+    //the vertex_index and only has num_vertices() elements. This does not
+    //work if vertices have been removed from other, thus a map is used.
+    std::unordered_map<vertex_descriptor, vertex_descriptor> originalToCopy;
+    //copy structure from other into the base directed_graph
+    boost::copy_graph(other, graph(),
+                      boost::orig_to_copy(boost::make_assoc_property_map(originalToCopy)));
+    //copy the labels
+    regenerateLabelMap();
 }
 
-template <class F, class E>
-typename Graph<F,E>::vertex_descriptor Graph<F,E>::addFrame(const FrameId& frame)
+template <class F, class E, class S>
+typename Graph<F,E,S>::vertex_descriptor Graph<F,E,S>::addFrame(const FrameId& frame)
 {
     vertex_descriptor desc = vertex(frame);
     if(desc == null_vertex())
@@ -434,17 +667,28 @@ typename Graph<F,E>::vertex_descriptor Graph<F,E>::addFrame(const FrameId& frame
     return desc;
 }
 
-template <class F, class E>
-typename Graph<F,E>::vertex_descriptor Graph<F,E>::add_vertex(const FrameId& frameId,
+template <class F, class E, class S>
+typename Graph<F,E,S>::vertex_descriptor Graph<F,E,S>::add_vertex(const FrameId& frameId,
                                                               const F& frame)
 {
     vertex_descriptor v = GraphBase<F, E>::add_vertex(frameId, frame);
-    notify(FrameAddedEvent(frameId));
+    storage.vertexAdded(graph(), v);
+    const std::size_t index = boost::get(boost::vertex_index, graph(), v);
+    if(frameSymbols.size() <= index)
+    {
+        frameSymbols.resize(storage.vertexIndexBound(graph()));
+    }
+    frameSymbols[index] = frameId;
+    if(isRecordingUndo())
+    {
+        recordUndo([this, frameId]() { removeFrame(frameId); });
+    }
+    notify(FrameAddedEvent(frameSymbols[index]));
     return v;
 }
 
-template <class F, class E>
-typename Graph<F,E>::edge_descriptor Graph<F,E>::getEdge(const FrameId& origin,
+template <class F, class E, class S>
+typename Graph<F,E,S>::edge_descriptor Graph<F,E,S>::getEdge(const FrameId& origin,
                                                          const FrameId& target) const
 {
     vertex_descriptor originDesc = getVertex(origin); //throws
@@ -452,11 +696,11 @@ typename Graph<F,E>::edge_descriptor Graph<F,E>::getEdge(const FrameId& origin,
     return getEdge(originDesc, targetDesc);
 }
 
-template <class F, class E>
-typename Graph<F,E>::edge_descriptor Graph<F,E>::getEdge(const vertex_descriptor origin,
+template <class F, class E, class S>
+typename Graph<F,E,S>::edge_descriptor Graph<F,E,S>::getEdge(const vertex_descriptor origin,
                                                          const vertex_descriptor target) const
 {
-    EdgePair e = boost::edge(origin, target, graph());
+    EdgePair e = findEdge(origin, target);
     if(!e.second)
     {
         throw UnknownEdgeException(getFrameId(origin), getFrameId(target));
@@ -464,16 +708,24 @@ typename Graph<F,E>::edge_descriptor Graph<F,E>::getEdge(const vertex_descriptor
     return e.first;
 }
 
-template <class F, class E>
-const FrameId& Graph<F,E>::getFrameId(const vertex_descriptor vertex) const
+template <class F, class E, class S>
+const FrameId& Graph<F,E,S>::getFrameId(const vertex_descriptor vertex) const
 {
     if(vertex == GraphTraits::null_vertex())
       throw NullVertexException();
     return graph()[vertex].getId();
 }
 
-template <class F, class E>
-typename Graph<F,E>::vertex_descriptor Graph<F,E>::getVertex(const FrameId& frame) const
+template <class F, class E, class S>
+const FrameSymbol& Graph<F,E,S>::getFrameSymbol(const vertex_descriptor vertex) const
+{
+    if(vertex == GraphTraits::null_vertex())
+      throw NullVertexException();
+    return frameSymbols[boost::get(boost::vertex_index, graph(), vertex)];
+}
+
+template <class F, class E, class S>
+typename Graph<F,E,S>::vertex_descriptor Graph<F,E,S>::getVertex(const FrameId& frame) const
 {
     vertex_descriptor desc = vertex(frame);
     if(desc == null_vertex())
@@ -483,8 +735,8 @@ typename Graph<F,E>::vertex_descriptor Graph<F,E>::getVertex(const FrameId& fram
     return desc;
 }
 
-template <class F, class E>
-void Graph<F,E>::disconnectFrame(const FrameId& frame)
+template <class F, class E, class S>
+void Graph<F,E,S>::disconnectFrame(const FrameId& frame)
 {
     const vertex_descriptor frameDesc = getVertex(frame);
     
@@ -503,8 +755,8 @@ void Graph<F,E>::disconnectFrame(const FrameId& frame)
     } while(begin != end);
 }
 
-template <class F, class E>
-void Graph<F,E>::removeFrame(const FrameId& frame)
+template <class F, class E, class S>
+void Graph<F,E,S>::removeFrame(const FrameId& frame)
 {
     vertex_descriptor desc = getVertex(frame); //will throw
     if(boost::degree(desc, *this) > 0)
@@ -512,6 +764,22 @@ void Graph<F,E>::removeFrame(const FrameId& frame)
         throw FrameStillConnectedException(frame);
     }
     
+    const FrameSymbol symbol = getFrameSymbol(desc);
+    if(isRecordingUndo())
+    {
+        const F frameProp = graph()[desc];
+        recordUndo([this, frame, frameProp]() { add_vertex(frame, frameProp); });
+    }
+    if(transaction)
+    {
+        for(TreeView* view : subscribedTreeViews)
+        {
+            if(view->root == desc)
+                transaction->removedRoots.emplace_back(view, frame);
+        }
+    }
+    frameSymbols[boost::get(boost::vertex_index, graph(), desc)] = FrameSymbol();
+    storage.vertexRemoved(graph(), desc);
     boost::remove_vertex(desc, graph());//If the HACK is removed, remove_vertex needs to be called with frame as first parameter
     //HACK this is a workaround for bug https://svn.boost.org/trac/boost/ticket/9493
     //If the bug is fixed also remove the #define private protected in GraphTypes.hpp
@@ -520,33 +788,33 @@ void Graph<F,E>::removeFrame(const FrameId& frame)
     {
         _map.erase(it);
     }
-    notify(envire::core::FrameRemovedEvent(frame));
+    notify(envire::core::FrameRemovedEvent(symbol));
 }
 
-template <class F, class E>
-envire::core::TreeView Graph<F,E>::getTree(const vertex_descriptor root) const
+template <class F, class E, class S>
+envire::core::TreeView Graph<F,E,S>::getTree(const vertex_descriptor root) const
 {
     TreeView view(root);
     getTree(root, &view);
     return std::move(view);
 }
 
-template <class F, class E>
-envire::core::TreeView Graph<F,E>::getTree(const FrameId rootId) const
+template <class F, class E, class S>
+envire::core::TreeView Graph<F,E,S>::getTree(const FrameId rootId) const
 {
     const vertex_descriptor root = getVertex(rootId);
     return getTree(root);
 }
 
-template <class F, class E>
-void Graph<F,E>::getTree(const FrameId rootId, TreeView* outView) const
+template <class F, class E, class S>
+void Graph<F,E,S>::getTree(const FrameId rootId, TreeView* outView) const
 {
     vertex_descriptor root = getVertex(rootId);
     getTree(root, outView);
 }
 
-template <class F, class E>
-void Graph<F,E>::getTree(const vertex_descriptor root, const bool keepTreeUpdated, TreeView* outView)
+template <class F, class E, class S>
+void Graph<F,E,S>::getTree(const vertex_descriptor root, const bool keepTreeUpdated, TreeView* outView)
 {
     getTree(root, outView);    
     if(keepTreeUpdated)
@@ -555,86 +823,87 @@ void Graph<F,E>::getTree(const vertex_descriptor root, const bool keepTreeUpdate
     }
 }
 
-template <class F, class E>
-void Graph<F,E>::getTree(const FrameId rootId, const bool keepTreeUpdated, TreeView* outView)
+template <class F, class E, class S>
+void Graph<F,E,S>::getTree(const FrameId rootId, const bool keepTreeUpdated, TreeView* outView)
 {
     const vertex_descriptor root = getVertex(rootId);
     getTree(root, keepTreeUpdated, outView);
 }
 
-template <class F, class E>
-void Graph<F,E>::getTree(const vertex_descriptor root, TreeView* outView) const
+template <class F, class E, class S>
+void Graph<F,E,S>::getTree(const vertex_descriptor root, TreeView* outView) const
 {
     outView->addRoot(root);
-    TreeBuilderVisitor<Graph<F,E>> visitor(*outView, *this);
+    TreeBuilderVisitor<Graph<F,E,S>> visitor(*outView, *this);
     breadthFirstSearch(root, boost::visitor(visitor));
 }
 
-template <class F, class E>
-void Graph<F,E>::unsubscribeTreeView(TreeView* view)
+template <class F, class E, class S>
+void Graph<F,E,S>::unsubscribeTreeView(TreeView* view)
 {
+    if(transaction)
+    {
+        std::vector<std::pair<TreeView*, FrameId>>& roots = transaction->removedRoots;
+        roots.erase(std::remove_if(roots.begin(), roots.end(),
+                                   [view](const std::pair<TreeView*, FrameId>& root)
+                                   { return root.first == view; }),
+                    roots.end());
+    }
     subscribedTreeViews.erase(std::remove(subscribedTreeViews.begin(),
                                           subscribedTreeViews.end(), view),
                               subscribedTreeViews.end());
 }
 
-template <class F, class E>
-void Graph<F,E>::subscribeTreeView(TreeView* view)
+template <class F, class E, class S>
+void Graph<F,E,S>::subscribeTreeView(TreeView* view)
 {
     assert(view != nullptr);
     subscribedTreeViews.push_back(view);
     view->setPublisher(this); //now the TreeView will automatically unsubscribe on destruction
 }
 
-template <class F, class E>
-std::vector<FrameId> Graph<F,E>::getFrames(FrameId origin, FrameId target) const
+template <class F, class E, class S>
+std::vector<FrameId> Graph<F,E,S>::getFrames(FrameId origin, FrameId target) const
 {
     vertex_descriptor fromDesc = getVertex(origin); //may throw
     vertex_descriptor toDesc = getVertex(target); //may throw
   
     std::vector<FrameId> path;
-    envire::core::GraphBFSVisitor <vertex_descriptor>visit(toDesc, this->graph());
-    try
-    {
-        breadthFirstSearch(fromDesc, boost::visitor(visit));
-
-    }catch(const FoundFrameException &e)
+    PathSearch<typename Base::graph_type, S> search(graph(), storage);
+    //a path that consists of a single frame is not a path
+    if(search.search(fromDesc, toDesc) && search.getVertices().size() > 1)
     {
-        typename std::deque<vertex_descriptor>::iterator it = visit.tree->begin();
-        for (; (it+1) != visit.tree->end(); ++it)
+        path.reserve(search.getVertices().size());
+        for(const vertex_descriptor v : search.getVertices())
         {
-            path.push_back(getFrameId(*it));
+            path.push_back(getFrameId(v));
         }
     }
-    if(path.size() > 0)
-    {
-        path.push_back(target);
-    }
     //return is fine, compiler will detect this and move instead of copy
     return path;
 }
 
-template <class F, class E>
-const typename Graph<F,E>::vertex_descriptor Graph<F,E>::getSourceVertex(const edge_descriptor edge) const
+template <class F, class E, class S>
+const typename Graph<F,E,S>::vertex_descriptor Graph<F,E,S>::getSourceVertex(const edge_descriptor edge) const
 {
     return boost::source(edge, graph());
 }
 
-template <class F, class E>
-const typename Graph<F,E>::vertex_descriptor Graph<F,E>::getTargetVertex(const edge_descriptor edge) const
+template <class F, class E, class S>
+const typename Graph<F,E,S>::vertex_descriptor Graph<F,E,S>::getTargetVertex(const edge_descriptor edge) const
 {
     return boost::target(edge, graph());
 }
 
 
-template <class F, class E>
-void Graph<F,E>::add_edge(const vertex_descriptor origin,
+template <class F, class E, class S>
+void Graph<F,E,S>::add_edge(const vertex_descriptor origin,
                           const vertex_descriptor target,
                           const E& edgeProperty)
 {   
     //check if an edge already exists
     //If a->b exists, b->a also exist. Therefore we need to check only one direction
-    EdgePair e = boost::edge(origin, target, *this);
+    EdgePair e = findEdge(origin, target);
     if(e.second)// edge already exists
     {
         throw EdgeAlreadyExistsException(getFrameId(origin), getFrameId(target));
@@ -643,17 +912,28 @@ void Graph<F,E>::add_edge(const vertex_descriptor origin,
     EdgePair edge_pair =  boost::add_edge(origin, target, edgeProperty, *this);
     EdgePair edge_pair_inv =  boost::add_edge(target, origin, edgeProperty.inverse(), *this);
     assert(edge_pair_inv.second);//origin->target has already been checkd before
+    storage.edgeAdded(graph(), edge_pair.first);
+    storage.edgeAdded(graph(), edge_pair_inv.first);
+    //indices of removed edges might be reused
+    setStale(edge_pair.first, false);
+    setStale(edge_pair_inv.first, false);
+    if(isRecordingUndo())
+    {
+        const FrameId originId = getFrameId(origin);
+        const FrameId targetId = getFrameId(target);
+        recordUndo([this, originId, targetId]() { remove_edge(originId, targetId); });
+    }
     
     //note: we only need to add one of the edges to the tree, because the tree
     //      does not care about the edge direction.
     //      In fact: if we add both, both will end up in the cross edges list
     //      which might lead to infinite recursion when updating edges
     addEdgeToTreeViews(edge_pair.first);
-    notify(envire::core::EdgeAddedEvent(getFrameId(origin), getFrameId(target), edge_pair.first));
+    notify(envire::core::EdgeAddedEvent(getFrameSymbol(origin), getFrameSymbol(target), edge_pair.first));
 }
 
-template <class F, class E>
-void Graph<F,E>::add_edge(const FrameId& origin,
+template <class F, class E, class S>
+void Graph<F,E,S>::add_edge(const FrameId& origin,
                           const FrameId& target,
                           const E& edgeProperty)
 {
@@ -677,46 +957,60 @@ void Graph<F,E>::add_edge(const FrameId& origin,
     return add_edge(originDesc, targetDesc, edgeProperty);
 }
 
-template <class F, class E>
-void Graph<F,E>::remove_edge(const FrameId& origin, const FrameId& target, 
+template <class F, class E, class S>
+void Graph<F,E,S>::remove_edge(const FrameId& origin, const FrameId& target, 
                              const vertex_descriptor originDesc, 
                              const vertex_descriptor targetDesc)
 {
     //note: do not use boost::edge_by_label as it will segfault if one of the
     //frames is not part of the tree.
-    EdgePair originToTarget = boost::edge(originDesc, targetDesc, graph());
-    EdgePair targetToOrigin = boost::edge(targetDesc, originDesc, graph());
+    EdgePair originToTarget = findEdge(originDesc, targetDesc);
+    EdgePair targetToOrigin = findEdge(targetDesc, originDesc);
     if(!originToTarget.second || !targetToOrigin.second)
     {
         throw UnknownEdgeException(origin, target);
     }
     
+    //the inverse cannot be calculated once one of the edges is gone
+    resolveInverseEdge(originToTarget.first);
+    resolveInverseEdge(targetToOrigin.first);
+    if(isRecordingUndo())
+    {
+        const E prop = graph()[originToTarget.first];
+        recordUndo([this, origin, target, prop]() { add_edge(origin, target, prop); });
+    }
+    
+    storage.edgeRemoved(graph(), originToTarget.first);
     boost::remove_edge(originToTarget.first, *this);
-    notify(envire::core::EdgeRemovedEvent(origin, target));
+    notify(envire::core::EdgeRemovedEvent(getFrameSymbol(originDesc), getFrameSymbol(targetDesc)));
     
+    storage.edgeRemoved(graph(), targetToOrigin.first);
     boost::remove_edge(targetToOrigin.first, *this);
     
     removeEdgeFromTreeViews(originDesc, targetDesc);
     
 }
 
-template <class F, class E>
-void Graph<F,E>::remove_edge(const vertex_descriptor origin,
+template <class F, class E, class S>
+void Graph<F,E,S>::remove_edge(const vertex_descriptor origin,
                              const vertex_descriptor target)
 {
     remove_edge(getFrameId(origin), getFrameId(target), origin, target);
 }
 
-template <class F, class E>
-void Graph<F,E>::remove_edge(const FrameId& origin,
+template <class F, class E, class S>
+void Graph<F,E,S>::remove_edge(const FrameId& origin,
                              const FrameId& target)
 {
     remove_edge(origin, target, getVertex(origin), getVertex(target));
 }
 
-template <class F, class E>
-void Graph<F,E>::removeEdgeFromTreeViews(vertex_descriptor origin, vertex_descriptor target) const
+template <class F, class E, class S>
+void Graph<F,E,S>::removeEdgeFromTreeViews(vertex_descriptor origin, vertex_descriptor target) const
 {
+    //the views are rebuilt at the end of the transaction
+    if(transaction)
+        return;
     for(TreeView* view : subscribedTreeViews)
     {
         if(view->edgeExists(origin, target))
@@ -724,17 +1018,20 @@ void Graph<F,E>::removeEdgeFromTreeViews(vertex_descriptor origin, vertex_descri
     }    
 }
 
-template <class F, class E>
-void Graph<F,E>::addEdgeToTreeViews(edge_descriptor newEdge) const
+template <class F, class E, class S>
+void Graph<F,E,S>::addEdgeToTreeViews(edge_descriptor newEdge) const
 {
+    //the views are rebuilt at the end of the transaction
+    if(transaction)
+        return;
     for(TreeView* view : subscribedTreeViews)
     {
         addEdgeToTreeView(newEdge, view);
     }
 }
 
-template <class F, class E>
-void Graph<F,E>::addEdgeToTreeView(edge_descriptor newEdge, TreeView* view) const
+template <class F, class E, class S>
+void Graph<F,E,S>::addEdgeToTreeView(edge_descriptor newEdge, TreeView* view) const
 {
   
     //We only need to add the edge to the tree, if one of the two vertices is already part
@@ -786,7 +1083,7 @@ void Graph<F,E>::addEdgeToTreeView(edge_descriptor newEdge, TreeView* view) cons
         assert(false);
     }
     
-    view->addEdge(inView, notInView);
+    view->addEdge(inView, notInView, inView == src ? newEdge : findEdge(inView, notInView).first);
     
     //there might be a whole tree connected to notInView which should
     //be added to the tree
@@ -811,63 +1108,138 @@ void Graph<F,E>::addEdgeToTreeView(edge_descriptor newEdge, TreeView* view) cons
         filter.edge2 = getEdge(id2, id1);
         
         //everything in this graph will be visible except edge1 and edge2
-        boost::filtered_graph<const Graph<F,E>, EdgeFilter> fg(*this, filter);
+        boost::filtered_graph<const Graph<F,E,S>, EdgeFilter> fg(*this, filter);
         
         //use TreeBuilderVisitor to generate a new tree starting from notInView.
         //This tree will only contain vertices that are part of the sub tree that
         //below to notInView because the edges leading to inView are hidden by the filter
         //and thus the bfs will not follow those edges.
         //the visitor will add those edges directly to the view
-        TreeBuilderVisitor<Graph<F,E>> visitor(*view, *this);
+        TreeBuilderVisitor<Graph<F,E,S>> visitor(*view, *this);
         breadthFirstSearch(fg, notInView, boost::visitor(visitor));
     }
 }
 
-template <class F, class E>
-void Graph<F,E>::rebuildTreeViews() const
+template <class F, class E, class S>
+void Graph<F,E,S>::rebuildTreeViews() const
 {
     for(TreeView* view : subscribedTreeViews)
     {
+        //clear() resets the root
+        const vertex_descriptor root = view->root;
         view->clear();
-        getTree(view->root, view);
+        if(root != null_vertex())
+            getTree(root, view);
     }
 }
 
-template <class F, class E>
-typename Graph<F,E>::vertices_size_type Graph<F,E>::num_vertices() const
+template <class F, class E, class S>
+typename Graph<F,E,S>::vertices_size_type Graph<F,E,S>::num_vertices() const
 {
     return boost::num_vertices(*this);
 }
 
-template <class F, class E>
-typename Graph<F,E>::edges_size_type Graph<F,E>::num_edges() const
+template <class F, class E, class S>
+typename Graph<F,E,S>::edges_size_type Graph<F,E,S>::num_edges() const
 {
     return boost::num_edges(*this);
 }
 
-template <class F, class E>
-const E& Graph<F,E>::getEdgeProperty(const FrameId& origin, const FrameId& target) const
+template <class F, class E, class S>
+const E& Graph<F,E,S>::getEdgeProperty(const FrameId& origin, const FrameId& target) const
 {
     const edge_descriptor edge = getEdge(origin, target);
     return getEdgeProperty(edge);
 }
 
-template <class F, class E>
-const E& Graph<F,E>::getEdgeProperty(const vertex_descriptor origin, const vertex_descriptor target) const
+template <class F, class E, class S>
+const E& Graph<F,E,S>::getEdgeProperty(const vertex_descriptor origin, const vertex_descriptor target) const
 {
     const edge_descriptor edge = getEdge(origin, target);
     return getEdgeProperty(edge);
 }
 
-template <class F, class E>
-const E& Graph<F,E>::getEdgeProperty(const edge_descriptor edge) const
+template <class F, class E, class S>
+const E& Graph<F,E,S>::getEdgeProperty(const edge_descriptor edge) const
 {
   return (*this)[edge];
 }
 
+template <class F, class E, class S>
+const E& Graph<F,E,S>::operator[](const edge_descriptor edge) const
+{
+    resolveInverseEdge(edge);
+    return graph()[edge];
+}
+
+template <class F, class E, class S>
+E& Graph<F,E,S>::operator[](const edge_descriptor edge)
+{
+    resolveInverseEdge(edge);
+    return graph()[edge];
+}
+
+template <class F, class E, class S>
+void Graph<F,E,S>::enableLazyInverseEdges()
+{
+    lazyInverseEdges = true;
+}
+
+template <class F, class E, class S>
+void Graph<F,E,S>::disableLazyInverseEdges()
+{
+    resolveInverseEdges();
+    lazyInverseEdges = false;
+}
+
+template <class F, class E, class S>
+bool Graph<F,E,S>::isLazyInverseEdgesEnabled() const
+{
+    return lazyInverseEdges;
+}
+
+template <class F, class E, class S>
+void Graph<F,E,S>::resolveInverseEdges() const
+{
+    if(std::find(staleEdges.begin(), staleEdges.end(), true) == staleEdges.end())
+        return;
+    edge_iterator it, end;
+    for(boost::tie(it, end) = boost::edges(graph()); it != end; ++it)
+    {
+        resolveInverseEdge(*it);
+    }
+}
+
+template <class F, class E, class S>
+void Graph<F,E,S>::resolveInverseEdge(const edge_descriptor edge) const
+{
+    const std::size_t index = boost::get(boost::edge_index, graph(), edge);
+    if(index >= staleEdges.size() || !staleEdges[index])
+        return;
+    const EdgePair inverse = findEdge(boost::target(edge, graph()), boost::source(edge, graph()));
+    assert(inverse.second); //there should always be an inverse edge
+    //the stale property is a cache of the inverse edge, updating it does
+    //not change the logical state of the graph
+    const_cast<Graph*>(this)->graph()[edge] = graph()[inverse.first].inverse();
+    staleEdges[index] = false;
+}
+
+template <class F, class E, class S>
+void Graph<F,E,S>::setStale(const edge_descriptor edge, const bool stale)
+{
+    const std::size_t index = boost::get(boost::edge_index, graph(), edge);
+    if(index >= staleEdges.size())
+    {
+        if(!stale)
+            return;
+        staleEdges.resize(storage.edgeIndexBound(graph()), false);
+    }
+    staleEdges[index] = stale;
+}
+
 
-template <class F, class E>
-void Graph<F,E>::setEdgeProperty(const FrameId& origin,
+template <class F, class E, class S>
+void Graph<F,E,S>::setEdgeProperty(const FrameId& origin,
                                  const FrameId& target,
                                  const E& prop)
 {
@@ -876,35 +1248,229 @@ void Graph<F,E>::setEdgeProperty(const FrameId& origin,
     setEdgeProperty(originDesc, targetDesc, prop);
 }
 
-template <class F, class E>
-void Graph<F,E>::setEdgeProperty(const vertex_descriptor origin,
+template <class F, class E, class S>
+void Graph<F,E,S>::setEdgeProperty(const vertex_descriptor origin,
                                  const vertex_descriptor target,
                                  const E& prop)
 {
-    EdgePair originToTarget = boost::edge(origin, target, *this);
+    EdgePair originToTarget = findEdge(origin, target);
     
     if(!originToTarget.second)
     {
       throw UnknownEdgeException(getFrameId(origin), getFrameId(target));
     } 
-    (*this)[originToTarget.first] = prop;
     
-    EdgePair targetToOrigin = boost::edge(target, origin, *this);
+    EdgePair targetToOrigin = findEdge(target, origin);
     assert(targetToOrigin.second); //there should always be an inverse edge
-    (*this)[targetToOrigin.first] = prop.inverse();
+    updateEdgeProperty(originToTarget.first, targetToOrigin.first, prop);
+}
+
+template <class F, class E, class S>
+void Graph<F,E,S>::setEdgeProperties(const std::vector<EdgePropertyUpdate>& updates)
+{
+    if(updates.empty())
+        return;
     
-    notify(EdgeModifiedEvent(getFrameId(origin), getFrameId(target), originToTarget.first, targetToOrigin.first));
+    //(edge, inverse edge) of each update
+    std::vector<std::pair<edge_descriptor, edge_descriptor>> edges;
+    edges.reserve(updates.size());
+    for(const EdgePropertyUpdate& update : updates)
+    {
+        const EdgePair originToTarget = findEdge(update.origin, update.target);
+        if(!originToTarget.second)
+        {
+            throw UnknownEdgeException(getFrameId(update.origin), getFrameId(update.target));
+        }
+        const EdgePair targetToOrigin = findEdge(update.target, update.origin);
+        assert(targetToOrigin.second); //there should always be an inverse edge
+        edges.emplace_back(originToTarget.first, targetToOrigin.first);
+    }
+    
+    for(std::size_t i = 0; i < updates.size(); ++i)
+    {
+        writeEdgeProperty(edges[i].first, edges[i].second, updates[i].prop);
+    }
+    
+    //the event is only built if somebody receives it
+    if(!isObserved(GraphEvent::EDGES_MODIFIED))
+        return;
+    EdgesModifiedEvent event;
+    event.events.reserve(updates.size());
+    for(std::size_t i = 0; i < updates.size(); ++i)
+    {
+        event.events.emplace_back(getFrameSymbol(updates[i].origin), getFrameSymbol(updates[i].target),
+                                  edges[i].first, edges[i].second);
+    }
+    notify(event);
+}
+
+template <class F, class E, class S>
+void Graph<F,E,S>::updateEdgeProperty(const edge_descriptor originToTarget,
+                                      const edge_descriptor targetToOrigin,
+                                      const E& prop)
+{
+    writeEdgeProperty(originToTarget, targetToOrigin, prop);
+    if(!isObserved(GraphEvent::EDGE_MODIFIED))
+        return;
+    const vertex_descriptor origin = boost::source(originToTarget, graph());
+    const vertex_descriptor target = boost::target(originToTarget, graph());
+    notify(EdgeModifiedEvent(getFrameSymbol(origin), getFrameSymbol(target), originToTarget, targetToOrigin));
+}
+
+template <class F, class E, class S>
+void Graph<F,E,S>::writeEdgeProperty(const edge_descriptor originToTarget,
+                                     const edge_descriptor targetToOrigin,
+                                     const E& prop)
+{
+    if(isRecordingUndo())
+    {
+        //the inverse edge is restored by setEdgeProperty()
+        resolveInverseEdge(originToTarget);
+        const FrameId originId = getFrameId(boost::source(originToTarget, graph()));
+        const FrameId targetId = getFrameId(boost::target(originToTarget, graph()));
+        const E oldProp = graph()[originToTarget];
+        recordUndo([this, originId, targetId, oldProp]() { setEdgeProperty(originId, targetId, oldProp); });
+    }
+    graph()[originToTarget] = prop;
+    if(lazyInverseEdges)
+    {
+        setStale(originToTarget, false);
+        setStale(targetToOrigin, true);
+    }
+    else
+    {
+        graph()[targetToOrigin] = prop.inverse();
+    }
+    
+    if(transaction)
+        return;
+    const vertex_descriptor origin = boost::source(originToTarget, graph());
+    const vertex_descriptor target = boost::target(originToTarget, graph());
+    for(TreeView* view : subscribedTreeViews)
+    {
+        view->updateEdge(origin, target);
+    }
+}
+
+template <class F, class E, class S>
+void Graph<F,E,S>::beginTransaction()
+{
+    if(transaction)
+    {
+        throw TransactionException("a transaction is already active");
+    }
+    transaction.reset(new Transaction(*this));
+}
+
+template <class F, class E, class S>
+void Graph<F,E,S>::commitTransaction()
+{
+    if(!transaction)
+    {
+        throw TransactionException("there is no active transaction");
+    }
+    endTransaction();
+}
+
+template <class F, class E, class S>
+void Graph<F,E,S>::abortTransaction()
+{
+    if(!transaction)
+    {
+        throw TransactionException("there is no active transaction");
+    }
+    //the undo operations are part of the transaction. Thus their events
+    //are merged with the events that they revert.
+    transaction->rollingBack = true;
+    const std::vector<std::function<void()>>& undoLog = transaction->undoLog;
+    try
+    {
+        for(auto undo = undoLog.rbegin(); undo != undoLog.rend(); ++undo)
+        {
+            (*undo)();
+        }
+    }
+    catch(...)
+    {
+        //the graph is only partially rolled back, but it must not stay in
+        //a transaction that can neither be committed nor aborted again
+        endTransaction();
+        throw;
+    }
+    endTransaction();
+}
+
+template <class F, class E, class S>
+bool Graph<F,E,S>::isInTransaction() const
+{
+    return transaction != nullptr;
+}
+
+template <class F, class E, class S>
+void Graph<F,E,S>::endTransaction()
+{
+    //release the transaction first, modifications done by the subscribers
+    //while the events are published are not part of it
+    std::unique_ptr<Transaction> finished(std::move(transaction));
+    for(const std::pair<TreeView*, FrameId>& removedRoot : finished->removedRoots)
+    {
+        //null_vertex() if the root frame is still gone
+        removedRoot.first->root = vertex(removedRoot.second);
+    }
+    rebuildTreeViews();
+    finished->events.flush();
 }
 
-template <class F, class E>
-typename Graph<F,E>::vertex_descriptor Graph<F,E>::null_vertex()
+template <class F, class E, class S>
+void Graph<F,E,S>::notify(const GraphEvent& e)
+{
+    if(!isObserved(e.getType()))
+    {
+        //nobody would process the event, not even after the transaction
+        return;
+    }
+    if(!transaction)
+    {
+        GraphEventPublisher::notify(e);
+        return;
+    }
+    notifyPrioritized(e);
+    if(e.getType() == GraphEvent::EDGES_MODIFIED)
+    {
+        //the queue only merges single edge events
+        for(const EdgeModifiedEvent& event : static_cast<const EdgesModifiedEvent&>(e).events)
+        {
+            transaction->events.notifyGraphEvent(event);
+        }
+    }
+    else
+    {
+        transaction->events.notifyGraphEvent(e);
+    }
+}
+
+template <class F, class E, class S>
+bool Graph<F,E,S>::isRecordingUndo() const
+{
+    return transaction && !transaction->rollingBack;
+}
+
+template <class F, class E, class S>
+void Graph<F,E,S>::recordUndo(std::function<void()> undo)
+{
+    assert(isRecordingUndo());
+    transaction->undoLog.push_back(std::move(undo));
+}
+
+template <class F, class E, class S>
+typename Graph<F,E,S>::vertex_descriptor Graph<F,E,S>::null_vertex()
 {
     return GraphTraits::null_vertex();
 }
 
-template <class F, class E>
+template <class F, class E, class S>
 template <class... Args>
-typename Graph<F,E>::vertex_descriptor Graph<F,E>::emplaceFrame(const FrameId& frame,
+typename Graph<F,E,S>::vertex_descriptor Graph<F,E,S>::emplaceFrame(const FrameId& frame,
                                                                 Args&&... args)
 {
     vertex_descriptor desc = vertex(frame);
@@ -921,25 +1487,25 @@ typename Graph<F,E>::vertex_descriptor Graph<F,E>::emplaceFrame(const FrameId& f
     return desc;
 }
 
-template <class F, class E>
-const F& Graph<F,E>::getFrameProperty(const FrameId& frame) const
+template <class F, class E, class S>
+const F& Graph<F,E,S>::getFrameProperty(const FrameId& frame) const
 {
     vertex_descriptor v = getVertex(frame);
     return graph()[v];
 }
 
-template <class F, class E>
-void Graph<F,E>::publishCurrentState(GraphEventSubscriber* pSubscriber)
+template <class F, class E, class S>
+void Graph<F,E,S>::publishCurrentState(GraphEventSubscriber* pSubscriber)
 {
     // publish frames
-    typename boost::graph_traits<Graph<F,E>>::vertex_iterator vertex_it, vertex_end;
+    typename boost::graph_traits<Graph<F,E,S>>::vertex_iterator vertex_it, vertex_end;
     for (boost::tie( vertex_it, vertex_end ) = boost::vertices( graph() ); vertex_it != vertex_end; ++vertex_it)
     {
-        notifySubscriber(pSubscriber, FrameAddedEvent(getFrameId(*vertex_it)));
+        notifySubscriber(pSubscriber, FrameAddedEvent(getFrameSymbol(*vertex_it)));
     }
 
     // publish edges
-    typename boost::graph_traits<Graph<F,E>>::edge_iterator edge_it, edge_end;
+    typename boost::graph_traits<Graph<F,E,S>>::edge_iterator edge_it, edge_end;
     std::vector<edge_descriptor> published_edges;
     for (boost::tie( edge_it, edge_end ) = boost::edges( graph() ); edge_it != edge_end; ++edge_it)
     {
@@ -948,7 +1514,7 @@ void Graph<F,E>::publishCurrentState(GraphEventSubscriber* pSubscriber)
         {
             const vertex_descriptor src = getSourceVertex(*edge_it);
             const vertex_descriptor tar = getTargetVertex(*edge_it);
-            notifySubscriber(pSubscriber, EdgeAddedEvent(getFrameId(src), getFrameId(tar), *edge_it));
+            notifySubscriber(pSubscriber, EdgeAddedEvent(getFrameSymbol(src), getFrameSymbol(tar), *edge_it));
 
             // save inverse edge in order to not send it twice
             published_edges.push_back(getEdge(tar, src));
@@ -956,11 +1522,11 @@ void Graph<F,E>::publishCurrentState(GraphEventSubscriber* pSubscriber)
     }
 }
 
-template <class F, class E>
-void Graph<F,E>::unpublishCurrentState(GraphEventSubscriber* pSubscriber)
+template <class F, class E, class S>
+void Graph<F,E,S>::unpublishCurrentState(GraphEventSubscriber* pSubscriber)
 {
     // unpublish edges
-    typename boost::graph_traits<Graph<F,E>>::edge_iterator edge_it, edge_end;
+    typename boost::graph_traits<Graph<F,E,S>>::edge_iterator edge_it, edge_end;
     std::vector<edge_descriptor> unpublished_edges;
     for (boost::tie( edge_it, edge_end ) = boost::edges( graph() ); edge_it != edge_end; ++edge_it)
     {
@@ -969,7 +1535,7 @@ void Graph<F,E>::unpublishCurrentState(GraphEventSubscriber* pSubscriber)
         {
             const vertex_descriptor src = getSourceVertex(*edge_it);
             const vertex_descriptor tar = getTargetVertex(*edge_it);
-            notifySubscriber(pSubscriber, EdgeRemovedEvent(getFrameId(src), getFrameId(tar)));
+            notifySubscriber(pSubscriber, EdgeRemovedEvent(getFrameSymbol(src), getFrameSymbol(tar)));
 
             // save inverse edge in order to not send it twice
             unpublished_edges.push_back(getEdge(tar, src));
@@ -977,89 +1543,121 @@ void Graph<F,E>::unpublishCurrentState(GraphEventSubscriber* pSubscriber)
     }
 
     // unpublish frames
-    typename boost::graph_traits<Graph<F,E>>::vertex_iterator vertex_it, vertex_end;
+    typename boost::graph_traits<Graph<F,E,S>>::vertex_iterator vertex_it, vertex_end;
     for (boost::tie( vertex_it, vertex_end ) = boost::vertices( graph() ); vertex_it != vertex_end; ++vertex_it)
     {
-        notifySubscriber(pSubscriber, FrameRemovedEvent(getFrameId(*vertex_it)));
+        notifySubscriber(pSubscriber, FrameRemovedEvent(getFrameSymbol(*vertex_it)));
     }
 }
 
-template<class F, class E>
+template <class F, class E, class S>
 template <typename Archive>
-void Graph<F,E>::load(Archive &ar, const unsigned int version)
+void Graph<F,E,S>::load(Archive &ar, const unsigned int version)
 {
     ar >> boost::serialization::make_nvp("directed_graph",  graph());
 
     // regenerate mapping of the labeled graph
     regenerateLabelMap();
+    
+    if(pathRegistry)
+        pathRegistry->invalidateAll();
 }
 
-template<class F, class E>
+template <class F, class E, class S>
 template <typename Archive>
-void Graph<F,E>::save(Archive &ar, const unsigned int version) const
+void Graph<F,E,S>::save(Archive &ar, const unsigned int version) const
 {
+    resolveInverseEdges();
     ar << boost::serialization::make_nvp("directed_graph", graph());
 }
 
-template<class F, class E>
+template <class F, class E, class S>
 template <typename Archive>
-void Graph<F,E>::serialize(Archive &ar, const unsigned int version)
+void Graph<F,E,S>::serialize(Archive &ar, const unsigned int version)
 {
     boost::serialization::split_member(ar, *this, version);
 }
 
-template<class F, class E>
-std::pair<typename Graph<F,E>::vertex_iterator, typename Graph<F,E>::vertex_iterator>
-Graph<F,E>::getVertices() const
+template <class F, class E, class S>
+std::pair<typename Graph<F,E,S>::vertex_iterator, typename Graph<F,E,S>::vertex_iterator>
+Graph<F,E,S>::getVertices() const
 {
   return boost::vertices(*this);
 }
 
-template<class F, class E>
-bool Graph<F,E>::containsFrame(const FrameId& frameId) const
+template <class F, class E, class S>
+bool Graph<F,E,S>::containsFrame(const FrameId& frameId) const
 {
     const vertex_descriptor v = Base::vertex(frameId);
     return v != null_vertex();
 }
 
-template<class F, class E>
-void Graph<F,E>::regenerateLabelMap()
+template <class F, class E, class S>
+void Graph<F,E,S>::regenerateLabelMap()
 {
-    typename boost::graph_traits<Graph<F,E>>::vertex_iterator it, end;
+    //the vertex indices are used to index the TraversalWorkspace. They might
+    //have been copied from a different graph and need to be renumbered.
+    graph().renumber_indices();
+    staleEdges.clear();
+
+    storage.rebuild(graph());
+
+    frameSymbols.assign(storage.vertexIndexBound(graph()), FrameSymbol());
+    typename boost::graph_traits<Graph<F,E,S>>::vertex_iterator it, end;
     for (boost::tie( it, end ) = boost::vertices( graph()); it != end; ++it)
     {
-        const FrameId id = getFrameId(*it);
+        const FrameId& id = getFrameId(*it);
         _map[id] = *it;
+        frameSymbols[boost::get(boost::vertex_index, graph(), *it)] = id;
     }
 }
 
-template<class F, class E>
-std::pair<typename Graph<F,E>::edge_iterator, typename Graph<F,E>::edge_iterator>
-Graph<F,E>::getEdges() const
+template <class F, class E, class S>
+std::pair<typename Graph<F,E,S>::edge_iterator, typename Graph<F,E,S>::edge_iterator>
+Graph<F,E,S>::getEdges() const
 {
     return boost::edges(graph());
 }
 
-template<class F, class E>
-bool Graph<F,E>::containsEdge(const FrameId& origin, const FrameId& target) const
+template <class F, class E, class S>
+bool Graph<F,E,S>::containsEdge(const FrameId& origin, const FrameId& target) const
 {
     return containsEdge(getVertex(origin), getVertex(target));
 }
 
-template<class F, class E>
-bool Graph<F,E>::containsEdge(const vertex_descriptor origin, const vertex_descriptor target) const
+template <class F, class E, class S>
+bool Graph<F,E,S>::containsEdge(const vertex_descriptor origin, const vertex_descriptor target) const
 {
-    EdgePair e = boost::edge(origin, target, graph());
+    EdgePair e = findEdge(origin, target);
     return e.second;   
 }
   
-template<class F, class E>
-Path::Ptr Graph<F,E>::getPath(const FrameId& origin, const FrameId& target,
+template <class F, class E, class S>
+Path::Ptr Graph<F,E,S>::getPath(const FrameId& origin, const FrameId& target,
                                           const bool autoUpdating)
 {
     if(autoUpdating)
     {
-        return Path::Ptr(new Path(getFrames(origin, target), this));
+        const FrameSymbol originSymbol = getFrameSymbol(getVertex(origin)); //may throw
+        const FrameSymbol targetSymbol = getFrameSymbol(getVertex(target)); //may throw
+        if(!pathRegistry)
+            pathRegistry.reset(new PathRegistry(this));
+        
+        Path::Ptr path = pathRegistry->find(originSymbol, targetSymbol);
+        if(!path)
+        {
+            //concurrent readers may register the same path meanwhile
+            path = pathRegistry->findOrCreate(originSymbol, targetSymbol, getFrames(origin, target));
+        }
+        //the path may be used by concurrent readers
+        std::lock_guard<std::mutex> lock(pathRegistry->mutex);
+        //an empty path may have become possible in the meantime
+        if(path->isDirty() || path->isEmpty())
+        {
+            path->setFrames(getFrames(origin, target));
+            path->setDirty(false);
+        }
+        return path;
     }
     else
     {
@@ -1068,31 +1666,99 @@ Path::Ptr Graph<F,E>::getPath(const FrameId& origin, const FrameId& target,
 }
 
 
-template<class F, class E>
+template <class F, class E, class S>
 template<class VISITOR>
-void Graph<F,E>::breadthFirstSearch(vertex_descriptor root, VISITOR visitor) const
+void Graph<F,E,S>::breadthFirstSearch(vertex_descriptor root, VISITOR visitor) const
 {
     breadthFirstSearch(graph(), root, visitor);
 }
 
-template<class F, class E>
+template <class F, class E, class S>
 template <class GRAPH, class VISITOR>
-void Graph<F,E>::breadthFirstSearch(GRAPH& graph, const vertex_descriptor root, VISITOR visitor) const
+void Graph<F,E,S>::breadthFirstSearch(GRAPH& graph, const vertex_descriptor root, VISITOR visitor) const
 {
     // breadth first search uses a std::vector of default_color_type as default,
     // which is fine for graphs using boost::vecS. Since we are using listS,
-    // we need to provide a colormap:
-    std::unordered_map<vertex_descriptor, boost::default_color_type> colors;
-    auto colorMap = boost::make_assoc_property_map(colors);
-    // the alternative would be to provide a custom vertex_index_map which maps
-    // each vertex to an integer in [0, num_vertices(g))
+    // we need to provide a colormap. The colors and the queue are stored in a
+    // TraversalWorkspace that is indexed by the vertex_index of the
+    // directed_graph. The workspace is reused, thus searching does not
+    // allocate memory.
+    static_assert(std::is_same<typename boost::get_param_type<boost::vertex_index_t, VISITOR>::type,
+                               boost::param_not_found>::value,
+                  "breadthFirstSearch always uses the vertex_index of the graph");
+    TraversalWorkspace::Lease workspace = TraversalWorkspace::acquire();
+    workspace->reset(storage.vertexIndexBound(this->graph()));
+    auto indexMap = boost::get(boost::vertex_index, this->graph());
+    TraversalColorMap<decltype(indexMap)> colorMap(*workspace, indexMap);
+    TraversalQueue queue(*workspace);
+
+    // the named parameter overload of breadth_first_search always creates
+    // a default queue, therefore the parameters are unpacked and the
+    // explicit overload is used. A color_map or buffer passed by the
+    // caller replaces the one of the workspace.
+    boost::breadth_first_search(graph, root,
+                                boost::choose_param(boost::get_param(visitor, boost::buffer_param_t()),
+                                                    boost::ref(queue)).get(),
+                                boost::choose_param(boost::get_param(visitor, boost::graph_visitor),
+                                                    boost::make_bfs_visitor(boost::null_visitor())),
+                                boost::choose_param(boost::get_param(visitor, boost::vertex_color),
+                                                    colorMap));
+}
+
+template <class F, class E, class S>
+typename Graph<F,E,S>::EdgePair Graph<F,E,S>::findEdge(const vertex_descriptor origin,
+                                                     const vertex_descriptor target) const
+{
+    return storage.findEdge(graph(), origin, target);
+}
+
+template <class F, class E, class S>
+const S& Graph<F,E,S>::getStorage() const
+{
+    return storage;
+}
+
+template <class F, class E, class S>
+std::size_t Graph<F,E,S>::getVertexIndex(const vertex_descriptor vertex) const
+{
+    if(vertex == GraphTraits::null_vertex())
+      throw NullVertexException();
+    return boost::get(boost::vertex_index, graph(), vertex);
+}
 
-    boost::breadth_first_search(graph, root, visitor.color_map(colorMap));    
+template <class F, class E, class S>
+std::size_t Graph<F,E,S>::getVertexIndexBound() const
+{
+    return storage.vertexIndexBound(graph());
+}
+
+template <class F, class E, class S>
+VertexHandle Graph<F,E,S>::getHandle(const vertex_descriptor vertex) const
+{
+    return storage.getHandle(graph(), vertex);
+}
+
+template <class F, class E, class S>
+EdgeHandle Graph<F,E,S>::getHandle(const edge_descriptor edge) const
+{
+    return storage.getHandle(graph(), edge);
+}
+
+template <class F, class E, class S>
+typename Graph<F,E,S>::vertex_descriptor Graph<F,E,S>::resolve(const VertexHandle handle) const
+{
+    return storage.getVertex(handle);
+}
+
+template <class F, class E, class S>
+typename Graph<F,E,S>::EdgePair Graph<F,E,S>::resolve(const EdgeHandle handle) const
+{
+    return storage.getEdge(handle);
 }
 
-template<class F, class E>
+template <class F, class E, class S>
 template <class VISITOR>
-void Graph<F,E>::visitVertices(VISITOR visitor)
+void Graph<F,E,S>::visitVertices(VISITOR visitor)
 {
     auto vertices =  getVertices();
     for (auto vert = vertices.first; vert != vertices.second; ++vert){
@@ -169,24 +169,27 @@ namespace envire { namespace core
       
         static void write(const EnvireGraph& graph, std::ostream& out)
         {
+            graph.resolveInverseEdges(); //the edge writers bypass Graph::operator[]
             boost::write_graphviz(out, graph,
                     makeEnvireGraphVertexWriter(boost::get(boost::vertex_bundle, graph)),
                     makeEnvireGraphEdgeWriter(boost::get(boost::edge_bundle, graph)),
                     GraphPropWriter());       
         }
         
-        template <class FRAME_PROP>
-        static void write(const TransformGraph<FRAME_PROP>& graph, std::ostream& out)
+        template <class FRAME_PROP, class STORAGE>
+        static void write(const TransformGraph<FRAME_PROP, STORAGE>& graph, std::ostream& out)
         {
+            graph.resolveInverseEdges();
             boost::write_graphviz(out, graph,
                     makeGenericVertexWriter(boost::get(boost::vertex_bundle, graph)),
                     makeEnvireGraphEdgeWriter(boost::get(boost::edge_bundle, graph)),
                     GraphPropWriter());       
         }
         
-            template <class EDGE_PROP, class FRAME_PROP>
-        static void write(const Graph<EDGE_PROP, FRAME_PROP>& graph, std::ostream& out)
+            template <class EDGE_PROP, class FRAME_PROP, class STORAGE>
+        static void write(const Graph<EDGE_PROP, FRAME_PROP, STORAGE>& graph, std::ostream& out)
         {
+            graph.resolveInverseEdges();
             boost::write_graphviz(out, graph,
                     makeGenericVertexWriter(boost::get(boost::vertex_bundle, graph)),
                     makeGenericEdgeWriter(boost::get(boost::edge_bundle, graph)),
@@ -138,6 +138,24 @@ namespace envire { namespace core
         const std::string msg;
     };
     
+    class InvalidHandleException : public std::exception
+    {
+    public:
+        explicit InvalidHandleException() :
+          msg("The handle refers to an element that has been removed") {}
+        virtual char const * what() const throw() { return msg.c_str(); }
+        const std::string msg;
+    };
+    
+    class TransactionException : public std::exception
+    {
+    public:
+        explicit TransactionException(const std::string& reason) :
+          msg("Transaction error: " + reason) {}
+        virtual char const * what() const throw() { return msg.c_str(); }
+        const std::string msg;
+    };
+    
     
 }}
 
@@ -0,0 +1,412 @@
+//
+// Copyright (c) 2015, Deutsches Forschungszentrum für Künstliche Intelligenz GmbH.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+
+#include <envire_core/graph/GraphSnapshot.hpp>
+#include <envire_core/graph/EnvireGraph.hpp>
+#include <envire_core/graph/TraversalWorkspace.hpp>
+#include <envire_core/util/Demangle.hpp>
+
+#include <algorithm>
+#include <cassert>
+
+namespace envire { namespace core
+{
+
+GraphSnapshot::GraphSnapshot() : data(std::make_shared<Data>())
+{
+}
+
+bool GraphSnapshot::containsFrame(const FrameId& frame) const
+{
+    return data->index && data->index->frames.count(frame) > 0;
+}
+
+bool GraphSnapshot::containsEdge(const FrameId& origin, const FrameId& target) const
+{
+    const std::uint32_t originIndex = getFrameIndex(origin);
+    const std::uint32_t targetIndex = getFrameIndex(target);
+    const FrameEntry& frame = getFrame(originIndex);
+    if(!frame.adjacency)
+        return false;
+    for(const std::uint32_t edgeIndex : frame.adjacency->edges)
+    {
+        const EdgeEntry& edge = getEdge(edgeIndex);
+        if(edge.origin == targetIndex || edge.target == targetIndex)
+            return true;
+    }
+    return false;
+}
+
+std::vector<FrameId> GraphSnapshot::getFrameIds() const
+{
+    std::vector<FrameId> ids;
+    if(data->index)
+    {
+        ids.reserve(data->index->frames.size());
+        for(const auto& frame : data->index->frames)
+        {
+            ids.push_back(frame.first);
+        }
+    }
+    return ids;
+}
+
+std::size_t GraphSnapshot::num_vertices() const
+{
+    return data->numFrames;
+}
+
+std::size_t GraphSnapshot::num_edges() const
+{
+    return 2 * data->numEdges;
+}
+
+Transform GraphSnapshot::getTransform(const FrameId& origin, const FrameId& target) const
+{
+    const std::uint32_t originIndex = getFrameIndex(origin);
+    const std::uint32_t targetIndex = getFrameIndex(target);
+    if(originIndex == targetIndex)
+    {
+        return Transform(base::Position::Zero(), base::Orientation::Identity());
+    }
+
+    //breadth first search, parentIndex stores the edge that led to a frame
+    TraversalWorkspace::Lease workspace = TraversalWorkspace::acquire();
+    workspace->reset(data->frames.size() * frameChunkSize);
+    std::vector<std::uint32_t>& queue = workspace->indexQueue;
+    queue.clear();
+    queue.push_back(originIndex);
+    workspace->visit(originIndex);
+    bool found = false;
+    for(std::size_t head = 0; head < queue.size() && !found; ++head)
+    {
+        const FrameEntry& frame = getFrame(queue[head]);
+        if(!frame.adjacency)
+            continue;
+        for(const std::uint32_t edgeIndex : frame.adjacency->edges)
+        {
+            const EdgeEntry& edge = getEdge(edgeIndex);
+            const std::uint32_t next = edge.origin == queue[head] ? edge.target : edge.origin;
+            if(workspace->visit(next))
+            {
+                workspace->parentIndex[next] = edgeIndex;
+                if(next == targetIndex)
+                {
+                    found = true;
+                    break;
+                }
+                queue.push_back(next);
+            }
+        }
+    }
+    if(!found)
+    {
+        throw UnknownTransformException(origin, target);
+    }
+
+    //a direct edge keeps its time stamp like in the TransformGraph
+    const EdgeEntry& lastEdge = getEdge(workspace->parentIndex[targetIndex]);
+    if(lastEdge.origin == originIndex || lastEdge.target == originIndex)
+    {
+        return lastEdge.origin == originIndex ? lastEdge.transform : lastEdge.transform.inverse();
+    }
+
+    //walk back from the target and compose the transforms in path order
+    std::vector<std::uint32_t>& path = workspace->indexQueue;
+    path.clear();
+    for(std::uint32_t frame = targetIndex; frame != originIndex;)
+    {
+        const std::uint32_t edgeIndex = workspace->parentIndex[frame];
+        path.push_back(edgeIndex);
+        const EdgeEntry& edge = getEdge(edgeIndex);
+        frame = edge.origin == frame ? edge.target : edge.origin;
+    }
+    Transform tf(base::Position::Zero(), base::Orientation::Identity());
+    std::uint32_t from = originIndex;
+    for(auto it = path.rbegin(); it != path.rend(); ++it)
+    {
+        const EdgeEntry& edge = getEdge(*it);
+        tf.transform = tf.transform * getEdgeTransform(edge, from);
+        from = edge.origin == from ? edge.target : edge.origin;
+    }
+    return tf;
+}
+
+const Frame::ItemList& GraphSnapshot::getItems(const FrameId& frame, const std::type_index& type) const
+{
+    const FrameEntry& entry = getFrame(getFrameIndex(frame));
+    if(entry.items)
+    {
+        for(const std::shared_ptr<ItemListNode>& list : entry.items->lists)
+        {
+            if(list->type == type)
+                return list->items;
+        }
+    }
+    throw NoItemsOfTypeInFrameException(frame, demangleTypeName(type));
+}
+
+bool GraphSnapshot::containsItems(const FrameId& frame, const std::type_index& type) const
+{
+    const FrameEntry& entry = getFrame(getFrameIndex(frame));
+    if(!entry.items)
+        return false;
+    return std::any_of(entry.items->lists.begin(), entry.items->lists.end(),
+                       [&type](const std::shared_ptr<ItemListNode>& list) { return list->type == type; });
+}
+
+std::size_t GraphSnapshot::getTotalItemCount(const FrameId& frame) const
+{
+    const FrameEntry& entry = getFrame(getFrameIndex(frame));
+    std::size_t count = 0;
+    if(entry.items)
+    {
+        for(const std::shared_ptr<ItemListNode>& list : entry.items->lists)
+        {
+            count += list->items.size();
+        }
+    }
+    return count;
+}
+
+std::uint32_t GraphSnapshot::getFrameIndex(const FrameId& frame) const
+{
+    if(data->index)
+    {
+        auto it = data->index->frames.find(frame);
+        if(it != data->index->frames.end())
+            return it->second;
+    }
+    throw UnknownFrameException(frame);
+}
+
+const GraphSnapshot::FrameEntry& GraphSnapshot::getFrame(const std::uint32_t index) const
+{
+    return data->frames[index / frameChunkSize]->entries[index % frameChunkSize];
+}
+
+const GraphSnapshot::EdgeEntry& GraphSnapshot::getEdge(const std::uint32_t index) const
+{
+    return data->edges[index / edgeChunkSize]->entries[index % edgeChunkSize];
+}
+
+base::TransformWithCovariance GraphSnapshot::getEdgeTransform(const EdgeEntry& edge,
+                                                              const std::uint32_t from) const
+{
+    return edge.origin == from ? edge.transform.transform : edge.transform.transform.inverse();
+}
+
+
+GraphSnapshotBuilder::GraphSnapshotBuilder(EnvireGraph& graph) :
+    graph(graph), data(std::make_shared<Data>())
+{
+    data->version = version;
+    data->index = std::make_shared<GraphSnapshot::IndexNode>();
+    data->index->version = version;
+    //replays the current state of the graph as events
+    subscribe(&graph, true, true);
+}
+
+GraphSnapshot GraphSnapshotBuilder::snapshot()
+{
+    //everything that exists now belongs to the snapshot and is copied
+    //before it is modified
+    ++version;
+    return GraphSnapshot(data);
+}
+
+template <class NODE>
+NODE& GraphSnapshotBuilder::mutate(std::shared_ptr<NODE>& node)
+{
+    if(!node)
+    {
+        node = std::make_shared<NODE>();
+        node->version = version;
+    }
+    else if(node->version != version)
+    {
+        node = std::make_shared<NODE>(*node);
+        node->version = version;
+    }
+    return *node;
+}
+
+GraphSnapshot::FrameEntry& GraphSnapshotBuilder::mutableFrame(const std::uint32_t index)
+{
+    Data& d = mutate(data);
+    const std::size_t chunk = index / GraphSnapshot::frameChunkSize;
+    if(chunk >= d.frames.size())
+        d.frames.resize(chunk + 1);
+    return mutate(d.frames[chunk]).entries[index % GraphSnapshot::frameChunkSize];
+}
+
+GraphSnapshot::EdgeEntry& GraphSnapshotBuilder::mutableEdge(const std::uint32_t index)
+{
+    Data& d = mutate(data);
+    const std::size_t chunk = index / GraphSnapshot::edgeChunkSize;
+    if(chunk >= d.edges.size())
+        d.edges.resize(chunk + 1);
+    return mutate(d.edges[chunk]).entries[index % GraphSnapshot::edgeChunkSize];
+}
+
+std::uint32_t GraphSnapshotBuilder::getFrameIndex(const FrameSymbol& frame) const
+{
+    return frameIndex.at(frame);
+}
+
+std::uint64_t GraphSnapshotBuilder::makeEdgeKey(std::uint32_t a, std::uint32_t b)
+{
+    if(b < a)
+        std::swap(a, b);
+    return (static_cast<std::uint64_t>(a) << 32) | b;
+}
+
+void GraphSnapshotBuilder::frameAdded(const FrameAddedEvent& e)
+{
+    std::uint32_t index;
+    if(freeFrames.empty())
+    {
+        index = frameBound++;
+    }
+    else
+    {
+        index = freeFrames.back();
+        freeFrames.pop_back();
+    }
+    GraphSnapshot::FrameEntry& frame = mutableFrame(index);
+    frame.id = e.frame;
+    frame.used = true;
+    Data& d = mutate(data);
+    mutate(d.index).frames[e.frame.str()] = index;
+    frameIndex[e.frame] = index;
+    ++d.numFrames;
+}
+
+void GraphSnapshotBuilder::frameRemoved(const FrameRemovedEvent& e)
+{
+    const std::uint32_t index = getFrameIndex(e.frame);
+    mutableFrame(index) = GraphSnapshot::FrameEntry();
+    Data& d = mutate(data);
+    mutate(d.index).frames.erase(e.frame.str());
+    frameIndex.erase(e.frame);
+    --d.numFrames;
+    freeFrames.push_back(index);
+}
+
+void GraphSnapshotBuilder::edgeAdded(const EdgeAddedEvent& e)
+{
+    const std::uint32_t origin = getFrameIndex(e.origin);
+    const std::uint32_t target = getFrameIndex(e.target);
+    std::uint32_t index;
+    if(freeEdges.empty())
+    {
+        index = edgeBound++;
+    }
+    else
+    {
+        index = freeEdges.back();
+        freeEdges.pop_back();
+    }
+    GraphSnapshot::EdgeEntry& edge = mutableEdge(index);
+    edge.origin = origin;
+    edge.target = target;
+    edge.used = true;
+    edge.transform = graph.getEdgeProperty(e.edge);
+    mutate(mutableFrame(origin).adjacency).edges.push_back(index);
+    mutate(mutableFrame(target).adjacency).edges.push_back(index);
+    edgeIndex[makeEdgeKey(origin, target)] = index;
+    ++mutate(data).numEdges;
+}
+
+void GraphSnapshotBuilder::edgeModified(const EdgeModifiedEvent& e)
+{
+    const std::uint32_t origin = getFrameIndex(e.origin);
+    const std::uint32_t target = getFrameIndex(e.target);
+    GraphSnapshot::EdgeEntry& edge = mutableEdge(edgeIndex.at(makeEdgeKey(origin, target)));
+    //store the edge in the direction of the event, no inverse needed
+    edge.origin = origin;
+    edge.target = target;
+    edge.transform = graph.getEdgeProperty(e.edge);
+}
+
+void GraphSnapshotBuilder::edgeRemoved(const EdgeRemovedEvent& e)
+{
+    const std::uint32_t origin = getFrameIndex(e.origin);
+    const std::uint32_t target = getFrameIndex(e.target);
+    auto it = edgeIndex.find(makeEdgeKey(origin, target));
+    assert(it != edgeIndex.end());
+    const std::uint32_t index = it->second;
+    edgeIndex.erase(it);
+    removeFromAdjacency(origin, index);
+    removeFromAdjacency(target, index);
+    mutableEdge(index) = GraphSnapshot::EdgeEntry();
+    --mutate(data).numEdges;
+    freeEdges.push_back(index);
+}
+
+void GraphSnapshotBuilder::removeFromAdjacency(const std::uint32_t frame, const std::uint32_t edge)
+{
+    std::vector<std::uint32_t>& edges = mutate(mutableFrame(frame).adjacency).edges;
+    edges.erase(std::find(edges.begin(), edges.end(), edge));
+}
+
+void GraphSnapshotBuilder::itemAdded(const ItemAddedEvent& e)
+{
+    GraphSnapshot::ItemsNode& items = mutate(mutableFrame(getFrameIndex(e.frame)).items);
+    const std::type_index type = e.item->getTypeIndex();
+    for(std::shared_ptr<GraphSnapshot::ItemListNode>& list : items.lists)
+    {
+        if(list->type == type)
+        {
+            mutate(list).items.push_back(e.item);
+            return;
+        }
+    }
+    items.lists.push_back(std::make_shared<GraphSnapshot::ItemListNode>(type));
+    items.lists.back()->version = version;
+    items.lists.back()->items.push_back(e.item);
+}
+
+void GraphSnapshotBuilder::itemRemoved(const ItemRemovedEvent& e)
+{
+    GraphSnapshot::ItemsNode& items = mutate(mutableFrame(getFrameIndex(e.frame)).items);
+    const std::type_index type = e.item->getTypeIndex();
+    for(auto list = items.lists.begin(); list != items.lists.end(); ++list)
+    {
+        if((*list)->type == type)
+        {
+            Frame::ItemList& listItems = mutate(*list).items;
+            listItems.erase(std::remove(listItems.begin(), listItems.end(), e.item), listItems.end());
+            //like in the Frame there are no empty lists
+            if(listItems.empty())
+                items.lists.erase(list);
+            return;
+        }
+    }
+}
+
+}}
@@ -0,0 +1,251 @@
+//
+// Copyright (c) 2015, Deutsches Forschungszentrum für Künstliche Intelligenz GmbH.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+
+#pragma once
+
+#include <envire_core/items/Frame.hpp>
+#include <envire_core/items/Transform.hpp>
+#include <envire_core/events/GraphEventDispatcher.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <typeindex>
+#include <unordered_map>
+#include <vector>
+
+namespace envire { namespace core
+{
+    class EnvireGraph;
+    class GraphSnapshotBuilder;
+
+    /**An immutable copy of the frames, transforms and items of an EnvireGraph.
+     *
+     * Snapshots are created in O(1) by a GraphSnapshotBuilder and share
+     * all data that has not been modified since with each other and with
+     * the builder. Copying a snapshot is O(1) as well.
+     *
+     * A snapshot never changes, thus any number of threads can query it
+     * without locking while the graph is modified.
+     * @note The items are shared with the graph, only the item lists are
+     *       part of the snapshot. Modifying the content of an item is
+     *       visible in all snapshots. */
+    class GraphSnapshot
+    {
+    public:
+        /**Creates an empty snapshot */
+        GraphSnapshot();
+
+        /** @return true if the snapshot contains a frame with id @p frame */
+        bool containsFrame(const FrameId& frame) const;
+
+        /** @return true if there is a direct edge between @p origin and @p target
+         *  @throw UnknownFrameException if one of the frames does not exist */
+        bool containsEdge(const FrameId& origin, const FrameId& target) const;
+
+        /** @return the ids of all frames in no particular order */
+        std::vector<FrameId> getFrameIds() const;
+
+        /** @return number of frames in this snapshot */
+        std::size_t num_vertices() const;
+
+        /** @return number of edges in this snapshot. Like in the Graph each
+         *          transform counts as two edges.*/
+        std::size_t num_edges() const;
+
+        /** @return the transform between @p origin and @p target. Behaves
+         *          like TransformGraph::getTransform().
+         *  @throw UnknownFrameException if one of the frames does not exist
+         *  @throw UnknownTransformException if there is no path between them */
+        Transform getTransform(const FrameId& origin, const FrameId& target) const;
+
+        /** @return the items of type @p type in @p frame
+         *  @throw UnknownFrameException if the frame does not exist
+         *  @throw NoItemsOfTypeInFrameException if there are no such items */
+        const Frame::ItemList& getItems(const FrameId& frame, const std::type_index& type) const;
+
+        /** @return true if @p frame contains items of type @p type
+         *  @throw UnknownFrameException if the frame does not exist */
+        bool containsItems(const FrameId& frame, const std::type_index& type) const;
+
+        /** @return the number of items in @p frame
+         *  @throw UnknownFrameException if the frame does not exist */
+        std::size_t getTotalItemCount(const FrameId& frame) const;
+
+    private:
+        friend class GraphSnapshotBuilder;
+
+        /**All nodes are copied on write. A node may only be modified by the
+         * builder if its version is the current version of the builder.
+         * Otherwise it is part of a snapshot and has to be copied first. */
+        struct Node
+        {
+            std::uint64_t version = 0;
+        };
+
+        struct ItemListNode : Node
+        {
+            ItemListNode() : type(typeid(void)) {}
+            explicit ItemListNode(const std::type_index& type) : type(type) {}
+            std::type_index type;
+            Frame::ItemList items;
+        };
+
+        struct ItemsNode : Node
+        {
+            std::vector<std::shared_ptr<ItemListNode>> lists;
+        };
+
+        struct AdjacencyNode : Node
+        {
+            /**Indices of the edges that are connected to the frame */
+            std::vector<std::uint32_t> edges;
+        };
+
+        struct FrameEntry
+        {
+            FrameSymbol id;
+            bool used = false;
+            std::shared_ptr<AdjacencyNode> adjacency;
+            std::shared_ptr<ItemsNode> items;
+        };
+
+        /**An edge and its inverse. transform is the transform from origin
+         * to target. */
+        struct EdgeEntry
+        {
+            std::uint32_t origin = 0;
+            std::uint32_t target = 0;
+            bool used = false;
+            Transform transform;
+        };
+
+        /**Frames and edges are stored in fixed size chunks. Modifying an
+         * entry copies only its chunk and the chunk list. Edges are a lot
+         * larger than frames, thus their chunks are smaller. */
+        static const std::size_t frameChunkSize = 64;
+        static const std::size_t edgeChunkSize = 16;
+
+        template <class ENTRY, std::size_t SIZE>
+        struct ChunkNode : Node
+        {
+            ChunkNode() : entries(SIZE) {}
+            std::vector<ENTRY> entries;
+        };
+        using FrameChunk = ChunkNode<FrameEntry, frameChunkSize>;
+        using EdgeChunk = ChunkNode<EdgeEntry, edgeChunkSize>;
+
+        struct IndexNode : Node
+        {
+            std::unordered_map<FrameId, std::uint32_t> frames;
+        };
+
+        struct Data : Node
+        {
+            std::vector<std::shared_ptr<FrameChunk>> frames;
+            std::vector<std::shared_ptr<EdgeChunk>> edges;
+            std::shared_ptr<IndexNode> index;
+            std::size_t numFrames = 0;
+            std::size_t numEdges = 0;
+        };
+
+        explicit GraphSnapshot(const std::shared_ptr<const Data>& data) : data(data) {}
+
+        /** @throw UnknownFrameException if the frame does not exist */
+        std::uint32_t getFrameIndex(const FrameId& frame) const;
+        const FrameEntry& getFrame(const std::uint32_t index) const;
+        const EdgeEntry& getEdge(const std::uint32_t index) const;
+        /** @return the transform of @p edge in the direction starting at @p from */
+        base::TransformWithCovariance getEdgeTransform(const EdgeEntry& edge, const std::uint32_t from) const;
+
+        std::shared_ptr<const Data> data;
+    };
+
+    /**Keeps an up to date copy of an EnvireGraph that snapshots can be
+     * taken of.
+     *
+     * The builder subscribes to the graph as prioritized subscriber and
+     * applies every modification to its copy. Only the parts of the copy
+     * that are shared with a snapshot are copied before they are modified.
+     * Thus keeping the copy up to date costs little more than the event
+     * itself as long as no snapshots are taken. After a snapshot has been
+     * taken the first modification of a frame or edge copies the chunk
+     * that contains it.
+     * Adding or removing frames after a snapshot copies the frame id index
+     * once, all further topology changes until the next snapshot are cheap.
+     *
+     * The builder is not thread-safe. snapshot() has to be called by the
+     * thread that modifies the graph. The snapshots can be handed to any
+     * thread, e.g. by storing them in a std::shared_ptr using std::atomic_store().
+     *
+     * Edge properties that are modified without causing an EdgeModifiedEvent
+     * (e.g. using the non-const operator[]) are not noticed. */
+    class GraphSnapshotBuilder : public GraphEventDispatcher
+    {
+    public:
+        /**Subscribes to @p graph and copies its current state */
+        explicit GraphSnapshotBuilder(EnvireGraph& graph);
+
+        /** @return an immutable snapshot of the current state of the graph. O(1) */
+        GraphSnapshot snapshot();
+
+    protected:
+        virtual void frameAdded(const FrameAddedEvent& e) override;
+        virtual void frameRemoved(const FrameRemovedEvent& e) override;
+        virtual void edgeAdded(const EdgeAddedEvent& e) override;
+        virtual void edgeModified(const EdgeModifiedEvent& e) override;
+        virtual void edgeRemoved(const EdgeRemovedEvent& e) override;
+        virtual void itemAdded(const ItemAddedEvent& e) override;
+        virtual void itemRemoved(const ItemRemovedEvent& e) override;
+
+    private:
+        using Data = GraphSnapshot::Data;
+
+        /** @return @p node, copies it first if it is part of a snapshot */
+        template <class NODE>
+        NODE& mutate(std::shared_ptr<NODE>& node);
+
+        GraphSnapshot::FrameEntry& mutableFrame(const std::uint32_t index);
+        GraphSnapshot::EdgeEntry& mutableEdge(const std::uint32_t index);
+        std::uint32_t getFrameIndex(const FrameSymbol& frame) const;
+        static std::uint64_t makeEdgeKey(std::uint32_t a, std::uint32_t b);
+        void removeFromAdjacency(const std::uint32_t frame, const std::uint32_t edge);
+
+        EnvireGraph& graph;
+        std::shared_ptr<Data> data;
+        /**Version of all nodes that have been created since the last snapshot */
+        std::uint64_t version = 1;
+        /**Unused frame and edge indices */
+        std::vector<std::uint32_t> freeFrames;
+        std::vector<std::uint32_t> freeEdges;
+        std::uint32_t frameBound = 0;
+        std::uint32_t edgeBound = 0;
+        /**Same as the index of the snapshot but without hashing strings */
+        std::unordered_map<FrameSymbol, std::uint32_t> frameIndex;
+        /**Maps both frame indices of an edge to its index */
+        std::unordered_map<std::uint64_t, std::uint32_t> edgeIndex;
+    };
+}}
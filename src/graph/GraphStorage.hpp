@@ -0,0 +1,592 @@
+//
+// Copyright (c) 2015, Deutsches Forschungszentrum für Künstliche Intelligenz GmbH.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+/**\file GraphStorage.hpp
+ *
+ * Storage policies for Graph.
+ *
+ * The boost adjacency list is always the primary storage of a Graph because
+ * its vertex_descriptors and edge_descriptors are handed out to the user.
+ * A storage policy decides how the topology is traversed and searched.
+ * Every policy has to provide:
+ *
+ *   - vertexAdded(g, v), vertexRemoved(g, v), edgeAdded(g, e), edgeRemoved(g, e)
+ *     which are called by the Graph whenever the topology changes.
+ *     vertexRemoved() and edgeRemoved() are called before the element is
+ *     removed from @p g.
+ *   - rebuild(g) which is called after the structure of @p g has been
+ *     copied or de-serialized.
+ *   - vertexIndexBound(g) and edgeIndexBound(g). All vertex_index and
+ *     edge_index values of @p g are smaller than these.
+ *   - findEdge(g, u, v) which behaves like boost::edge(u, v, g). Both
+ *     policies use an EdgeIndex, thus the lookup does not depend on the
+ *     out degree of @p u.
+ *   - forEachOutEdge(g, v, func) which calls func(edge, target) for all
+ *     out edges of @p v in the order of boost::out_edges.
+ *   - findPath(g, workspace, origin, target) which appends the shortest path
+ *     from @p origin to @p target (origin != target) to the empty
+ *     workspace.pathVertices and workspace.pathEdges and returns false if
+ *     there is none.
+ */
+#pragma once
+
+#include <envire_core/graph/GraphTypes.hpp>
+#include <envire_core/graph/TraversalWorkspace.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace envire { namespace core
+{
+    /**Maps (source, target) pairs to the edge between them.
+     * boost::edge() scans the out edges of the source, which is slow for
+     * frames with thousands of children. The index answers the same
+     * question in constant time. It is kept consistent by the storage
+     * policies. */
+    class EdgeIndex
+    {
+    public:
+        using vertex_descriptor = GraphTraits::vertex_descriptor;
+        using edge_descriptor = GraphTraits::edge_descriptor;
+        using EdgePair = std::pair<edge_descriptor, bool>;
+
+        template <class G>
+        void insert(const G& g, const edge_descriptor e)
+        {
+            edges.emplace(Key(boost::source(e, g), boost::target(e, g)), e);
+        }
+
+        template <class G>
+        void erase(const G& g, const edge_descriptor e)
+        {
+            edges.erase(Key(boost::source(e, g), boost::target(e, g)));
+        }
+
+        EdgePair find(const vertex_descriptor u, const vertex_descriptor v) const
+        {
+            const auto it = edges.find(Key(u, v));
+            if(it == edges.end())
+                return EdgePair(edge_descriptor(), false);
+            return EdgePair(it->second, true);
+        }
+
+        void clear() { edges.clear(); }
+
+        std::size_t size() const { return edges.size(); }
+
+    private:
+        using Key = std::pair<vertex_descriptor, vertex_descriptor>;
+        std::unordered_map<Key, edge_descriptor, VertexPairHash> edges;
+    };
+
+    /**Handle of a vertex in a DenseStorage.
+     * Stays safe to use after the vertex has been removed. */
+    struct VertexHandle
+    {
+        std::uint32_t slot;
+        std::uint32_t generation;
+    };
+
+    /**Handle of an edge. Supported by ListStorage and DenseStorage.
+     * Stays safe to use after the edge has been removed. */
+    struct EdgeHandle
+    {
+        std::uint32_t slot;
+        std::uint32_t generation;
+    };
+
+    /**The default storage policy.
+     * Works directly on the boost adjacency list. The directed_graph never
+     * reuses indices, thus the vertex_index and edge_index are set to slot
+     * numbers instead. Slots of removed vertices and edges are reused. */
+    class ListStorage
+    {
+    public:
+        using vertex_descriptor = GraphTraits::vertex_descriptor;
+        using edge_descriptor = GraphTraits::edge_descriptor;
+        using EdgePair = std::pair<edge_descriptor, bool>;
+
+        template <class G> void vertexAdded(G& g, const vertex_descriptor v);
+        template <class G> void vertexRemoved(G& g, const vertex_descriptor v);
+        template <class G> void edgeAdded(G& g, const edge_descriptor e);
+        template <class G> void edgeRemoved(G& g, const edge_descriptor e);
+        template <class G> void rebuild(G& g);
+
+        template <class G>
+        std::size_t vertexIndexBound(const G&) const { return vertexSlots; }
+
+        template <class G>
+        std::size_t edgeIndexBound(const G&) const { return edges.size(); }
+
+        template <class G>
+        EdgePair findEdge(const G&, const vertex_descriptor u, const vertex_descriptor v) const
+        {
+            return edgeIndex.find(u, v);
+        }
+
+        template <class G, class FUNC>
+        void forEachOutEdge(const G& g, const vertex_descriptor v, FUNC func) const
+        {
+            typename boost::graph_traits<G>::out_edge_iterator it, end;
+            for(boost::tie(it, end) = boost::out_edges(v, g); it != end; ++it)
+            {
+                func(*it, boost::target(*it, g));
+            }
+        }
+
+        template <class G>
+        bool findPath(const G& g, TraversalWorkspace& workspace,
+                      const vertex_descriptor origin, const vertex_descriptor target) const;
+
+        /** @return a handle to @p e */
+        template <class G>
+        EdgeHandle getHandle(const G& g, const edge_descriptor e) const
+        {
+            const std::uint32_t slot = boost::get(boost::edge_index, g, e);
+            return EdgeHandle{slot, edges[slot].generation};
+        }
+
+        /** @return the edge referred to by @p handle. The second element is
+         *          false if the edge has been removed.*/
+        EdgePair getEdge(const EdgeHandle handle) const
+        {
+            if(handle.slot >= edges.size() || edges[handle.slot].generation != handle.generation)
+                return EdgePair(edge_descriptor(), false);
+            return EdgePair(edges[handle.slot].edge, true);
+        }
+
+    private:
+        /**The generation is incremented when the edge is removed and when
+         * the graph is rebuilt */
+        struct EdgeSlot
+        {
+            edge_descriptor edge;
+            std::uint32_t generation = 0;
+        };
+
+        EdgeIndex edgeIndex;
+        /**Indexed by edge index */
+        std::vector<EdgeSlot> edges;
+        std::vector<std::uint32_t> freeEdges;
+        /**Vertices carry no handles, thus only the number of slots is stored */
+        std::uint32_t vertexSlots = 0;
+        std::vector<std::uint32_t> freeVertices;
+    };
+
+    /**A storage policy that mirrors the topology of the graph in contiguous
+     * arrays.
+     *
+     * Each vertex and edge occupies a slot. Slots of removed elements are
+     * reused, the vertex_index and edge_index of the directed_graph are set
+     * to the slot number. Thus the indices stay compact even if frames are
+     * added and removed frequently. Searches only touch the arrays instead
+     * of following the list nodes of the adjacency list.
+     *
+     * Each slot has a generation that is incremented when the element is
+     * removed. VertexHandle and EdgeHandle use it to detect that the element
+     * they referred to does not exist anymore. */
+    class DenseStorage
+    {
+    public:
+        using vertex_descriptor = GraphTraits::vertex_descriptor;
+        using edge_descriptor = GraphTraits::edge_descriptor;
+        using EdgePair = std::pair<edge_descriptor, bool>;
+
+        template <class G> void vertexAdded(G& g, const vertex_descriptor v);
+        template <class G> void vertexRemoved(G& g, const vertex_descriptor v);
+        template <class G> void edgeAdded(G& g, const edge_descriptor e);
+        template <class G> void edgeRemoved(G& g, const edge_descriptor e);
+        template <class G> void rebuild(G& g);
+
+        template <class G>
+        std::size_t vertexIndexBound(const G&) const { return vertices.size(); }
+
+        template <class G>
+        std::size_t edgeIndexBound(const G&) const { return edges.size(); }
+
+        template <class G>
+        EdgePair findEdge(const G& g, const vertex_descriptor u, const vertex_descriptor v) const;
+
+        template <class G, class FUNC>
+        void forEachOutEdge(const G& g, const vertex_descriptor v, FUNC func) const
+        {
+            for(const OutEdge& out : vertices[slotOf(g, v)].out)
+            {
+                func(edges[out.edge].edge, vertices[out.target].vertex);
+            }
+        }
+
+        template <class G>
+        bool findPath(const G& g, TraversalWorkspace& workspace,
+                      const vertex_descriptor origin, const vertex_descriptor target) const;
+
+        /** @return a handle to @p v */
+        template <class G>
+        VertexHandle getHandle(const G& g, const vertex_descriptor v) const
+        {
+            const std::uint32_t slot = slotOf(g, v);
+            return VertexHandle{slot, vertices[slot].generation};
+        }
+
+        /** @return a handle to @p e */
+        template <class G>
+        EdgeHandle getHandle(const G& g, const edge_descriptor e) const
+        {
+            const std::uint32_t slot = boost::get(boost::edge_index, g, e);
+            return EdgeHandle{slot, edges[slot].generation};
+        }
+
+        /** @return the vertex referred to by @p handle or
+         *          GraphTraits::null_vertex() if it has been removed. */
+        vertex_descriptor getVertex(const VertexHandle handle) const
+        {
+            if(handle.slot >= vertices.size() || vertices[handle.slot].generation != handle.generation)
+                return GraphTraits::null_vertex();
+            return vertices[handle.slot].vertex;
+        }
+
+        /** @return the edge referred to by @p handle. The second element is
+         *          false if the edge has been removed.*/
+        EdgePair getEdge(const EdgeHandle handle) const
+        {
+            if(handle.slot >= edges.size() || edges[handle.slot].generation != handle.generation)
+                return EdgePair(edge_descriptor(), false);
+            return EdgePair(edges[handle.slot].edge, true);
+        }
+
+    private:
+        struct OutEdge
+        {
+            std::uint32_t target; /**<slot of the target vertex */
+            std::uint32_t edge; /**<slot of the edge */
+        };
+
+        struct VertexSlot
+        {
+            vertex_descriptor vertex;
+            std::uint32_t generation;
+            /**In the same order as boost::out_edges */
+            std::vector<OutEdge> out;
+        };
+
+        struct EdgeSlot
+        {
+            edge_descriptor edge;
+            std::uint32_t source;
+            std::uint32_t generation;
+        };
+
+        template <class G>
+        std::uint32_t slotOf(const G& g, const vertex_descriptor v) const
+        {
+            return boost::get(boost::vertex_index, g, v);
+        }
+
+        /**Pops a slot from @p freeSlots or appends a new one to @p slots */
+        template <class SLOT>
+        static std::uint32_t allocate(std::vector<SLOT>& slots, std::vector<std::uint32_t>& freeSlots);
+
+        std::vector<VertexSlot> vertices;
+        std::vector<EdgeSlot> edges;
+        std::vector<std::uint32_t> freeVertices;
+        std::vector<std::uint32_t> freeEdges;
+        EdgeIndex edgeIndex;
+    };
+
+    template <class G>
+    void ListStorage::vertexAdded(G& g, const vertex_descriptor v)
+    {
+        std::uint32_t slot;
+        if(freeVertices.empty())
+        {
+            slot = vertexSlots++;
+        }
+        else
+        {
+            slot = freeVertices.back();
+            freeVertices.pop_back();
+        }
+        boost::put(boost::vertex_index, g, v, slot);
+    }
+
+    template <class G>
+    void ListStorage::vertexRemoved(G& g, const vertex_descriptor v)
+    {
+        freeVertices.push_back(boost::get(boost::vertex_index, g, v));
+    }
+
+    template <class G>
+    void ListStorage::edgeAdded(G& g, const edge_descriptor e)
+    {
+        edgeIndex.insert(g, e);
+        std::uint32_t slot;
+        if(freeEdges.empty())
+        {
+            slot = edges.size();
+            edges.emplace_back();
+        }
+        else
+        {
+            slot = freeEdges.back();
+            freeEdges.pop_back();
+        }
+        edges[slot].edge = e;
+        boost::put(boost::edge_index, g, e, slot);
+    }
+
+    template <class G>
+    void ListStorage::edgeRemoved(G& g, const edge_descriptor e)
+    {
+        edgeIndex.erase(g, e);
+        const std::uint32_t slot = boost::get(boost::edge_index, g, e);
+        EdgeSlot& edge = edges[slot];
+        edge.edge = edge_descriptor();
+        ++edge.generation;
+        freeEdges.push_back(slot);
+    }
+
+    template <class G>
+    void ListStorage::rebuild(G& g)
+    {
+        freeVertices.clear();
+        vertexSlots = 0;
+        typename boost::graph_traits<G>::vertex_iterator v, vEnd;
+        for(boost::tie(v, vEnd) = boost::vertices(g); v != vEnd; ++v)
+        {
+            vertexAdded(g, *v);
+        }
+        //generations are not reset, handles to the old edges stay invalid
+        freeEdges.clear();
+        for(std::uint32_t slot = edges.size(); slot > 0; --slot)
+        {
+            EdgeSlot& edge = edges[slot - 1];
+            edge.edge = edge_descriptor();
+            ++edge.generation;
+            freeEdges.push_back(slot - 1);
+        }
+        edgeIndex.clear();
+        typename boost::graph_traits<G>::edge_iterator it, end;
+        for(boost::tie(it, end) = boost::edges(g); it != end; ++it)
+        {
+            edgeAdded(g, *it);
+        }
+    }
+
+    template <class G>
+    bool ListStorage::findPath(const G& g, TraversalWorkspace& workspace,
+                               const vertex_descriptor origin,
+                               const vertex_descriptor target) const
+    {
+        std::vector<vertex_descriptor>& queue = workspace.queue;
+        auto index = boost::get(boost::vertex_index, g);
+
+        workspace.reset(vertexIndexBound(g));
+        workspace.visit(index[origin]);
+        queue.clear();
+        queue.push_back(origin);
+        for(std::size_t head = 0; head < queue.size(); ++head)
+        {
+            typename boost::graph_traits<G>::out_edge_iterator it, end;
+            for(boost::tie(it, end) = boost::out_edges(queue[head], g); it != end; ++it)
+            {
+                const vertex_descriptor next = boost::target(*it, g);
+                const std::size_t nextIndex = index[next];
+                if(!workspace.visit(nextIndex))
+                    continue; //already discovered
+                workspace.parentEdge[nextIndex] = *it;
+
+                if(next == target)
+                {
+                    //walk back to the origin
+                    vertex_descriptor current = target;
+                    workspace.pathVertices.push_back(current);
+                    while(current != origin)
+                    {
+                        const edge_descriptor e = workspace.parentEdge[index[current]];
+                        workspace.pathEdges.push_back(e);
+                        current = boost::source(e, g);
+                        workspace.pathVertices.push_back(current);
+                    }
+                    std::reverse(workspace.pathVertices.begin(), workspace.pathVertices.end());
+                    std::reverse(workspace.pathEdges.begin(), workspace.pathEdges.end());
+                    return true;
+                }
+                queue.push_back(next);
+            }
+        }
+        return false;
+    }
+
+    template <class SLOT>
+    std::uint32_t DenseStorage::allocate(std::vector<SLOT>& slots,
+                                         std::vector<std::uint32_t>& freeSlots)
+    {
+        if(freeSlots.empty())
+        {
+            slots.emplace_back();
+            slots.back().generation = 0;
+            return slots.size() - 1;
+        }
+        const std::uint32_t slot = freeSlots.back();
+        freeSlots.pop_back();
+        return slot;
+    }
+
+    template <class G>
+    void DenseStorage::vertexAdded(G& g, const vertex_descriptor v)
+    {
+        const std::uint32_t slot = allocate(vertices, freeVertices);
+        vertices[slot].vertex = v;
+        boost::put(boost::vertex_index, g, v, slot);
+    }
+
+    template <class G>
+    void DenseStorage::vertexRemoved(G& g, const vertex_descriptor v)
+    {
+        const std::uint32_t slot = slotOf(g, v);
+        VertexSlot& vertex = vertices[slot];
+        vertex.vertex = GraphTraits::null_vertex();
+        vertex.out.clear();
+        ++vertex.generation;
+        freeVertices.push_back(slot);
+    }
+
+    template <class G>
+    void DenseStorage::edgeAdded(G& g, const edge_descriptor e)
+    {
+        const std::uint32_t slot = allocate(edges, freeEdges);
+        EdgeSlot& edge = edges[slot];
+        edge.edge = e;
+        edge.source = slotOf(g, boost::source(e, g));
+        vertices[edge.source].out.push_back(OutEdge{slotOf(g, boost::target(e, g)), slot});
+        boost::put(boost::edge_index, g, e, slot);
+        edgeIndex.insert(g, e);
+    }
+
+    template <class G>
+    void DenseStorage::edgeRemoved(G& g, const edge_descriptor e)
+    {
+        const std::uint32_t slot = boost::get(boost::edge_index, g, e);
+        EdgeSlot& edge = edges[slot];
+        std::vector<OutEdge>& out = vertices[edge.source].out;
+        //keep the order of the remaining edges, it determines the search order
+        out.erase(std::find_if(out.begin(), out.end(),
+                               [slot](const OutEdge& o) {return o.edge == slot;}));
+        ++edge.generation;
+        freeEdges.push_back(slot);
+        edgeIndex.erase(g, e);
+    }
+
+    template <class G>
+    void DenseStorage::rebuild(G& g)
+    {
+        //generations are not reset, handles to the old elements stay invalid
+        freeVertices.clear();
+        for(std::uint32_t slot = vertices.size(); slot > 0; --slot)
+        {
+            VertexSlot& vertex = vertices[slot - 1];
+            vertex.vertex = GraphTraits::null_vertex();
+            vertex.out.clear();
+            ++vertex.generation;
+            freeVertices.push_back(slot - 1);
+        }
+        freeEdges.clear();
+        for(std::uint32_t slot = edges.size(); slot > 0; --slot)
+        {
+            ++edges[slot - 1].generation;
+            freeEdges.push_back(slot - 1);
+        }
+        edgeIndex.clear();
+
+        typename boost::graph_traits<G>::vertex_iterator v, vEnd;
+        for(boost::tie(v, vEnd) = boost::vertices(g); v != vEnd; ++v)
+        {
+            vertexAdded(g, *v);
+        }
+        for(boost::tie(v, vEnd) = boost::vertices(g); v != vEnd; ++v)
+        {
+            typename boost::graph_traits<G>::out_edge_iterator e, eEnd;
+            for(boost::tie(e, eEnd) = boost::out_edges(*v, g); e != eEnd; ++e)
+            {
+                edgeAdded(g, *e);
+            }
+        }
+    }
+
+    template <class G>
+    DenseStorage::EdgePair DenseStorage::findEdge(const G&, const vertex_descriptor u,
+                                                  const vertex_descriptor v) const
+    {
+        return edgeIndex.find(u, v);
+    }
+
+    template <class G>
+    bool DenseStorage::findPath(const G& g, TraversalWorkspace& workspace,
+                                const vertex_descriptor origin,
+                                const vertex_descriptor target) const
+    {
+        std::vector<std::uint32_t>& queue = workspace.indexQueue;
+        std::vector<std::uint32_t>& parent = workspace.parentIndex;
+        const std::uint32_t originSlot = slotOf(g, origin);
+        const std::uint32_t targetSlot = slotOf(g, target);
+
+        workspace.reset(vertexIndexBound(g));
+        workspace.visit(originSlot);
+        queue.clear();
+        queue.push_back(originSlot);
+        for(std::size_t head = 0; head < queue.size(); ++head)
+        {
+            for(const OutEdge& out : vertices[queue[head]].out)
+            {
+                if(!workspace.visit(out.target))
+                    continue; //already discovered
+                parent[out.target] = out.edge;
+
+                if(out.target == targetSlot)
+                {
+                    //walk back to the origin
+                    std::uint32_t current = targetSlot;
+                    workspace.pathVertices.push_back(target);
+                    while(current != originSlot)
+                    {
+                        const EdgeSlot& edge = edges[parent[current]];
+                        workspace.pathEdges.push_back(edge.edge);
+                        current = edge.source;
+                        workspace.pathVertices.push_back(vertices[current].vertex);
+                    }
+                    std::reverse(workspace.pathVertices.begin(), workspace.pathVertices.end());
+                    std::reverse(workspace.pathEdges.begin(), workspace.pathEdges.end());
+                    return true;
+                }
+                queue.push_back(out.target);
+            }
+        }
+        return false;
+    }
+}}
@@ -0,0 +1,109 @@
+//
+// Copyright (c) 2015, Deutsches Forschungszentrum für Künstliche Intelligenz GmbH.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+
+#pragma once
+
+#include <glog/logging.h>
+#include <exception>
+
+namespace envire { namespace core
+{
+    /**Scoped transaction on a Graph (see Graph::beginTransaction()).
+     * The transaction is aborted on destruction unless it has been committed.
+     * Thus the graph is rolled back if an exception is thrown while it is
+     * modified. Exceptions thrown while the destructor aborts the
+     * transaction are logged and dropped, call abort() to receive them.
+     * 
+     * @code
+     * GraphTransaction<EnvireGraph> transaction(graph);
+     * for(...)
+     *     graph.addTransform(...);
+     * transaction.commit();
+     * @endcode
+     * 
+     * @param GRAPH a Graph or one of its subclasses */
+    template <class GRAPH>
+    class GraphTransaction
+    {
+    public:
+        /**Begins a transaction on @p graph.
+         * @throw TransactionException if a transaction is already active */
+        explicit GraphTransaction(GRAPH& graph) : graph(graph), active(true)
+        {
+            graph.beginTransaction();
+        }
+        
+        GraphTransaction(const GraphTransaction&) = delete;
+        GraphTransaction& operator=(const GraphTransaction&) = delete;
+        
+        ~GraphTransaction()
+        {
+            if(active)
+            {
+                //the destructor may run during stack unwinding, it must not throw
+                try
+                {
+                    graph.abortTransaction();
+                }
+                catch(const std::exception& ex)
+                {
+                    LOG(ERROR) << "Exception while aborting a transaction: " << ex.what();
+                }
+                catch(...)
+                {
+                    LOG(ERROR) << "Unknown exception while aborting a transaction";
+                }
+            }
+        }
+        
+        /**Commits the transaction. Does nothing if the transaction has
+         * already ended. */
+        void commit()
+        {
+            if(active)
+            {
+                active = false;
+                graph.commitTransaction();
+            }
+        }
+        
+        /**Aborts the transaction. Does nothing if the transaction has
+         * already ended. */
+        void abort()
+        {
+            if(active)
+            {
+                active = false;
+                graph.abortTransaction();
+            }
+        }
+        
+    private:
+        GRAPH& graph;
+        bool active;
+    };
+}}
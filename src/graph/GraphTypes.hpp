@@ -155,8 +155,11 @@ namespace envire { namespace core
     };
                                                      
                                               
+    /**The label map is a hash map. Lookups by name only hash the name once
+     * instead of doing log(n) string comparisons.*/
     template <class FRAME_PROP, class EDGE_PROP>
-    using GraphBase = boost::labeled_graph<boost::directed_graph<FRAME_PROP, EDGE_PROP, envire::core::Environment>, FrameId>;
+    using GraphBase = boost::labeled_graph<boost::directed_graph<FRAME_PROP, EDGE_PROP, envire::core::Environment>,
+                                           FrameId, boost::hash_mapS>;
     
     
     /**A hash function for the edge_descriptor.
@@ -187,6 +190,17 @@ namespace envire { namespace core
       }
     };
 
+    // A hash function for (source, target) pairs of vertices.
+    struct VertexPairHash
+    {
+      std::size_t operator()(const std::pair<GraphTraits::vertex_descriptor, GraphTraits::vertex_descriptor>& k) const {
+        std::size_t seed = 0;
+        boost::hash_combine(seed, k.first);
+        boost::hash_combine(seed, k.second);
+        return seed;
+      }
+    };
+
 }}
 
 namespace std {
@@ -210,4 +224,15 @@ namespace std {
     }
   };
 
+  template <>
+  struct hash<std::pair<envire::core::FrameSymbol, envire::core::FrameSymbol>>
+  {
+    std::size_t operator()(const std::pair<envire::core::FrameSymbol, envire::core::FrameSymbol>& k) const
+    {
+      std::size_t hashVal = k.first.hash();
+      boost::hash_combine(hashVal, k.second.hash());
+      return hashVal;
+    }
+  };
+
 }
@@ -123,7 +123,7 @@ namespace envire { namespace core
             const typename GRAPH::vertex_descriptor source = boost::source(e, graph);
             const typename GRAPH::vertex_descriptor target = boost::target(e, graph);
 
-            view.addEdge(source, target);
+            view.addEdge(source, target, e);
         }
         
         /**This is only invoked on cross edges, not on back edges
@@ -25,34 +25,24 @@
 //
 
 #include "Path.hpp"
-#include <envire_core/events/EdgeEvents.hpp>
-#include <envire_core/events/GraphEventPublisher.hpp>
+#include <envire_core/graph/PathRegistry.hpp>
 
 
 namespace envire { namespace core
 {
   
-Path::Path(const std::vector<FrameId>& frames) : frames(frames), dirty(false), autoUpdating(false)
+Path::Path(const std::vector<FrameId>& frames) : frames(frames), registry(nullptr), dirty(false),
+  transformValid(false)
 {}
 
-Path::Path(const std::vector<FrameId>& frames, GraphEventPublisher* graph) : GraphEventDispatcher(graph),
-  frames(frames), dirty(false), autoUpdating(true)
-{
-  createEdges(frames);
-}
+Path::Path(const std::vector<FrameId>& frames, PathRegistry* registry) :
+  frames(frames), registry(registry), dirty(false), transformValid(false)
+{}
 
-void Path::edgeRemoved(const EdgeRemovedEvent& e)
+Path::~Path()
 {
-  //we only get this event if we are subscribed to a graph. I.e. the graph manages this path.
-  assert(isAutoUpdating());
-  
-  if(isDirty())
-    return;
-  
-  if(edges.find(make_pair(e.origin, e.target)) != edges.end())
-  {
-    setDirty(true);
-  }
+  if(registry != nullptr)
+    registry->remove(this);
 }
   
 const std::vector< FrameId >& Path::getFrames() const
@@ -86,39 +76,41 @@ bool Path::isEmpty() const
 
 bool Path::isAutoUpdating() const
 {
-  return autoUpdating;
+  return registry != nullptr;
 }
 
-void Path::unsubscribe()
+void Path::detach()
 {
-  envire::core::GraphEventSubscriber::unsubscribe();
-  dirty = false; //dirty can never be true when not subscribed
-  edges.clear();
-  autoUpdating = false;
+  registry = nullptr;
+  dirty = false; //dirty can never be true when not registered
+  edges.clear(); //the edges cannot be used without a graph
+  transformValid = false;
 }
 
 void Path::setDirty(const bool value)
 {
   dirty = value;
+  if(dirty)
+  {
+    edges.clear();
+    transformValid = false;
+  }
 }
 
-void Path::setFrames(const std::vector<FrameId>& frames)
+void Path::invalidateTransform()
 {
-  this->frames = frames;
-  createEdges(frames);
+  transformValid = false;
 }
 
-void Path::createEdges(const std::vector< FrameId >& frames)
+void Path::setFrames(const std::vector<FrameId>& frames)
 {
+  if(registry != nullptr)
+    registry->unindex(this);
+  this->frames = frames;
   edges.clear();
-  
-  if(frames.size() == 0) //loop below breakes for size == 0
-    return;
-  
-  for(int i = 0; i < ((int)frames.size()) - 1; ++i)
-  {
-    edges.emplace(frames[i], frames[i+1]);
-  }
+  transformValid = false;
+  if(registry != nullptr)
+    registry->index(this);
 }
 
 std::size_t Path::getSize() const
@@ -139,4 +131,4 @@ const FrameId& Path::at(const int i) const
 
 
   
-}}
\ No newline at end of file
+}}
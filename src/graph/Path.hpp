@@ -27,7 +27,7 @@
 #pragma once
 #include "GraphTypes.hpp"
 #include <envire_core/items/Transform.hpp>
-#include <envire_core/events/GraphEventDispatcher.hpp>
+#include <vector>
 #include <envire_core/graph/GraphTypes.hpp>
 #include <memory>
 
@@ -44,6 +44,8 @@ namespace envire { namespace core
   };
   
   
+  class PathRegistry;
+  
   /** Represents a path inside a Graph. I.e. a series of frames that are 
    *  connected by edges.
    *  
@@ -56,19 +58,30 @@ namespace envire { namespace core
    *  removed from the graph and mark itself as dirty. The next time a dirty path
    *  is used, it will try to update itself and find a new valid path from origin
    *  to target.
+   *  Auto updating paths are registered at the PathRegistry of the graph,
+   *  which shares them between everyone asking for the same origin and target.
+   *  TransformGraph::getTransform() repairs dirty paths and caches their
+   *  transform under the mutex of the registry. Thus several threads may
+   *  query the same path. The accessors below are not guarded, they must not
+   *  be used while another thread queries the path.
    */
-  class Path : public GraphEventDispatcher
+  class Path
   {
     //every template specialization of Graph is a friend
-    template <class FRAME_PROP, class EDGE_PROP>
+    template <class FRAME_PROP, class EDGE_PROP, class STORAGE>
     friend class Graph;
     
-    template <class FRAME_PROP>
+    template <class FRAME_PROP, class STORAGE>
     friend class TransformGraph;
     
+    friend class PathRegistry;
+    
   public:
     
     using Ptr = std::shared_ptr<Path>;
+    
+    /**Unregisters the path if it is auto updating */
+    ~Path();
       
     /**Returns the origin of this path.
      * @throw EmptyPathException if the path is empty*/
@@ -90,7 +103,7 @@ namespace envire { namespace core
     /**Returns true if the path is empty. False otherwise. */
     bool isEmpty() const;
   
-    /**Returns true if the path is subscribed to a graph and is autoupdating. False otherwise. */
+    /**Returns true if the path is registered at a graph and is autoupdating. False otherwise. */
     bool isAutoUpdating() const;
     
     /** Returns the number of frames in this path*/
@@ -107,39 +120,45 @@ namespace envire { namespace core
   protected:
     //only the graph may create paths.
     /**Creates a path containing @p frames.
-     * The path is not subscribed to any graph and does not auto update.*/
+     * The path is not registered at any graph and does not auto update.*/
     Path(const std::vector<FrameId>& frames);
     
-    /**Creates a path containing @p frames.
-     * The path is subscribed to @p graph and auto updates if the graph changes.*/
-    Path(const std::vector<FrameId>& frames, GraphEventPublisher* graph);
-    
-    /**overridden to reset pGraph when unsubscribed. Otherwise we might end up
-     * trying to update the path using a deleted graph.*/
-    virtual void unsubscribe() override;
-    
-    /**Checks whether the removed edge is part of this path, if yes dirties the path  */
-    virtual void edgeRemoved(const EdgeRemovedEvent& e) override;
+    /**Creates a path containing @p frames that is registered at
+     * @p registry and auto updates if the graph changes.
+     * Only the registry creates these paths.*/
+    Path(const std::vector<FrameId>& frames, PathRegistry* registry);
     
+    /**Marking the path as dirty drops the cached edges and transform */
     void setDirty(const bool value);
     
-    void setEdges(const std::set<GraphTraits::edge_descriptor>& edges);
+    /**Replaces the frames, drops the cached edges and transform and
+     * updates the index of the registry */
     void setFrames(const std::vector<FrameId>& frames);
     
+    /**Drops the cached transform, called if an edge on the path is modified */
+    void invalidateTransform();
+    
   private:
+    Path(const Path&) = delete;
+    Path& operator=(const Path&) = delete;
     
-    /*clear and re-create the edge set */
-    void createEdges(const std::vector<FrameId>& frames);
+    /**Called by the registry when it is destroyed, i.e. with the graph.
+     * Otherwise we might end up trying to update the path using a deleted graph.*/
+    void detach();
     
     std::vector<FrameId> frames; // Index 0 is the origin, index n the target of the path.
     
-    //all edges on the path. Used to quickly check if the path is affected when edges change.
-    //is empty when not subscribed to a graph.
-    //NOTE we can't use edge_descriptor here because it becomes invalid when the edge is removed
-    //     std::pair<FrameId, FrameId> is much slower to hash but is the only choice
-    std::unordered_set<std::pair<FrameId, FrameId>> edges;
+    /**The registry of the graph, nullptr if the path does not auto update */
+    PathRegistry* registry;
     bool dirty; //If true, some edge on the path was removed and the path needs to be re-calculated
-    bool autoUpdating;
+    
+    //Caches of TransformGraph::getTransform(). Only auto updating paths use
+    //them, because only they notice when the edges change.
+    /**The edges from frames[i] to frames[i+1]. Empty if not resolved, yet */
+    std::vector<GraphTraits::edge_descriptor> edges;
+    /**The composition of the transforms of all edges */
+    Transform transform;
+    bool transformValid;
   };
   
   
@@ -0,0 +1,159 @@
+//
+// Copyright (c) 2015, Deutsches Forschungszentrum für Künstliche Intelligenz GmbH.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+
+#include <envire_core/graph/PathRegistry.hpp>
+#include <envire_core/graph/GraphTypes.hpp>
+#include <envire_core/events/EdgeEvents.hpp>
+
+#include <algorithm>
+
+namespace envire { namespace core
+{
+
+PathRegistry::PathRegistry(GraphEventPublisher* graph)
+{
+    //removed edges make paths dirty, modified edges drop their cached transforms
+    setSubscriptionFilter(SubscriptionFilter().setEvents({GraphEvent::EDGE_REMOVED,
+                                                          GraphEvent::EDGE_MODIFIED}));
+    //prioritized: other subscribers may use the paths while handling the event
+    subscribe(graph, false, true);
+}
+
+PathRegistry::~PathRegistry()
+{
+    for(auto& entry : endpoints)
+    {
+        const_cast<Path*>(entry.first)->detach();
+    }
+}
+
+Path::Ptr PathRegistry::find(const FrameSymbol& origin, const FrameSymbol& target) const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = paths.find(FramePair(origin, target));
+    if(it == paths.end())
+        return nullptr;
+    return it->second.lock();
+}
+
+Path::Ptr PathRegistry::findOrCreate(const FrameSymbol& origin, const FrameSymbol& target,
+                                     const std::vector<FrameId>& frames)
+{
+    const FramePair key(origin, target);
+    //created before locking, the destructor of the path locks the mutex
+    Path::Ptr path(new Path(frames, this));
+    std::lock_guard<std::mutex> lock(mutex);
+    std::weak_ptr<Path>& entry = paths[key];
+    if(Path::Ptr registered = entry.lock())
+        return registered;
+
+    //an expired entry belongs to a path that is being destroyed. It is
+    //replaced, remove() only erases expired entries.
+    entry = path;
+    endpoints[path.get()] = key;
+    index(path.get());
+    return path;
+}
+
+void PathRegistry::invalidateAll()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    for(auto& entry : endpoints)
+    {
+        const_cast<Path*>(entry.first)->setDirty(true);
+    }
+}
+
+void PathRegistry::edgeRemoved(const EdgeRemovedEvent& e)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = pathsByEdge.find(makeEdgeKey(e.origin, e.target));
+    if(it == pathsByEdge.end())
+        return;
+    for(Path* path : it->second)
+    {
+        path->setDirty(true);
+    }
+}
+
+void PathRegistry::edgeModified(const EdgeModifiedEvent& e)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = pathsByEdge.find(makeEdgeKey(e.origin, e.target));
+    if(it == pathsByEdge.end())
+        return;
+    for(Path* path : it->second)
+    {
+        path->invalidateTransform();
+    }
+}
+
+void PathRegistry::index(Path* path)
+{
+    const std::vector<FrameId>& frames = path->getFrames();
+    for(std::size_t i = 1; i < frames.size(); ++i)
+    {
+        pathsByEdge[makeEdgeKey(frames[i - 1], frames[i])].push_back(path);
+    }
+}
+
+void PathRegistry::unindex(Path* path)
+{
+    const std::vector<FrameId>& frames = path->getFrames();
+    for(std::size_t i = 1; i < frames.size(); ++i)
+    {
+        auto it = pathsByEdge.find(makeEdgeKey(frames[i - 1], frames[i]));
+        if(it == pathsByEdge.end())
+            continue;
+        std::vector<Path*>& dependent = it->second;
+        dependent.erase(std::remove(dependent.begin(), dependent.end(), path), dependent.end());
+        if(dependent.empty())
+            pathsByEdge.erase(it);
+    }
+}
+
+void PathRegistry::remove(Path* path)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    unindex(path);
+    auto it = endpoints.find(path);
+    if(it == endpoints.end())
+        return;
+    //the entry may have been replaced by a new path already
+    auto entry = paths.find(it->second);
+    if(entry != paths.end() && entry->second.expired())
+        paths.erase(entry);
+    endpoints.erase(it);
+}
+
+PathRegistry::FramePair PathRegistry::makeEdgeKey(const FrameSymbol& a, const FrameSymbol& b)
+{
+    //symbols are compared by name, any consistent order would do
+    return a < b ? FramePair(a, b) : FramePair(b, a);
+}
+
+}}
@@ -0,0 +1,119 @@
+//
+// Copyright (c) 2015, Deutsches Forschungszentrum für Künstliche Intelligenz GmbH.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+
+#pragma once
+
+#include <envire_core/graph/Path.hpp>
+#include <envire_core/events/GraphEventDispatcher.hpp>
+#include <envire_core/items/FrameSymbol.hpp>
+
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace envire { namespace core
+{
+
+/**Manages the auto updating paths of a graph.
+ *
+ * Paths with the same origin and target are shared, there is at most one
+ * registered path per pair. The registry indexes the paths by the edges
+ * they cross. It is the only subscriber for all paths and when an edge is
+ * removed it marks exactly the paths that cross the edge as dirty, no
+ * matter how many paths there are. When an edge is modified, the cached
+ * transforms of the paths that cross it are dropped.
+ *
+ * The graph creates the registry together with the first auto updating
+ * path. If the registry is destroyed, the remaining paths are detached
+ * and no longer auto update.
+ *
+ * The registry and the state of its paths are guarded by a mutex. Thus
+ * several threads may call TransformGraph::getTransform() with the same
+ * shared path, although the query fills the caches of the path. Apart from
+ * that the registry is not thread-safe, like the graph. */
+class PathRegistry : public GraphEventDispatcher
+{
+public:
+    /**Creates an empty registry that is subscribed to @p graph */
+    explicit PathRegistry(GraphEventPublisher* graph);
+    virtual ~PathRegistry();
+
+    /** @return the registered path from @p origin to @p target or nullptr */
+    Path::Ptr find(const FrameSymbol& origin, const FrameSymbol& target) const;
+
+    /**Registers a new path from @p origin to @p target unless another
+     * thread did so in the meantime.
+     * @param frames the frames of the new path, may be empty if there is no path
+     * @return the registered path */
+    Path::Ptr findOrCreate(const FrameSymbol& origin, const FrameSymbol& target,
+                           const std::vector<FrameId>& frames);
+
+    /**Marks all paths as dirty, e.g. after the graph has been replaced */
+    void invalidateAll();
+
+    /** @return the number of registered paths */
+    std::size_t size() const { return endpoints.size(); }
+
+protected:
+    virtual void edgeRemoved(const EdgeRemovedEvent& e) override;
+    virtual void edgeModified(const EdgeModifiedEvent& e) override;
+
+private:
+    friend class Path;
+    template <class FRAME_PROP, class EDGE_PROP, class STORAGE>
+    friend class Graph;
+    template <class FRAME_PROP, class STORAGE>
+    friend class TransformGraph;
+
+    using FramePair = std::pair<FrameSymbol, FrameSymbol>;
+
+    /**Adds the edges of @p path to the index */
+    void index(Path* path);
+    /**Removes the edges of @p path from the index */
+    void unindex(Path* path);
+    /**Called by the destructor of @p path */
+    void remove(Path* path);
+
+    /** @return the key of the undirected edge between @p a and @p b */
+    static FramePair makeEdgeKey(const FrameSymbol& a, const FrameSymbol& b);
+
+    /**Registered paths by (origin, target). A path unregisters itself
+     * when the last user drops it. Until then its entry is expired and
+     * may be replaced by a new path. */
+    std::unordered_map<FramePair, std::weak_ptr<Path>> paths;
+    /**(origin, target) of each registered path. The frames of a path may be
+     * empty, thus they cannot be used as key. */
+    std::unordered_map<const Path*, FramePair> endpoints;
+    /**The paths that cross an edge */
+    std::unordered_map<FramePair, std::vector<Path*>> pathsByEdge;
+    /**Guards the maps above and the frames and caches of the registered
+     * paths. index() and unindex() expect it to be locked. */
+    mutable std::mutex mutex;
+};
+
+}}
@@ -0,0 +1,103 @@
+//
+// Copyright (c) 2015, Deutsches Forschungszentrum für Künstliche Intelligenz GmbH.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+#pragma once
+
+#include <envire_core/graph/GraphTypes.hpp>
+#include <envire_core/graph/TraversalWorkspace.hpp>
+#include <envire_core/graph/GraphStorage.hpp>
+
+#include <algorithm>
+#include <vector>
+
+namespace envire { namespace core
+{
+    /**Finds the shortest path (in number of edges) between two vertices.
+     *
+     * The search is a breadth first search that stops as soon as the target
+     * is discovered. In contrast to GraphBFSVisitor no exception is used to
+     * interrupt the search, thus successful queries do not pay for stack
+     * unwinding.
+     *
+     * Vertices are discovered in the same order as boost::breadth_first_search
+     * would discover them. Thus the resulting path is the same path that the
+     * GraphBFSVisitor would have found.
+     *
+     * The search state lives in a leased TraversalWorkspace. Thus repeated
+     * searches do not allocate memory once the workspace buffers have grown
+     * to the size of the graph. The results are only valid as long as the
+     * PathSearch exists.
+     *
+     * @param GRAPH should be a boost::directed_graph
+     * @param STORAGE the storage policy of the graph (see GraphStorage.hpp).
+     *                It implements the actual search and has to outlive the
+     *                PathSearch. */
+    template <class GRAPH, class STORAGE = ListStorage>
+    class PathSearch
+    {
+    public:
+        using vertex_descriptor = GraphTraits::vertex_descriptor;
+        using edge_descriptor = GraphTraits::edge_descriptor;
+
+        PathSearch(const GRAPH& graph, const STORAGE& storage) :
+            graph(graph), storage(storage), workspace(TraversalWorkspace::acquire()) {}
+
+        /**Searches for the shortest path from @p origin to @p target.
+         * @return true if a path exists. The path can be retrieved using
+         *         getVertices() and getEdges() afterwards.
+         *         If @p origin equals @p target, the path consists of
+         *         @p origin only. */
+        bool search(const vertex_descriptor origin, const vertex_descriptor target);
+
+        /** @return All vertices of the last path found, starting with origin
+         *          and ending with target. Empty if no path has been found. */
+        const std::vector<vertex_descriptor>& getVertices() const { return workspace->pathVertices; }
+
+        /** @return All edges of the last path found.
+         *          getEdges()[i] connects getVertices()[i] to getVertices()[i + 1]*/
+        const std::vector<edge_descriptor>& getEdges() const { return workspace->pathEdges; }
+
+    private:
+        const GRAPH& graph;
+        const STORAGE& storage;
+        TraversalWorkspace::Lease workspace;
+    };
+
+    template <class GRAPH, class STORAGE>
+    bool PathSearch<GRAPH, STORAGE>::search(const vertex_descriptor origin,
+                                            const vertex_descriptor target)
+    {
+        workspace->pathVertices.clear();
+        workspace->pathEdges.clear();
+
+        if(origin == target)
+        {
+            workspace->pathVertices.push_back(origin);
+            return true;
+        }
+        return storage.findPath(graph, *workspace, origin, target);
+    }
+}}
@@ -0,0 +1,130 @@
+//
+// Copyright (c) 2015, Deutsches Forschungszentrum für Künstliche Intelligenz GmbH.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+
+#include <envire_core/graph/SeqLockTransform.hpp>
+
+#include <cstring>
+
+namespace envire { namespace core
+{
+
+namespace
+{
+    std::uint64_t toWord(const double value)
+    {
+        std::uint64_t word;
+        std::memcpy(&word, &value, sizeof(word));
+        return word;
+    }
+
+    double toDouble(const std::uint64_t word)
+    {
+        double value;
+        std::memcpy(&value, &word, sizeof(value));
+        return value;
+    }
+}
+
+SeqLockTransform::SeqLockTransform() : sequence(0), valid(false)
+{
+    store(Transform());
+    valid.store(false, std::memory_order_relaxed);
+}
+
+SeqLockTransform::SeqLockTransform(const Transform& tf) : sequence(0), valid(false)
+{
+    store(tf);
+}
+
+void SeqLockTransform::store(const Transform& tf)
+{
+    //only the writer modifies sequence, a plain load is enough
+    const std::uint32_t seq = sequence.load(std::memory_order_relaxed);
+    sequence.store(seq + 1, std::memory_order_relaxed);
+    //keeps the word stores below from moving before the odd counter
+    std::atomic_thread_fence(std::memory_order_release);
+
+    std::size_t i = 0;
+    words[i++].store(static_cast<std::uint64_t>(tf.time.microseconds), std::memory_order_relaxed);
+    const base::TransformWithCovariance& t = tf.transform;
+    for(int j = 0; j < 3; ++j)
+        words[i++].store(toWord(t.translation[j]), std::memory_order_relaxed);
+    for(int j = 0; j < 4; ++j)
+        words[i++].store(toWord(t.orientation.coeffs()[j]), std::memory_order_relaxed);
+    for(int j = 0; j < 36; ++j)
+        words[i++].store(toWord(t.cov(j / 6, j % 6)), std::memory_order_relaxed);
+
+    valid.store(true, std::memory_order_relaxed);
+    sequence.store(seq + 2, std::memory_order_release);
+}
+
+void SeqLockTransform::invalidate()
+{
+    valid.store(false, std::memory_order_release);
+}
+
+bool SeqLockTransform::tryLoad(Transform& tf) const
+{
+    const std::uint32_t before = sequence.load(std::memory_order_acquire);
+    if(before & 1)
+        return false;
+
+    std::size_t i = 0;
+    tf.time = base::Time::fromMicroseconds(static_cast<int64_t>(words[i++].load(std::memory_order_relaxed)));
+    base::TransformWithCovariance& t = tf.transform;
+    for(int j = 0; j < 3; ++j)
+        t.translation[j] = toDouble(words[i++].load(std::memory_order_relaxed));
+    for(int j = 0; j < 4; ++j)
+        t.orientation.coeffs()[j] = toDouble(words[i++].load(std::memory_order_relaxed));
+    for(int j = 0; j < 36; ++j)
+        t.cov(j / 6, j % 6) = toDouble(words[i++].load(std::memory_order_relaxed));
+
+    //keeps the word loads above from moving after the second counter load
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return sequence.load(std::memory_order_relaxed) == before;
+}
+
+Transform SeqLockTransform::load() const
+{
+    Transform tf;
+    while(!tryLoad(tf))
+    {
+    }
+    return tf;
+}
+
+bool SeqLockTransform::isValid() const
+{
+    return valid.load(std::memory_order_acquire);
+}
+
+std::uint32_t SeqLockTransform::getVersion() const
+{
+    return sequence.load(std::memory_order_acquire) / 2;
+}
+
+}}
@@ -0,0 +1,217 @@
+//
+// Copyright (c) 2015, Deutsches Forschungszentrum für Künstliche Intelligenz GmbH.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+
+#pragma once
+
+#include <envire_core/items/Transform.hpp>
+#include <envire_core/events/GraphEventDispatcher.hpp>
+#include <envire_core/events/EdgeEvents.hpp>
+#include <envire_core/graph/GraphExceptions.hpp>
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace envire { namespace core
+{
+    /**A Transform that can be read by any number of threads while a single
+     * thread writes it.
+     *
+     * The transform is protected by a sequence counter. The writer makes the
+     * counter odd, writes the transform in place and makes it even again.
+     * Readers copy the transform and retry if the counter was odd or has
+     * changed meanwhile. Neither side takes a lock or does an atomic
+     * read-modify-write operation, thus readers never block the writer.
+     * The transform is stored as relaxed atomic words, thus a torn copy is
+     * never used, it is only thrown away.
+     *
+     * Only one thread may call store() and invalidate() at a time. */
+    class SeqLockTransform
+    {
+    public:
+        /**Creates an invalid transform */
+        SeqLockTransform();
+        explicit SeqLockTransform(const Transform& tf);
+        SeqLockTransform(const SeqLockTransform&) = delete;
+        SeqLockTransform& operator=(const SeqLockTransform&) = delete;
+
+        /**Writes @p tf and marks the transform valid. Must only be called
+         * by the writer thread. */
+        void store(const Transform& tf);
+
+        /**Marks the transform invalid. The last value can still be read.
+         * Must only be called by the writer thread. */
+        void invalidate();
+
+        /** @return a consistent copy of the transform. Retries until no
+         *          store() overlapped with the copy. */
+        Transform load() const;
+
+        /**Copies the transform into @p tf unless a store() overlaps.
+         * @return false if the copy was torn, @p tf is undefined in that case */
+        bool tryLoad(Transform& tf) const;
+
+        /** @return false if the transform has been invalidated, e.g. because
+         *          its edge has been removed from the graph */
+        bool isValid() const;
+
+        /** @return a version that changes with every store().
+         *  Can be used to check if the transform has changed. */
+        std::uint32_t getVersion() const;
+
+    private:
+        /**time, translation, orientation and covariance */
+        static const std::size_t numWords = 1 + 3 + 4 + 36;
+
+        std::atomic<std::uint32_t> sequence;
+        std::atomic<bool> valid;
+        std::array<std::atomic<std::uint64_t>, numWords> words;
+    };
+
+    /**Keeps SeqLockTransforms in sync with the edges of a graph.
+     *
+     * Subscribes to the graph as prioritized subscriber and stores the new
+     * transform whenever a registered edge is modified. Registered edges
+     * that are removed are invalidated. Thus the thread that modifies the
+     * graph is the single writer of all SeqLockTransforms.
+     *
+     * @param GRAPH the graph type, usually a TransformGraph */
+    template <class GRAPH>
+    class SeqLockedEdges : public GraphEventDispatcher
+    {
+    public:
+        using vertex_descriptor = GraphTraits::vertex_descriptor;
+        using edge_descriptor = GraphTraits::edge_descriptor;
+
+        /**Holds seqlocked copies of the transforms of the edges passed to
+         * add(), none at first. Subscribes to @p graph to keep them up to date. */
+        explicit SeqLockedEdges(GRAPH& graph) : graph(graph)
+        {
+            subscribe(&graph, false, true);
+        }
+
+        /**Invalidates all transforms, readers may still hold them */
+        virtual ~SeqLockedEdges()
+        {
+            clear();
+        }
+
+        /** @return the transform of the edge from @p origin to @p target.
+         *          Returns the existing one if the edge is already registered.
+         *  @throw UnknownEdgeException if the edge does not exist */
+        std::shared_ptr<const SeqLockTransform> add(const vertex_descriptor origin,
+                                                    const vertex_descriptor target)
+        {
+            const FrameSymbol originSymbol = graph.getFrameSymbol(origin);
+            const FrameSymbol targetSymbol = graph.getFrameSymbol(target);
+            for(const Entry& entry : entries)
+            {
+                if(entry.origin == originSymbol && entry.target == targetSymbol)
+                    return entry.transform;
+            }
+            const typename GRAPH::EdgePair edge = graph.findEdge(origin, target);
+            if(!edge.second)
+                throw UnknownEdgeException(graph.getFrameId(origin), graph.getFrameId(target));
+            entries.push_back(Entry{originSymbol, targetSymbol,
+                                    std::make_shared<SeqLockTransform>(graph[edge.first])});
+            return entries.back().transform;
+        }
+
+        /**Invalidates the transform of the edge from @p origin to @p target
+         * and stops updating it.
+         * @return false if the edge was not registered */
+        bool remove(const vertex_descriptor origin, const vertex_descriptor target)
+        {
+            const FrameSymbol originSymbol = graph.getFrameSymbol(origin);
+            const FrameSymbol targetSymbol = graph.getFrameSymbol(target);
+            for(std::size_t i = 0; i < entries.size(); ++i)
+            {
+                if(entries[i].origin == originSymbol && entries[i].target == targetSymbol)
+                {
+                    erase(i);
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        /**Invalidates and drops all transforms */
+        void clear()
+        {
+            for(Entry& entry : entries)
+                entry.transform->invalidate();
+            entries.clear();
+        }
+
+        std::size_t size() const { return entries.size(); }
+
+    protected:
+        virtual void edgeModified(const EdgeModifiedEvent& e) override
+        {
+            //only a few edges are registered, a linear search is faster than a map
+            for(Entry& entry : entries)
+            {
+                if(entry.origin == e.origin && entry.target == e.target)
+                    entry.transform->store(graph[e.edge]);
+                else if(entry.origin == e.target && entry.target == e.origin)
+                    entry.transform->store(graph[e.inverseEdge]);
+            }
+        }
+
+        virtual void edgeRemoved(const EdgeRemovedEvent& e) override
+        {
+            for(std::size_t i = 0; i < entries.size();)
+            {
+                if((entries[i].origin == e.origin && entries[i].target == e.target) ||
+                   (entries[i].origin == e.target && entries[i].target == e.origin))
+                    erase(i);
+                else
+                    ++i;
+            }
+        }
+
+    private:
+        struct Entry
+        {
+            FrameSymbol origin;
+            FrameSymbol target;
+            std::shared_ptr<SeqLockTransform> transform;
+        };
+
+        void erase(const std::size_t i)
+        {
+            entries[i].transform->invalidate();
+            entries[i] = entries.back();
+            entries.pop_back();
+        }
+
+        GRAPH& graph;
+        std::vector<Entry> entries;
+    };
+}}
@@ -0,0 +1,227 @@
+//
+// Copyright (c) 2015, Deutsches Forschungszentrum für Künstliche Intelligenz GmbH.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+
+#pragma once
+
+#include <envire_core/graph/GraphTypes.hpp>
+#include <envire_core/items/Transform.hpp>
+#include <envire_core/events/GraphEventDispatcher.hpp>
+#include <envire_core/events/EdgeEvents.hpp>
+
+#include <algorithm>
+#include <functional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace envire { namespace core
+{
+    /**Memoizes the results of TransformGraph::getTransform().
+     *
+     * Entries are keyed on the (origin, target) vertex pair. Each entry
+     * remembers the edges that have been composed to calculate it. The cache
+     * subscribes to the graph as prioritized subscriber and drops exactly the
+     * entries whose path crossed an edge that is modified or removed. Thus
+     * other subscribers never see outdated transforms.
+     * Adding an edge only invalidates the cache if it closes a cycle, because
+     * only then a shorter path may exist for a cached pair.
+     * Edge properties that are modified without causing an EdgeModifiedEvent
+     * (e.g. using the non-const operator[]) are not noticed.
+     *
+     * The cache is not thread-safe. If it is enabled, getTransform() must not
+     * be called concurrently.
+     *
+     * @param GRAPH the graph type, usually a TransformGraph */
+    template <class GRAPH>
+    class TransformCache : public GraphEventDispatcher
+    {
+    public:
+        using vertex_descriptor = GraphTraits::vertex_descriptor;
+        using edge_descriptor = GraphTraits::edge_descriptor;
+
+        /**Creates an empty cache that is subscribed to @p graph */
+        explicit TransformCache(GRAPH& graph) : graph(graph)
+        {
+            subscribe(&graph, false, true);
+        }
+
+        /** @return the cached transform from @p origin to @p target or
+         *          nullptr if it is not cached. Counts hits and misses.
+         *  @note the pointer is invalidated by the next modification of the
+         *        graph or the cache.*/
+        const Transform* find(const vertex_descriptor origin, const vertex_descriptor target)
+        {
+            auto it = entries.find(Key(origin, target));
+            if(it == entries.end())
+            {
+                ++misses;
+                return nullptr;
+            }
+            ++hits;
+            return &it->second.transform;
+        }
+
+        /**Caches @p tf as transform from @p origin to @p target.
+         * @param edges all edges that have been composed to calculate @p tf */
+        template <class EDGE_RANGE>
+        void insert(const vertex_descriptor origin, const vertex_descriptor target,
+                    const Transform& tf, const EDGE_RANGE& edges)
+        {
+            const Key key(origin, target);
+            auto it = entries.find(key);
+            if(it != entries.end())
+            {
+                erase(it);
+            }
+            Entry& entry = entries[key];
+            entry.transform = tf;
+            for(const edge_descriptor edge : edges)
+            {
+                const EdgeKey edgeKey = makeEdgeKey(graph.getFrameSymbol(boost::source(edge, graph)),
+                                                    graph.getFrameSymbol(boost::target(edge, graph)));
+                entry.edges.push_back(edgeKey);
+                keysByEdge[edgeKey].push_back(key);
+            }
+        }
+
+        /**Removes all entries. Does not reset the statistics */
+        void clear()
+        {
+            invalidations += entries.size();
+            entries.clear();
+            keysByEdge.clear();
+        }
+
+        /** @return the number of cached transforms */
+        std::size_t size() const { return entries.size(); }
+
+        std::size_t getHits() const { return hits; }
+        std::size_t getMisses() const { return misses; }
+        /** @return the number of entries that have been dropped because
+         *          the graph changed */
+        std::size_t getInvalidations() const { return invalidations; }
+
+        void resetStatistics()
+        {
+            hits = 0;
+            misses = 0;
+            invalidations = 0;
+        }
+
+    protected:
+        virtual void edgeAdded(const EdgeAddedEvent& e) override
+        {
+            //if one of the vertices has no other edge, no shorter path can
+            //exist between any cached pair
+            if(boost::out_degree(boost::source(e.edge, graph), graph) > 1 &&
+               boost::out_degree(boost::target(e.edge, graph), graph) > 1)
+            {
+                clear();
+            }
+        }
+
+        virtual void edgeModified(const EdgeModifiedEvent& e) override
+        {
+            invalidate(makeEdgeKey(e.origin, e.target));
+        }
+
+        virtual void edgeRemoved(const EdgeRemovedEvent& e) override
+        {
+            invalidate(makeEdgeKey(e.origin, e.target));
+        }
+
+    private:
+        using Key = std::pair<vertex_descriptor, vertex_descriptor>;
+        /**Edges are stored without direction, (a, b) and (b, a) are the same key */
+        using EdgeKey = std::pair<FrameSymbol, FrameSymbol>;
+
+        struct Entry
+        {
+            Transform transform;
+            std::vector<EdgeKey> edges;
+        };
+
+        using EntryMap = std::unordered_map<Key, Entry, VertexPairHash>;
+
+        static EdgeKey makeEdgeKey(const FrameSymbol& a, const FrameSymbol& b)
+        {
+            if(std::less<const FrameId*>()(&b.str(), &a.str()))
+                return EdgeKey(b, a);
+            return EdgeKey(a, b);
+        }
+
+        void invalidate(const EdgeKey& edge)
+        {
+            auto keys = keysByEdge.find(edge);
+            if(keys == keysByEdge.end())
+                return;
+            //erase() modifies keysByEdge, thus the keys are swapped out first
+            affected.clear();
+            affected.swap(keys->second);
+            for(const Key& key : affected)
+            {
+                auto it = entries.find(key);
+                if(it != entries.end())
+                {
+                    erase(it);
+                    ++invalidations;
+                }
+            }
+        }
+
+        /**Removes the entry and all references to it from keysByEdge */
+        void erase(typename EntryMap::iterator it)
+        {
+            for(const EdgeKey& edge : it->second.edges)
+            {
+                auto keys = keysByEdge.find(edge);
+                if(keys != keysByEdge.end())
+                {
+                    std::vector<Key>& list = keys->second;
+                    auto pos = std::find(list.begin(), list.end(), it->first);
+                    if(pos != list.end())
+                    {
+                        *pos = list.back();
+                        list.pop_back();
+                    }
+                }
+            }
+            entries.erase(it);
+        }
+
+        GRAPH& graph;
+        EntryMap entries;
+        /**Reverse index: all cached pairs whose path crosses an edge.
+         * The lists are kept when they become empty to avoid reallocation. */
+        std::unordered_map<EdgeKey, std::vector<Key>> keysByEdge;
+        /**Scratch buffer for invalidate() */
+        std::vector<Key> affected;
+        std::size_t hits = 0;
+        std::size_t misses = 0;
+        std::size_t invalidations = 0;
+    };
+}}
@@ -7,11 +7,19 @@
  */
 #pragma once
 
+#include <algorithm>
 #include <cassert>
+#include <functional>
+#include <array>
+#include <memory>
 #include <string>
+#include <vector>
 
 #include <envire_core/graph/Graph.hpp>
 #include <envire_core/graph/GraphVisitors.hpp>
+#include <envire_core/graph/PathSearch.hpp>
+#include <envire_core/graph/TransformCache.hpp>
+#include <envire_core/graph/SeqLockTransform.hpp>
 #include <envire_core/events/GraphEventPublisher.hpp>
 #include <boost_serialization/BoostTypes.hpp>
 #include <envire_core/items/Transform.hpp>
@@ -20,17 +28,44 @@
 
 namespace envire { namespace core
 {
+    /**The result of a single query of TransformGraph::getTransforms() */
+    struct TransformResult
+    {
+        enum Status
+        {
+            OK,
+            UNKNOWN_FRAME, /**<origin or target does not exist */
+            UNKNOWN_TRANSFORM /**<there is no path from origin to target */
+        };
+
+        Status status = UNKNOWN_TRANSFORM;
+        /**Only valid if status is OK */
+        Transform transform;
+
+        bool ok() const { return status == OK; }
+    };
+
+    /**Refers to a transform and its inverse in a TransformGraph.
+     * Updating a transform through a handle skips all frame and edge
+     * lookups. Handles stay safe to use after the transform has been
+     * removed, they just become invalid. */
+    struct TransformHandle
+    {
+        EdgeHandle edge;
+        EdgeHandle inverseEdge;
+    };
+
     /**
      * FIXME comment
     */
-    template <class FRAME_PROP>
+    template <class FRAME_PROP, class STORAGE = ListStorage>
     class TransformGraph :
-        public Graph<FRAME_PROP, Transform>
+        public Graph<FRAME_PROP, Transform, STORAGE>
     {
     public:
       using vertex_descriptor = GraphTraits::vertex_descriptor;
       using edge_descriptor = GraphTraits::edge_descriptor;
-      using Base = Graph<FRAME_PROP, Transform>;
+      using Base = Graph<FRAME_PROP, Transform, STORAGE>;
       using Base::num_edges;
       using Base::getFrameId;
       using Base::null_vertex;
@@ -39,6 +74,14 @@ namespace envire { namespace core
       using Base::add_edge;
       using Base::remove_edge;
       using EdgePair = typename Base::EdgePair;
+      using Cache = TransformCache<TransformGraph<FRAME_PROP, STORAGE>>;
+      using SeqLocks = SeqLockedEdges<TransformGraph<FRAME_PROP, STORAGE>>;
+      
+        TransformGraph() = default;
+        
+        /**Copies the graph. The transform cache is not copied but enabled
+         * if it is enabled in @p other. Seq-locked transforms are not copied.*/
+        TransformGraph(const TransformGraph& other);
       
 
         /** @return the transform between a and b. Calculating it if necessary.
@@ -48,7 +91,10 @@ namespace envire { namespace core
         const Transform getTransform(const vertex_descriptor origin, const vertex_descriptor target) const;
 
          /** @return the transform between a and b. Calculating it if necessary.
+         * Inside a transaction the transform cache of @p view is not used.
          * @throw UnknownTransformException if the transformation doesn't exist
+         *        or, inside a transaction, if an edge of the view between
+         *        a and b has been removed
          * @throw UnknownFrameException if the @p origin or @p target does not exist*/
         const Transform getTransform(const FrameId& origin, const FrameId& target, const TreeView &view) const;
         const Transform getTransform(const vertex_descriptor origin, const vertex_descriptor target, const TreeView &view) const;
@@ -57,10 +103,54 @@ namespace envire { namespace core
         
         /** @return the transform between path.front() and path.back().
          *          Returns Identity if path.size() <= 1.
+         *          Auto updating paths cache their edges and the composed
+         *          transform until an edge on the path is modified or removed.
+         *          Changes that bypass the events (e.g. using the non-const
+         *          operator[]) are not noticed.
          *  @throw UnknownTransformException if the edge between path[i] and path[i+1]
          *                                   does not exist.*/
         const Transform getTransform(const std::shared_ptr<Path> path) const;
         
+        /**Calculates the transforms from @p origin to all @p targets using a
+         * single breadth first search. The transforms are composed along the
+         * search tree, thus targets that share a part of their path only pay
+         * for it once. The search stops as soon as all targets have been found.
+         * @return one result per target in the order of @p targets.
+         *         Errors are reported per result instead of throwing. */
+        std::vector<TransformResult> getTransforms(const vertex_descriptor origin,
+                                                   const std::vector<vertex_descriptor>& targets) const;
+        std::vector<TransformResult> getTransforms(const FrameId& origin,
+                                                   const std::vector<FrameId>& targets) const;
+        
+        /**Calculates the transforms for a list of (origin, target) pairs.
+         * One breadth first search is done per distinct origin.
+         * @return one result per query in the order of @p queries. */
+        std::vector<TransformResult> getTransforms(const std::vector<std::pair<vertex_descriptor, vertex_descriptor>>& queries) const;
+        std::vector<TransformResult> getTransforms(const std::vector<std::pair<FrameId, FrameId>>& queries) const;
+        
+        /**Calculates the transforms from @p root to all frames that are
+         * reachable from it in a single breadth first sweep. Each transform
+         * is composed from the one of its parent, thus the sweep is linear
+         * in the number of frames.
+         * @param transforms Is resized to getVertexIndexBound() and indexed by
+         *                   getVertexIndex(). Entries of frames that cannot be
+         *                   reached from @p root are UNKNOWN_TRANSFORM. Reusing
+         *                   the same vector avoids memory allocations.
+         * @return the number of frames that have been reached, including @p root
+         * @throw UnknownFrameException if @p root does not exist */
+        std::size_t getRootTransforms(const vertex_descriptor root,
+                                      std::vector<TransformResult>& transforms) const;
+        std::size_t getRootTransforms(const FrameId& root,
+                                      std::vector<TransformResult>& transforms) const;
+        
+        /**Same as above but only follows the tree edges of @p view starting
+         * at its root. Entries of frames that are not part of the tree are
+         * UNKNOWN_TRANSFORM.
+         * Inside a transaction the edges are looked up in the graph and tree
+         * edges that have been removed are not followed.*/
+        std::size_t getRootTransforms(const TreeView& view,
+                                      std::vector<TransformResult>& transforms) const;
+        
         /**A convenience wrapper around Base::setEdgeProperty */
         void updateTransform(const vertex_descriptor origin, const vertex_descriptor target,
                              const Transform& tf);
@@ -69,6 +159,31 @@ namespace envire { namespace core
 
         void updateTranform(const edge_descriptor edge, const Transform &tf);
         
+        /**Updates the transform referred to by @p handle.
+         * Behaves like updateTransform(origin, target, tf) but does not look
+         * up any frame or edge.
+         * @throw InvalidHandleException if the transform has been removed */
+        void updateTransform(const TransformHandle& handle, const Transform& tf);
+        
+        /**Updates several transforms at once and notifies the subscribers
+         * with a single EdgesModifiedEvent. Either all or none of the
+         * transforms are updated.
+         * @throw InvalidHandleException if one of the transforms has been removed */
+        void updateTransforms(const std::vector<std::pair<TransformHandle, Transform>>& updates);
+        
+        /** @return a handle to the transform from @p origin to @p target.
+         * @throw UnknownFrameException if @p origin or @p target do not exist
+         * @throw UnknownEdgeException if there is no direct transform */
+        TransformHandle getTransformHandle(const FrameId& origin, const FrameId& target) const;
+        TransformHandle getTransformHandle(const vertex_descriptor origin, const vertex_descriptor target) const;
+        
+        /** @return false if the transform referred to by @p handle has been removed */
+        bool isValid(const TransformHandle& handle) const;
+        
+        /** @return the transform referred to by @p handle
+         *  @throw InvalidHandleException if the transform has been removed */
+        const Transform getTransform(const TransformHandle& handle) const;
+        
         /**A convenience wrapper around Base::add_edge */
         void addTransform(const vertex_descriptor origin, const vertex_descriptor target,
                           const Transform& tf);
@@ -79,8 +194,57 @@ namespace envire { namespace core
         void removeTransform(const vertex_descriptor origin, const vertex_descriptor target);
         void removeTransform(const FrameId& origin, const FrameId& target);
         
+        /**Enables memoization of getTransform(origin, target).
+         * Cached transforms are invalidated automatically when the graph changes.
+         * @see TransformCache */
+        void enableTransformCache();
+        /**Disables the transform cache and drops all cached transforms */
+        void disableTransformCache();
+        bool isTransformCacheEnabled() const;
+        /** @return the transform cache or nullptr if it is disabled */
+        const Cache* getTransformCache() const;
+        
+        /**Publishes the transform from @p origin to @p target in a
+         * SeqLockTransform. Whenever the transform is updated, the new value
+         * is stored in it. Other threads can read it without any lock while
+         * this thread keeps modifying the graph. Meant for a few edges
+         * that are updated at high rates, e.g. odometry.
+         * The SeqLockTransform is invalidated if the transform is removed.
+         * @return the existing SeqLockTransform if called twice for the same edge
+         * @throw UnknownFrameException if @p origin or @p target do not exist
+         * @throw UnknownEdgeException if there is no direct transform */
+        std::shared_ptr<const SeqLockTransform> enableSeqLock(const FrameId& origin, const FrameId& target);
+        std::shared_ptr<const SeqLockTransform> enableSeqLock(const vertex_descriptor origin,
+                                                              const vertex_descriptor target);
+        /**Stops updating and invalidates the SeqLockTransform of the transform
+         * from @p origin to @p target.
+         * @return false if no SeqLockTransform was enabled for it
+         * @throw UnknownFrameException if @p origin or @p target do not exist */
+        bool disableSeqLock(const FrameId& origin, const FrameId& target);
+        
     protected:
       using Base::graph;
+      
+      struct BatchQuery
+      {
+          vertex_descriptor origin;
+          vertex_descriptor target;
+          std::size_t result; /**<index in the result vector */
+      };
+      using BatchIterator = typename std::vector<BatchQuery>::const_iterator;
+      
+      /**Answers all queries in [begin, end). All of them have to share the
+       * same origin. */
+      void getTransforms(BatchIterator begin, BatchIterator end,
+                         std::vector<TransformResult>& results) const;
+      
+      /** @return the transform from the root of @p view to @p vertex.
+       *          Uses and fills the transform cache of the view.*/
+      base::TransformWithCovariance getRootTransform(const vertex_descriptor vertex,
+                                                     const TreeView& view) const;
+      
+      std::unique_ptr<Cache> cache;
+      std::unique_ptr<SeqLocks> seqLocks;
         
     private:
         /**Grants access to boost serialization */
@@ -91,8 +255,8 @@ namespace envire { namespace core
         void serialize(Archive &ar, const unsigned int version);
     };
     
-    template <class F>
-    const Transform TransformGraph<F>::getTransform(const vertex_descriptor originVertex,
+    template <class F, class S>
+    const Transform TransformGraph<F,S>::getTransform(const vertex_descriptor originVertex,
                                                     const vertex_descriptor targetVertex) const
     {
         if(num_edges() == 0)
@@ -100,42 +264,46 @@ namespace envire { namespace core
             throw UnknownTransformException(getFrameId(originVertex), getFrameId(targetVertex));
         }
         
+        if(cache)
+        {
+            const Transform* cached = cache->find(originVertex, targetVertex);
+            if(cached != nullptr)
+                return *cached;
+        }
+        
         //direct edges
         EdgePair pair;
-        pair = boost::edge(originVertex, targetVertex, *this);
+        pair = this->findEdge(originVertex, targetVertex);
         if(!pair.second)
         {            
             /** It is not a direct edge transformation **/
-            Transform tf(base::Position::Zero(), base::Orientation::Identity()); //start with identity transform
-            GraphBFSVisitor <vertex_descriptor>visit(targetVertex, this->graph());
-
-            try
-            {   
-                Base::breadthFirstSearch(originVertex, boost::visitor(visit));
-
-            }catch(const FoundFrameException &e)
+            PathSearch<typename Base::graph_type, S> search(graph(), this->storage);
+            if(search.search(originVertex, targetVertex))
             {
+                Transform tf(base::Position::Zero(), base::Orientation::Identity()); //start with identity transform
                 base::TransformWithCovariance &trans(tf.transform);
 
                 /** Compute the transformation **/
-                std::deque<vertex_descriptor>::iterator it = visit.tree->begin();
-                for (; (it+1) != visit.tree->end(); ++it)
+                for(const edge_descriptor edge : search.getEdges())
                 {
-                    pair = boost::edge(*it, *(it+1), graph());
-                    trans = trans * (*this)[pair.first].transform;
+                    trans = trans * (*this)[edge].transform;
                 }
+                if(cache)
+                    cache->insert(originVertex, targetVertex, tf, search.getEdges());
                 return tf;
             }
             //ending up here means, that the breadth_first_search could not find a path from origin to target
             throw UnknownTransformException(getFrameId(originVertex), getFrameId(targetVertex));
         }
 
+        if(cache)
+            cache->insert(originVertex, targetVertex, (*this)[pair.first], std::array<edge_descriptor, 1>{{pair.first}});
         return (*this)[pair.first];
     }
 
     
-  template <class F>
-  const Transform TransformGraph<F>::getTransform(const FrameId& origin, const FrameId& target) const
+  template <class F, class S>
+  const Transform TransformGraph<F,S>::getTransform(const FrameId& origin, const FrameId& target) const
   {
       const vertex_descriptor originVertex = getVertex(origin);
       const vertex_descriptor targetVertex = getVertex(target); 
@@ -145,8 +313,8 @@ namespace envire { namespace core
   }
 
   
-    template <class F>
-    const Transform TransformGraph<F>::getTransform(const vertex_descriptor originVertex,
+    template <class F, class S>
+    const Transform TransformGraph<F,S>::getTransform(const vertex_descriptor originVertex,
                                                     const vertex_descriptor targetVertex,
                                                     const TreeView &view) const
     {
@@ -156,57 +324,109 @@ namespace envire { namespace core
             return Transform(Eigen::Vector3d::Zero(), Eigen::Quaterniond::Identity());
         }
 
-        base::TransformWithCovariance origin_tf = base::TransformWithCovariance::Identity(); // An identity transformation
-
-        /** Get transformation from origin to the root **/
-        vertex_descriptor od = originVertex;
-        while(!view.isRoot(od))
+        //inside a transaction the view is out of date, its parent edges and
+        //cached transforms may refer to modified or removed edges
+        if(view.isTransformCacheEnabled() && !this->isInTransaction())
         {
-            EdgePair pair(boost::edge(od, view.getParent(od), *this));
-            if (pair.second)
-            {
-                origin_tf = origin_tf * (*this)[pair.first].transform;
-            }
-            od = view.getParent(od);
+            const base::TransformWithCovariance rootToOrigin = getRootTransform(originVertex, view);
+            const base::TransformWithCovariance rootToTarget = getRootTransform(targetVertex, view);
+            return rootToOrigin.inverse() * rootToTarget;
         }
 
+        base::TransformWithCovariance origin_tf = base::TransformWithCovariance::Identity(); // An identity transformation
         base::TransformWithCovariance target_tf = base::TransformWithCovariance::Identity(); // An identity transformation
 
-        /** Get transformation from target to the root **/
+        /** Walk both vertices up to their lowest common ancestor, always
+         *  moving the deeper one. Everything above the ancestor cancels out. **/
+        vertex_descriptor od = originVertex;
         vertex_descriptor td = targetVertex;
-        while(!view.isRoot(td))
+        const VertexRelation* originRelation = &view.getRelation(od);
+        const VertexRelation* targetRelation = &view.getRelation(td);
+        while(od != td)
         {
-            EdgePair pair;
-            pair = boost::edge(td, view.getParent(td), *this);
-            if (pair.second)
+            if(originRelation->depth >= targetRelation->depth)
+            {
+                EdgePair pair(this->findEdge(od, originRelation->parent));
+                if (!pair.second) //removed inside a transaction
+                    throw UnknownTransformException(getFrameId(originVertex), getFrameId(targetVertex));
+                origin_tf = origin_tf * (*this)[pair.first].transform;
+                od = originRelation->parent;
+                originRelation = &view.getRelation(od);
+            }
+            else
             {
+                EdgePair pair(this->findEdge(td, targetRelation->parent));
+                if (!pair.second) //removed inside a transaction
+                    throw UnknownTransformException(getFrameId(originVertex), getFrameId(targetVertex));
                 target_tf = target_tf * (*this)[pair.first].transform;
+                td = targetRelation->parent;
+                targetRelation = &view.getRelation(td);
             }
-            td = view.getParent(td);
         }
 
         return origin_tf * target_tf.inverse();
     }
     
-    template <class F>
-    const Transform TransformGraph<F>::getTransform(const std::shared_ptr<Path> path) const
+    template <class F, class S>
+    const Transform TransformGraph<F,S>::getTransform(const std::shared_ptr<Path> path) const
     {
-        if(path->getSize() <= 1)
+        if(path->isAutoUpdating())
         {
-            return Transform(base::Position::Zero(), base::Orientation::Identity());
+            //auto updating paths are shared and this query fills their
+            //caches, thus concurrent readers are serialized by the registry
+            std::lock_guard<std::mutex> lock(path->registry->mutex);
+            if(path->isDirty())
+            {
+              //NOTE this could be done in the Path but then the Path would need to know
+              //     about the graph and its template parameters...
+              path->setFrames(this->getFrames(path->getOrigin(), path->getTarget()));
+              path->setDirty(false);
+              if(path->isEmpty())
+                throw InvalidPathException();
+            }
+            if(path->getSize() <= 1)
+            {
+                return Transform(base::Position::Zero(), base::Orientation::Identity());
+            }
+            
+            //the registry of the graph keeps the caches of the path up to date
+            if(path->transformValid)
+                return path->transform;
+            if(path->edges.empty())
+            {
+                path->edges.reserve(path->getSize() - 1);
+                vertex_descriptor origin = getVertex((*path)[0]);
+                for(size_t i = 1; i < path->getSize(); ++i)
+                {
+                    const vertex_descriptor target = getVertex((*path)[i]);
+                    const EdgePair edge = this->findEdge(origin, target);
+                    if(!edge.second)
+                    {
+                        path->edges.clear();
+                        throw UnknownTransformException((*path)[i - 1], (*path)[i]);
+                    }
+                    path->edges.push_back(edge.first);
+                    origin = target;
+                }
+            }
+            
+            Transform tf = (*this)[path->edges[0]];
+            base::TransformWithCovariance &trans(tf.transform);
+            for(size_t i = 1; i < path->edges.size(); ++i)
+            {
+                trans = trans * (*this)[path->edges[i]].transform;
+            }
+            path->transform = tf;
+            path->transformValid = true;
+            return tf;
         }
         
-        if(path->isDirty())
+        //paths that do not auto update are never dirty and have no caches
+        if(path->getSize() <= 1)
         {
-          //NOTE this could be done in the Path but then the Path would need to know
-          //     about the graph and its template parameters...
-          path->setFrames(this->getFrames(path->getOrigin(), path->getTarget()));
-          path->setDirty(false);
-          if(path->isEmpty())
-            throw InvalidPathException();
+            return Transform(base::Position::Zero(), base::Orientation::Identity());
         }
         
-        
         Transform tf = getTransform((*path)[0], (*path)[1]);
         base::TransformWithCovariance &trans(tf.transform);
         for(size_t i = 1; i < path->getSize() - 1; ++i)
@@ -218,37 +438,37 @@ namespace envire { namespace core
         return tf; 
     }
 
-    template <class F>
-    const Transform TransformGraph<F>::getTransform(const FrameId& origin, const FrameId& target, const TreeView &view) const
+    template <class F, class S>
+    const Transform TransformGraph<F,S>::getTransform(const FrameId& origin, const FrameId& target, const TreeView &view) const
     {
         const vertex_descriptor originVertex = getVertex(origin);//will throw
         const vertex_descriptor targetVertex = getVertex(target); //will throw
         return getTransform(originVertex, targetVertex, view);
     }
 
-    template <class F>
-    const Transform TransformGraph<F>::getTransform(edge_descriptor edge) const
+    template <class F, class S>
+    const Transform TransformGraph<F,S>::getTransform(edge_descriptor edge) const
     {
         return (*this)[edge].transform;
     }
 
-    template <class F>
-    void TransformGraph<F>::updateTransform(const vertex_descriptor origin,
+    template <class F, class S>
+    void TransformGraph<F,S>::updateTransform(const vertex_descriptor origin,
                                             const vertex_descriptor target,
                                             const Transform& tf)
     {
         setEdgeProperty(origin, target, tf);
     }
     
-    template <class F>
-    void TransformGraph<F>::updateTransform(const FrameId& origin, const FrameId& target, 
+    template <class F, class S>
+    void TransformGraph<F,S>::updateTransform(const FrameId& origin, const FrameId& target, 
                                             const Transform& tf)
     {
         setEdgeProperty(origin, target, tf);
     }
 
-    template <class F>
-    void TransformGraph<F>::updateTranform(const edge_descriptor edge, const Transform &tf)
+    template <class F, class S>
+    void TransformGraph<F,S>::updateTranform(const edge_descriptor edge, const Transform &tf)
     {
         vertex_descriptor source_vertex = this->getSourceVertex(edge);
         vertex_descriptor target_vertex = this->getTargetVertex(edge);
@@ -256,38 +476,474 @@ namespace envire { namespace core
         updateTranform(source_vertex, target_vertex, tf);
     }
     
-    template <class F>
-    void TransformGraph<F>::addTransform(const vertex_descriptor origin,
+    template <class F, class S>
+    void TransformGraph<F,S>::updateTransform(const TransformHandle& handle, const Transform& tf)
+    {
+        const EdgePair edge = this->resolve(handle.edge);
+        const EdgePair inverseEdge = this->resolve(handle.inverseEdge);
+        if(!edge.second || !inverseEdge.second)
+            throw InvalidHandleException();
+        this->updateEdgeProperty(edge.first, inverseEdge.first, tf);
+    }
+    
+    template <class F, class S>
+    void TransformGraph<F,S>::updateTransforms(const std::vector<std::pair<TransformHandle, Transform>>& updates)
+    {
+        if(updates.empty())
+            return;
+        
+        //(edge, inverse edge) of each update
+        std::vector<std::pair<edge_descriptor, edge_descriptor>> edges;
+        edges.reserve(updates.size());
+        for(const std::pair<TransformHandle, Transform>& update : updates)
+        {
+            const EdgePair edge = this->resolve(update.first.edge);
+            const EdgePair inverseEdge = this->resolve(update.first.inverseEdge);
+            if(!edge.second || !inverseEdge.second)
+                throw InvalidHandleException();
+            edges.emplace_back(edge.first, inverseEdge.first);
+        }
+        
+        for(std::size_t i = 0; i < updates.size(); ++i)
+        {
+            this->writeEdgeProperty(edges[i].first, edges[i].second, updates[i].second);
+        }
+        
+        //the event is only built if somebody receives it
+        if(!this->isObserved(GraphEvent::EDGES_MODIFIED))
+            return;
+        EdgesModifiedEvent event;
+        event.events.reserve(updates.size());
+        for(const std::pair<edge_descriptor, edge_descriptor>& edge : edges)
+        {
+            event.events.emplace_back(this->getFrameSymbol(this->getSourceVertex(edge.first)),
+                                      this->getFrameSymbol(this->getTargetVertex(edge.first)),
+                                      edge.first, edge.second);
+        }
+        this->notify(event);
+    }
+    
+    template <class F, class S>
+    TransformHandle TransformGraph<F,S>::getTransformHandle(const FrameId& origin, const FrameId& target) const
+    {
+        return getTransformHandle(getVertex(origin), getVertex(target)); //will throw
+    }
+    
+    template <class F, class S>
+    TransformHandle TransformGraph<F,S>::getTransformHandle(const vertex_descriptor origin,
+                                                            const vertex_descriptor target) const
+    {
+        const EdgePair edge = this->findEdge(origin, target);
+        if(!edge.second)
+            throw UnknownEdgeException(getFrameId(origin), getFrameId(target));
+        const EdgePair inverseEdge = this->findEdge(target, origin);
+        assert(inverseEdge.second); //there should always be an inverse edge
+        return TransformHandle{this->getHandle(edge.first), this->getHandle(inverseEdge.first)};
+    }
+    
+    template <class F, class S>
+    bool TransformGraph<F,S>::isValid(const TransformHandle& handle) const
+    {
+        return this->resolve(handle.edge).second && this->resolve(handle.inverseEdge).second;
+    }
+    
+    template <class F, class S>
+    const Transform TransformGraph<F,S>::getTransform(const TransformHandle& handle) const
+    {
+        const EdgePair edge = this->resolve(handle.edge);
+        if(!edge.second)
+            throw InvalidHandleException();
+        return (*this)[edge.first];
+    }
+    
+    template <class F, class S>
+    void TransformGraph<F,S>::addTransform(const vertex_descriptor origin,
                                          const vertex_descriptor target,
                                          const Transform& tf)
     {
         add_edge(origin, target, tf);
     }
-    template <class F>
-    void TransformGraph<F>::addTransform(const FrameId& origin,
+    template <class F, class S>
+    void TransformGraph<F,S>::addTransform(const FrameId& origin,
                                          const FrameId& target,
                                          const Transform& tf)
     {
         add_edge(origin, target, tf);
     }
     
-    template <class F>
-    void TransformGraph<F>::removeTransform(const vertex_descriptor origin, const vertex_descriptor target)
+    template <class F, class S>
+    void TransformGraph<F,S>::removeTransform(const vertex_descriptor origin, const vertex_descriptor target)
     {
         remove_edge(origin, target);
     }
     
-    template <class F>
-    void TransformGraph<F>::removeTransform(const FrameId& origin, const FrameId& target)
+    template <class F, class S>
+    void TransformGraph<F,S>::removeTransform(const FrameId& origin, const FrameId& target)
     {
         remove_edge(origin, target);
     }
     
     
-    template<class F>
+    template <class F, class S>
     template <typename Archive>
-    void TransformGraph<F>::serialize(Archive &ar, const unsigned int version)
+    void TransformGraph<F,S>::serialize(Archive &ar, const unsigned int version)
     {
         ar & BOOST_SERIALIZATION_BASE_OBJECT_NVP(Base);
+        //loading does not cause edge events
+        if(cache && Archive::is_loading::value)
+            cache->clear();
+        if(seqLocks && Archive::is_loading::value)
+            seqLocks->clear();
+    }
+    
+    template <class F, class S>
+    std::vector<TransformResult> TransformGraph<F,S>::getTransforms(const vertex_descriptor origin,
+                                                                   const std::vector<vertex_descriptor>& targets) const
+    {
+        std::vector<BatchQuery> queries;
+        queries.reserve(targets.size());
+        for(std::size_t i = 0; i < targets.size(); ++i)
+        {
+            queries.push_back(BatchQuery{origin, targets[i], i});
+        }
+        std::vector<TransformResult> results(targets.size());
+        getTransforms(queries.cbegin(), queries.cend(), results);
+        return results;
+    }
+    
+    template <class F, class S>
+    std::vector<TransformResult> TransformGraph<F,S>::getTransforms(const FrameId& origin,
+                                                                   const std::vector<FrameId>& targets) const
+    {
+        std::vector<TransformResult> results(targets.size());
+        const vertex_descriptor originVertex = this->vertex(origin);
+        std::vector<BatchQuery> queries;
+        queries.reserve(targets.size());
+        for(std::size_t i = 0; i < targets.size(); ++i)
+        {
+            const vertex_descriptor targetVertex = this->vertex(targets[i]);
+            if(originVertex == null_vertex() || targetVertex == null_vertex())
+                results[i].status = TransformResult::UNKNOWN_FRAME;
+            else
+                queries.push_back(BatchQuery{originVertex, targetVertex, i});
+        }
+        getTransforms(queries.cbegin(), queries.cend(), results);
+        return results;
+    }
+    
+    template <class F, class S>
+    std::vector<TransformResult> TransformGraph<F,S>::getTransforms(const std::vector<std::pair<vertex_descriptor, vertex_descriptor>>& queries) const
+    {
+        std::vector<BatchQuery> sorted;
+        sorted.reserve(queries.size());
+        for(std::size_t i = 0; i < queries.size(); ++i)
+        {
+            sorted.push_back(BatchQuery{queries[i].first, queries[i].second, i});
+        }
+        //group the queries by origin
+        std::stable_sort(sorted.begin(), sorted.end(), [](const BatchQuery& a, const BatchQuery& b)
+        {
+            return std::less<vertex_descriptor>()(a.origin, b.origin);
+        });
+        
+        std::vector<TransformResult> results(queries.size());
+        BatchIterator begin = sorted.cbegin();
+        while(begin != sorted.cend())
+        {
+            BatchIterator end = begin;
+            while(end != sorted.cend() && end->origin == begin->origin)
+                ++end;
+            getTransforms(begin, end, results);
+            begin = end;
+        }
+        return results;
+    }
+    
+    template <class F, class S>
+    std::vector<TransformResult> TransformGraph<F,S>::getTransforms(const std::vector<std::pair<FrameId, FrameId>>& queries) const
+    {
+        std::vector<std::pair<vertex_descriptor, vertex_descriptor>> vertexQueries;
+        vertexQueries.reserve(queries.size());
+        for(const std::pair<FrameId, FrameId>& query : queries)
+        {
+            vertexQueries.emplace_back(this->vertex(query.first), this->vertex(query.second));
+        }
+        std::vector<TransformResult> results = getTransforms(vertexQueries);
+        for(std::size_t i = 0; i < results.size(); ++i)
+        {
+            if(vertexQueries[i].first == null_vertex() || vertexQueries[i].second == null_vertex())
+                results[i].status = TransformResult::UNKNOWN_FRAME;
+        }
+        return results;
+    }
+    
+    template <class F, class S>
+    void TransformGraph<F,S>::getTransforms(BatchIterator begin, BatchIterator end,
+                                            std::vector<TransformResult>& results) const
+    {
+        if(begin == end)
+            return;
+        const vertex_descriptor origin = begin->origin;
+        if(origin == null_vertex())
+            return; //results keep UNKNOWN_FRAME or UNKNOWN_TRANSFORM
+        
+        auto index = boost::get(boost::vertex_index, graph());
+        const std::size_t indexBound = this->storage.vertexIndexBound(graph());
+        
+        //mark the targets, the search can stop once all of them have been found
+        TraversalWorkspace::Lease targets = TraversalWorkspace::acquire();
+        targets->reset(indexBound);
+        std::size_t remaining = 0;
+        for(BatchIterator query = begin; query != end; ++query)
+        {
+            if(query->target == origin)
+            {
+                results[query->result].status = TransformResult::OK;
+                results[query->result].transform = Transform(base::Position::Zero(), base::Orientation::Identity());
+            }
+            else if(query->target != null_vertex() && targets->visit(index[query->target]))
+            {
+                ++remaining;
+            }
+        }
+        if(remaining == 0)
+            return;
+        
+        //breadth first search that composes the transforms along the search tree.
+        //transforms[i] is the transform from origin to queue[i] and parentIndex
+        //maps the vertex index to the position in the queue.
+        TraversalWorkspace::Lease workspace = TraversalWorkspace::acquire();
+        std::vector<vertex_descriptor>& queue = workspace->queue;
+        std::vector<base::TransformWithCovariance> transforms;
+        workspace->reset(indexBound);
+        workspace->visit(index[origin]);
+        workspace->parentIndex[index[origin]] = 0;
+        queue.clear();
+        queue.push_back(origin);
+        transforms.push_back(Transform(base::Position::Zero(), base::Orientation::Identity()).transform);
+        for(std::size_t head = 0; head < queue.size() && remaining > 0; ++head)
+        {
+            const base::TransformWithCovariance parentTf = transforms[head];
+            this->storage.forEachOutEdge(graph(), queue[head],
+                [&](const edge_descriptor edge, const vertex_descriptor next)
+                {
+                    const std::size_t nextIndex = index[next];
+                    if(!workspace->visit(nextIndex))
+                        return; //already discovered
+                    workspace->parentIndex[nextIndex] = queue.size();
+                    queue.push_back(next);
+                    transforms.push_back(parentTf * (*this)[edge].transform);
+                    if(targets->isVisited(nextIndex))
+                        --remaining;
+                });
+        }
+        
+        for(BatchIterator query = begin; query != end; ++query)
+        {
+            if(query->target == origin || query->target == null_vertex())
+                continue;
+            const std::size_t targetIndex = index[query->target];
+            if(workspace->isVisited(targetIndex))
+            {
+                results[query->result].status = TransformResult::OK;
+                results[query->result].transform = Transform(transforms[workspace->parentIndex[targetIndex]]);
+            }
+        }
+    }
+    
+    template <class F, class S>
+    std::size_t TransformGraph<F,S>::getRootTransforms(const vertex_descriptor root,
+                                                       std::vector<TransformResult>& transforms) const
+    {
+        const std::size_t indexBound = this->getVertexIndexBound();
+        transforms.resize(indexBound);
+        for(TransformResult& result : transforms)
+            result.status = TransformResult::UNKNOWN_TRANSFORM;
+        
+        const std::size_t rootIndex = this->getVertexIndex(root);
+        transforms[rootIndex].status = TransformResult::OK;
+        transforms[rootIndex].transform = Transform(base::Position::Zero(), base::Orientation::Identity());
+        
+        auto index = boost::get(boost::vertex_index, graph());
+        TraversalWorkspace::Lease workspace = TraversalWorkspace::acquire();
+        std::vector<vertex_descriptor>& queue = workspace->queue;
+        workspace->reset(indexBound);
+        workspace->visit(rootIndex);
+        queue.clear();
+        queue.push_back(root);
+        for(std::size_t head = 0; head < queue.size(); ++head)
+        {
+            const base::TransformWithCovariance& parentTf = transforms[index[queue[head]]].transform.transform;
+            this->storage.forEachOutEdge(graph(), queue[head],
+                [&](const edge_descriptor edge, const vertex_descriptor next)
+                {
+                    const std::size_t nextIndex = index[next];
+                    if(!workspace->visit(nextIndex))
+                        return; //already discovered
+                    TransformResult& result = transforms[nextIndex];
+                    result.status = TransformResult::OK;
+                    result.transform.transform = parentTf * (*this)[edge].transform;
+                    queue.push_back(next);
+                });
+        }
+        return queue.size();
+    }
+    
+    template <class F, class S>
+    std::size_t TransformGraph<F,S>::getRootTransforms(const FrameId& root,
+                                                       std::vector<TransformResult>& transforms) const
+    {
+        return getRootTransforms(getVertex(root), transforms); //will throw
+    }
+    
+    template <class F, class S>
+    std::size_t TransformGraph<F,S>::getRootTransforms(const TreeView& view,
+                                                       std::vector<TransformResult>& transforms) const
+    {
+        transforms.resize(this->getVertexIndexBound());
+        for(TransformResult& result : transforms)
+            result.status = TransformResult::UNKNOWN_TRANSFORM;
+        if(view.root == null_vertex())
+            return 0;
+        
+        auto index = boost::get(boost::vertex_index, graph());
+        const std::size_t rootIndex = this->getVertexIndex(view.root);
+        transforms[rootIndex].status = TransformResult::OK;
+        transforms[rootIndex].transform = Transform(base::Position::Zero(), base::Orientation::Identity());
+        
+        const bool inTransaction = this->isInTransaction();
+        TraversalWorkspace::Lease workspace = TraversalWorkspace::acquire();
+        std::vector<vertex_descriptor>& queue = workspace->queue;
+        queue.clear();
+        queue.push_back(view.root);
+        for(std::size_t head = 0; head < queue.size(); ++head)
+        {
+            const vertex_descriptor parent = queue[head];
+            const base::TransformWithCovariance& parentTf = transforms[index[parent]].transform.transform;
+            for(const vertex_descriptor child : view.getRelation(parent).children)
+            {
+                EdgePair edge;
+                if(inTransaction)
+                {
+                    //the view is out of date. The sub-tree below a removed
+                    //edge is skipped, it may contain removed frames.
+                    edge = this->findEdge(parent, child);
+                    if(!edge.second)
+                        continue;
+                }
+                else
+                {
+                    const VertexRelation& relation = view.getRelation(child);
+                    edge = EdgePair(relation.parentEdge, relation.parentEdge != edge_descriptor());
+                    if(!edge.second)
+                        edge = this->findEdge(parent, child);
+                }
+                
+                TransformResult& result = transforms[index[child]];
+                result.status = TransformResult::OK;
+                result.transform.transform = edge.second ? parentTf * (*this)[edge.first].transform : parentTf;
+                queue.push_back(child);
+            }
+        }
+        return queue.size();
+    }
+    
+    template <class F, class S>
+    base::TransformWithCovariance TransformGraph<F,S>::getRootTransform(const vertex_descriptor vertex,
+                                                                      const TreeView& view) const
+    {
+        //collect all vertices up to the first one that is cached
+        TraversalWorkspace::Lease workspace = TraversalWorkspace::acquire();
+        std::vector<vertex_descriptor>& uncached = workspace->pathVertices;
+        uncached.clear();
+        base::TransformWithCovariance tf = base::TransformWithCovariance::Identity();
+        vertex_descriptor v = vertex;
+        while(!view.isRoot(v))
+        {
+            const base::TransformWithCovariance* cached = view.getCachedRootTransform(v);
+            if(cached != nullptr)
+            {
+                tf = *cached;
+                break;
+            }
+            uncached.push_back(v);
+            v = view.getRelation(v).parent;
+        }
+
+        //compose and cache downwards
+        for(auto it = uncached.rbegin(); it != uncached.rend(); ++it)
+        {
+            const VertexRelation& relation = view.getRelation(*it);
+            if(relation.parentEdge != edge_descriptor())
+            {
+                tf = tf * (*this)[relation.parentEdge].transform;
+            }
+            else
+            {
+                EdgePair pair(this->findEdge(relation.parent, *it));
+                if (pair.second)
+                {
+                    tf = tf * (*this)[pair.first].transform;
+                }
+            }
+            view.cacheRootTransform(*it, tf);
+        }
+        return tf;
+    }
+    
+    template <class F, class S>
+    TransformGraph<F,S>::TransformGraph(const TransformGraph<F,S>& other) : Base(other)
+    {
+        if(other.isTransformCacheEnabled())
+            enableTransformCache();
+    }
+    
+    template <class F, class S>
+    void TransformGraph<F,S>::enableTransformCache()
+    {
+        if(!cache)
+            cache.reset(new Cache(*this));
+    }
+    
+    template <class F, class S>
+    void TransformGraph<F,S>::disableTransformCache()
+    {
+        cache.reset();
+    }
+    
+    template <class F, class S>
+    bool TransformGraph<F,S>::isTransformCacheEnabled() const
+    {
+        return cache != nullptr;
+    }
+    
+    template <class F, class S>
+    const typename TransformGraph<F,S>::Cache* TransformGraph<F,S>::getTransformCache() const
+    {
+        return cache.get();
+    }
+    
+    template <class F, class S>
+    std::shared_ptr<const SeqLockTransform> TransformGraph<F,S>::enableSeqLock(const FrameId& origin,
+                                                                                const FrameId& target)
+    {
+        return enableSeqLock(getVertex(origin), getVertex(target)); //will throw
+    }
+    
+    template <class F, class S>
+    std::shared_ptr<const SeqLockTransform> TransformGraph<F,S>::enableSeqLock(const vertex_descriptor origin,
+                                                                                const vertex_descriptor target)
+    {
+        if(!seqLocks)
+            seqLocks.reset(new SeqLocks(*this));
+        return seqLocks->add(origin, target);
+    }
+    
+    template <class F, class S>
+    bool TransformGraph<F,S>::disableSeqLock(const FrameId& origin, const FrameId& target)
+    {
+        const vertex_descriptor originVertex = getVertex(origin); //will throw
+        const vertex_descriptor targetVertex = getVertex(target); //will throw
+        return seqLocks && seqLocks->remove(originVertex, targetVertex);
     }
 }}
@@ -0,0 +1,93 @@
+//
+// Copyright (c) 2015, Deutsches Forschungszentrum für Künstliche Intelligenz GmbH.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+#include <envire_core/graph/TraversalWorkspace.hpp>
+
+#include <algorithm>
+#include <memory>
+
+namespace envire { namespace core
+{
+
+namespace
+{
+    /**Owns all workspaces of one thread. Workspaces that are currently
+     * leased are not part of the free list. */
+    struct WorkspacePool
+    {
+        std::vector<std::unique_ptr<TraversalWorkspace>> workspaces;
+        std::vector<TraversalWorkspace*> free;
+    };
+
+    WorkspacePool& threadPool()
+    {
+        static thread_local WorkspacePool pool;
+        return pool;
+    }
+}
+
+TraversalWorkspace::Lease::~Lease()
+{
+    if(workspace != nullptr)
+    {
+        threadPool().free.push_back(workspace);
+    }
+}
+
+TraversalWorkspace::Lease TraversalWorkspace::acquire()
+{
+    WorkspacePool& pool = threadPool();
+    if(pool.free.empty())
+    {
+        pool.workspaces.emplace_back(new TraversalWorkspace());
+        //reserve now, so that returning the lease never allocates
+        pool.free.reserve(pool.workspaces.size());
+        return Lease(pool.workspaces.back().get());
+    }
+    TraversalWorkspace* workspace = pool.free.back();
+    pool.free.pop_back();
+    return Lease(workspace);
+}
+
+void TraversalWorkspace::reset(const std::size_t indexBound)
+{
+    if(stamps.size() < indexBound)
+    {
+        stamps.resize(indexBound, generation);
+        colors.resize(indexBound);
+        parentEdge.resize(indexBound);
+        parentIndex.resize(indexBound);
+    }
+    ++generation;
+    if(generation == 0)
+    {
+        //the generation wrapped around, old stamps might look valid again
+        std::fill(stamps.begin(), stamps.end(), 0);
+        generation = 1;
+    }
+}
+
+}}
@@ -0,0 +1,185 @@
+//
+// Copyright (c) 2015, Deutsches Forschungszentrum für Künstliche Intelligenz GmbH.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+#pragma once
+
+#include <envire_core/graph/GraphTypes.hpp>
+#include <boost/graph/properties.hpp>
+#include <boost/property_map/property_map.hpp>
+
+#include <cstdint>
+#include <vector>
+
+namespace envire { namespace core
+{
+    /**Scratch memory for graph traversals.
+     *
+     * All per-vertex state is stored in vectors that are indexed by the
+     * vertex index of the underlying directed_graph. A vertex counts as
+     * visited if its stamp equals the current generation. Thus starting a
+     * new traversal only increments the generation instead of clearing
+     * the whole state.
+     *
+     * Workspaces are not created directly but leased from a thread local
+     * pool using acquire(). The buffers are kept when the lease is returned,
+     * thus after a few queries traversals do not allocate any memory.
+     * Nested traversals (e.g. a visitor that queries the graph) simply lease
+     * a second workspace. */
+    class TraversalWorkspace
+    {
+    public:
+        using vertex_descriptor = GraphTraits::vertex_descriptor;
+        using edge_descriptor = GraphTraits::edge_descriptor;
+
+        /**Returns the leased workspace to the pool on destruction */
+        class Lease
+        {
+        public:
+            explicit Lease(TraversalWorkspace* workspace) : workspace(workspace) {}
+            Lease(Lease&& other) : workspace(other.workspace) { other.workspace = nullptr; }
+            Lease(const Lease&) = delete;
+            Lease& operator=(const Lease&) = delete;
+            ~Lease();
+
+            TraversalWorkspace* operator->() const { return workspace; }
+            TraversalWorkspace& operator*() const { return *workspace; }
+
+        private:
+            TraversalWorkspace* workspace;
+        };
+
+        /**Leases a workspace from the pool of the calling thread */
+        static Lease acquire();
+
+        /**Starts a new traversal. Afterwards all vertices are unvisited.
+         * @param indexBound all vertex indices that will be used during
+         *                   the traversal have to be smaller than this.*/
+        void reset(const std::size_t indexBound);
+
+        bool isVisited(const std::size_t index) const
+        {
+            return stamps[index] == generation;
+        }
+
+        /**Marks the vertex as visited.
+         * @return false if the vertex had already been visited */
+        bool visit(const std::size_t index)
+        {
+            if(stamps[index] == generation)
+                return false;
+            stamps[index] = generation;
+            return true;
+        }
+
+        /**Color of the vertex for boost's search algorithms.
+         * Unvisited vertices are white. */
+        boost::default_color_type getColor(const std::size_t index) const
+        {
+            return isVisited(index) ? colors[index] : boost::white_color;
+        }
+
+        void setColor(const std::size_t index, const boost::default_color_type color)
+        {
+            stamps[index] = generation;
+            colors[index] = color;
+        }
+
+        /**The edge that led to the vertex. Only valid for visited vertices. */
+        std::vector<edge_descriptor> parentEdge;
+        /**Fifo queue for breadth first searches, starts at queueHead */
+        std::vector<vertex_descriptor> queue;
+        std::size_t queueHead = 0;
+        /**Index based variants of queue and parentEdge. Used by searches
+         * that work on vertex and edge indices instead of descriptors. */
+        std::vector<std::uint32_t> indexQueue;
+        std::vector<std::uint32_t> parentIndex;
+        /**Result buffers for path queries */
+        std::vector<vertex_descriptor> pathVertices;
+        std::vector<edge_descriptor> pathEdges;
+
+    private:
+        std::vector<std::uint32_t> stamps;
+        std::vector<boost::default_color_type> colors;
+        std::uint32_t generation = 0;
+    };
+
+    /**A boost read/write property map that stores vertex colors in a
+     * TraversalWorkspace.
+     * @param INDEX_MAP maps vertex_descriptors to vertex indices */
+    template <class INDEX_MAP>
+    struct TraversalColorMap
+    {
+        using key_type = GraphTraits::vertex_descriptor;
+        using value_type = boost::default_color_type;
+        using reference = boost::default_color_type;
+        using category = boost::read_write_property_map_tag;
+
+        TraversalColorMap(TraversalWorkspace& workspace, INDEX_MAP index) :
+            workspace(&workspace), index(index) {}
+
+        TraversalWorkspace* workspace;
+        INDEX_MAP index;
+    };
+
+    template <class INDEX_MAP>
+    inline boost::default_color_type get(const TraversalColorMap<INDEX_MAP>& map,
+                                         const GraphTraits::vertex_descriptor v)
+    {
+        return map.workspace->getColor(boost::get(map.index, v));
+    }
+
+    template <class INDEX_MAP>
+    inline void put(const TraversalColorMap<INDEX_MAP>& map,
+                    const GraphTraits::vertex_descriptor v,
+                    const boost::default_color_type color)
+    {
+        map.workspace->setColor(boost::get(map.index, v), color);
+    }
+
+    /**Adapts the queue of a TraversalWorkspace to the buffer concept used by
+     * boost::breadth_first_visit */
+    class TraversalQueue
+    {
+    public:
+        using value_type = GraphTraits::vertex_descriptor;
+
+        explicit TraversalQueue(TraversalWorkspace& workspace) : workspace(workspace)
+        {
+            workspace.queue.clear();
+            workspace.queueHead = 0;
+        }
+
+        void push(const value_type v) { workspace.queue.push_back(v); }
+        value_type& top() { return workspace.queue[workspace.queueHead]; }
+        const value_type& top() const { return workspace.queue[workspace.queueHead]; }
+        void pop() { ++workspace.queueHead; }
+        bool empty() const { return workspace.queueHead == workspace.queue.size(); }
+        std::size_t size() const { return workspace.queue.size() - workspace.queueHead; }
+
+    private:
+        TraversalWorkspace& workspace;
+    };
+}}
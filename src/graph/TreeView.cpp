@@ -42,12 +42,17 @@ namespace envire { namespace core
         tree = other.tree;
         crossEdges = other.crossEdges;
         root = other.root;
+        //the copy is not updated by the graph, thus the cache could become stale
+        transformCacheEnabled = false;
+        rootTransforms.clear();
         return *this;
     }
     
 TreeView::TreeView(TreeView&& other) noexcept : crossEdges(std::move(other.crossEdges)),
                                                 root(std::move(other.root)),
-                                                tree(std::move(other.tree))
+                                                tree(std::move(other.tree)),
+                                                transformCacheEnabled(other.transformCacheEnabled),
+                                                rootTransforms(std::move(other.rootTransforms))
 {
     //if the other TreeView was subscribed, unsubscribe it and 
     //subscribe this instead
@@ -98,6 +103,7 @@ void TreeView::clear()
 {
     tree.clear();
     crossEdges.clear();
+    rootTransforms.clear();
     root = GraphTraits::null_vertex();
 }
 
@@ -151,11 +157,45 @@ void TreeView::addCrossEdge(const GraphTraits::vertex_descriptor origin,
 }
 void TreeView::addEdge(vertex_descriptor origin, vertex_descriptor target)
 {
-    tree[origin].children.insert(target);
-    tree[target].parent = origin;
+    addEdge(origin, target, edge_descriptor());
+}
+
+void TreeView::addEdge(vertex_descriptor origin, vertex_descriptor target,
+                       edge_descriptor edge)
+{
+    VertexRelation& originRelation = tree[origin];
+    originRelation.children.insert(target);
+    VertexRelation& targetRelation = tree[target];
+    targetRelation.parent = origin;
+    targetRelation.parentEdge = edge;
+    targetRelation.depth = originRelation.depth + 1;
     edgeAdded(origin, target);
 }
 
+void TreeView::updateEdge(const vertex_descriptor a, const vertex_descriptor b)
+{
+    if(rootTransforms.empty())
+        return;
+    auto aRelation = tree.find(a);
+    auto bRelation = tree.find(b);
+    if(aRelation == tree.end() || bRelation == tree.end())
+        return;
+    if(bRelation->second.parent == a)
+        invalidateRootTransforms(b);
+    else if(aRelation->second.parent == b)
+        invalidateRootTransforms(a);
+}
+
+void TreeView::invalidateRootTransforms(const vertex_descriptor node)
+{
+    if(rootTransforms.erase(node) == 0)
+        return;
+    for(const vertex_descriptor child : tree.at(node).children)
+    {
+        invalidateRootTransforms(child);
+    }
+}
+
 
 
 void TreeView::removeEdge(vertex_descriptor origin, vertex_descriptor target)
@@ -241,6 +281,7 @@ void TreeView::removeEdge(vertex_descriptor origin, vertex_descriptor target)
       assert(relation.children.size() == 0);
 
       tree.erase(node);
+      rootTransforms.erase(node);
       edgeRemoved(parent, node);
   }
   
@@ -276,5 +317,48 @@ bool TreeView::isParent(const vertex_descriptor parent, const vertex_descriptor
   return tree.at(child).parent == parent;
 }
 
+const VertexRelation& TreeView::getRelation(vertex_descriptor node) const
+{
+    auto it = tree.find(node);
+    if(it == tree.end())
+    {
+      throw std::runtime_error("envire_core:TreeView::getRelation: Node is not in the tree.");
+    }
+    return it->second;
+}
+
+void TreeView::enableTransformCache()
+{
+    transformCacheEnabled = true;
+}
+
+void TreeView::disableTransformCache()
+{
+    transformCacheEnabled = false;
+    rootTransforms.clear();
+}
+
+bool TreeView::isTransformCacheEnabled() const
+{
+    return transformCacheEnabled;
+}
+
+const base::TransformWithCovariance* TreeView::getCachedRootTransform(const vertex_descriptor node) const
+{
+    auto it = rootTransforms.find(node);
+    if(it == rootTransforms.end())
+        return nullptr;
+    return &it->second;
+}
+
+void TreeView::cacheRootTransform(const vertex_descriptor node,
+                                  const base::TransformWithCovariance& tf) const
+{
+    if(!transformCacheEnabled)
+        return;
+    assert(tree.at(node).parent == root || rootTransforms.count(tree.at(node).parent) > 0);
+    rootTransforms[node] = tf;
+}
+
 
 }}
\ No newline at end of file
@@ -27,6 +27,7 @@
 #pragma once
 
 #include <envire_core/graph/GraphTypes.hpp>
+#include <base/TransformWithCovariance.hpp>
 
 #include <glog/logging.h>
 
@@ -39,9 +40,10 @@ namespace envire { namespace core
     {
         GraphTraits::vertex_descriptor parent; /**<can be null_vertex */
         std::unordered_set<GraphTraits::vertex_descriptor> children;
-        
-        
-        
+        /**The edge from parent to this vertex. Default constructed for the
+         * root and for edges that have been added without descriptor. */
+        GraphTraits::edge_descriptor parentEdge;
+        std::size_t depth = 0; /**<number of edges between this vertex and the root */
     };
 
     /**A map that shows the vertex information (parent and children) of the vertices in a tree.
@@ -163,6 +165,17 @@ namespace envire { namespace core
         /**Add an edge to the view.
          * Emits edgeAdded*/
         void addEdge(GraphTraits::vertex_descriptor origin, GraphTraits::vertex_descriptor target);
+        /**Add an edge to the view and remember @p edge (from @p origin to
+         * @p target) as parent edge of @p target.
+         * Emits edgeAdded*/
+        void addEdge(GraphTraits::vertex_descriptor origin, GraphTraits::vertex_descriptor target,
+                     GraphTraits::edge_descriptor edge);
+        
+        /**Notifies the view that the property of the edge between @p a and
+         * @p b has been modified. Drops the cached root transforms of the
+         * sub-tree below the edge. Does nothing for cross-edges and edges
+         * that are not part of the view.*/
+        void updateEdge(const GraphTraits::vertex_descriptor a, const GraphTraits::vertex_descriptor b);
         
         /**Adds the initial root node to the TreeView */
         void addRoot(GraphTraits::vertex_descriptor root);
@@ -185,6 +198,31 @@ namespace envire { namespace core
          * @throw std::out_of_range if child is not part of the TreeView*/
         bool isParent(const GraphTraits::vertex_descriptor parent, const GraphTraits::vertex_descriptor child) const;
         
+        /** Returns the relation of @p node to its parent and children
+         * @throw std::exception if @p node is not in the tree*/
+        const VertexRelation& getRelation(GraphTraits::vertex_descriptor node) const;
+        
+        /**Enables caching of the transforms from the root to each vertex.
+         * TransformGraph::getTransform(origin, target, view) fills the cache
+         * lazily. Afterwards a query costs a single composition instead of
+         * two walks to the root.
+         * The cache is invalidated by updateEdge() and removeEdge(). Thus it
+         * only stays valid if the view is kept updated by the graph or if
+         * the graph does not change.
+         * @note Copies of the view do not copy the cache.*/
+        void enableTransformCache();
+        /**Disables the cache and drops all cached transforms */
+        void disableTransformCache();
+        bool isTransformCacheEnabled() const;
+        
+        /** @return the cached transform from the root to @p node or nullptr */
+        const base::TransformWithCovariance* getCachedRootTransform(const GraphTraits::vertex_descriptor node) const;
+        /**Caches the transform from the root to @p node.
+         * The transform of the parent of @p node has to be cached already
+         * (unless the parent is the root). Does nothing if the cache is disabled.*/
+        void cacheRootTransform(const GraphTraits::vertex_descriptor node,
+                                const base::TransformWithCovariance& tf) const;
+        
         /**The signals are invoked whenever the tree is updated by the TransformGraph
         * @note This is only the case if you requested an updating TreeView. 
         *       Otherwise they'll never be invoked.
@@ -212,6 +250,16 @@ namespace envire { namespace core
         GraphTraits::vertex_descriptor root;
         VertexRelationMap tree;   
     protected:
+        /**Drops the cached root transforms of @p node and its sub-tree.
+         * If a vertex is not cached none of its descendants is cached,
+         * thus the traversal stops there. */
+        void invalidateRootTransforms(const GraphTraits::vertex_descriptor node);
+        
         TreeUpdatePublisher* publisher = nullptr;/*< Used for automatic unsubscribing in dtor */
+        
+        bool transformCacheEnabled = false;
+        /**The transform from the root to a vertex. The cache is mutable
+         * because it is filled while reading transforms from a const view.*/
+        mutable std::unordered_map<GraphTraits::vertex_descriptor, base::TransformWithCovariance> rootTransforms;
     };
 }}
\ No newline at end of file
@@ -29,6 +29,7 @@
 
 #include <boost/serialization/string.hpp>
 #include <boost/serialization/version.hpp>
+#include <boost/serialization/split_member.hpp>
 #include <vector>
 #include <string>
 #include <sstream>
@@ -52,7 +53,7 @@ namespace envire { namespace core
     class Frame
     {
     public:
-        FrameId id; /** Frame name */
+        FrameSymbol id; /** Frame name */
 
         using ItemList = std::vector<ItemBase::Ptr>;
         using ItemMap = std::unordered_map<std::type_index, ItemList>;
@@ -61,7 +62,7 @@ namespace envire { namespace core
 
     public:
         
-        Frame() : id("envire::core::default_frame_id"){}
+        Frame() : id(defaultId()){}
       
         Frame(const FrameId& id): id(id) {}
 
@@ -77,7 +78,7 @@ namespace envire { namespace core
         *
         * Returns the frame name of the item
         */
-        const FrameId& getId() const { return id; }
+        const FrameId& getId() const { return id.str(); }
         
         /**Returns the total number of items in this frame */
         std::size_t calculateTotalItemCount() const 
@@ -134,17 +135,36 @@ namespace envire { namespace core
         }
 
     private:
+        static const FrameSymbol& defaultId()
+        {
+            static const FrameSymbol symbol("envire::core::default_frame_id");
+            return symbol;
+        }
+
         /**Grants access to boost serialization */
         friend class boost::serialization::access;
 
-        /**Serializes the members of this class*/
+        /**The id is stored as plain string, thus the archive format does not
+         * depend on the interning. */
+        template<class Archive>
+        void save(Archive & ar, const unsigned int version) const
+        {
+            const FrameId& id = this->id.str();
+            ar << BOOST_SERIALIZATION_NVP(id);
+            ar << BOOST_SERIALIZATION_NVP(items);
+        }
+
         template<class Archive>
-        void serialize(Archive & ar, const unsigned int version)
+        void load(Archive & ar, const unsigned int version)
         {
-            ar & BOOST_SERIALIZATION_NVP(id);
-            ar & BOOST_SERIALIZATION_NVP(items);
+            FrameId id;
+            ar >> BOOST_SERIALIZATION_NVP(id);
+            this->id = id;
+            ar >> BOOST_SERIALIZATION_NVP(items);
         }
 
+        BOOST_SERIALIZATION_SPLIT_MEMBER()
+
     };
 }}
 
@@ -0,0 +1,95 @@
+//
+// Copyright (c) 2015, Deutsches Forschungszentrum für Künstliche Intelligenz GmbH.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+
+#include <envire_core/items/FrameSymbol.hpp>
+
+#include <mutex>
+#include <unordered_set>
+
+namespace envire { namespace core
+{
+
+namespace
+{
+    /**The nodes of an unordered_set are never moved, thus pointers to the
+     * interned strings stay valid when the table grows. */
+    struct SymbolTable
+    {
+        std::mutex mutex;
+        std::unordered_set<FrameId> names;
+    };
+
+    SymbolTable& symbolTable()
+    {
+        //intentionally leaked, symbols might be used during static destruction
+        static SymbolTable* table = new SymbolTable();
+        return *table;
+    }
+
+    const FrameId& emptyName()
+    {
+        static const FrameId* name = new FrameId();
+        return *name;
+    }
+
+    const FrameId* intern(const FrameId& id)
+    {
+        if(id.empty())
+            return &emptyName();
+        SymbolTable& table = symbolTable();
+        std::lock_guard<std::mutex> lock(table.mutex);
+        return &*table.names.insert(id).first;
+    }
+}
+
+FrameSymbol::FrameSymbol() : name(&emptyName())
+{}
+
+FrameSymbol::FrameSymbol(const FrameId& id) : name(intern(id))
+{}
+
+FrameSymbol::FrameSymbol(const char* id) : name(intern(FrameId(id)))
+{}
+
+FrameSymbol FrameSymbol::lookup(const FrameId& id)
+{
+    SymbolTable& table = symbolTable();
+    std::lock_guard<std::mutex> lock(table.mutex);
+    auto it = table.names.find(id);
+    if(it == table.names.end())
+        return FrameSymbol();
+    return FrameSymbol(&*it);
+}
+
+std::size_t FrameSymbol::tableSize()
+{
+    SymbolTable& table = symbolTable();
+    std::lock_guard<std::mutex> lock(table.mutex);
+    return table.names.size();
+}
+
+}}
@@ -0,0 +1,113 @@
+//
+// Copyright (c) 2015, Deutsches Forschungszentrum für Künstliche Intelligenz GmbH.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+
+#pragma once
+
+#include <string>
+#include <ostream>
+#include <functional>
+
+namespace envire { namespace core
+{
+    using FrameId = std::string;
+
+    /**An interned FrameId.
+     *
+     * All symbols with the same name share one immutable string that is
+     * stored in a global, process wide symbol table. Thus a symbol is a
+     * single pointer. Comparing and hashing symbols is O(1) and copying them
+     * never allocates. The text of a symbol is available using str() or the
+     * implicit conversion to const FrameId&.
+     *
+     * Interned strings are never released.
+     * Creating a symbol from a string locks the symbol table. Thus symbols
+     * should be created once (e.g. when a frame is added to a graph) and
+     * copied afterwards. Comparing, hashing and copying is lock free. */
+    class FrameSymbol
+    {
+    public:
+        /**Creates the empty symbol */
+        FrameSymbol();
+
+        /**Interns @p id */
+        FrameSymbol(const FrameId& id);
+        FrameSymbol(const char* id);
+
+        /**@return the symbol of @p id if it has been interned before.
+         *         The empty symbol otherwise. Never interns @p id. */
+        static FrameSymbol lookup(const FrameId& id);
+
+        /**@return the number of interned strings */
+        static std::size_t tableSize();
+
+        const FrameId& str() const { return *name; }
+        operator const FrameId&() const { return *name; }
+        bool empty() const { return name->empty(); }
+
+        bool operator==(const FrameSymbol& other) const { return name == other.name; }
+        bool operator!=(const FrameSymbol& other) const { return name != other.name; }
+        /**Orders by name, so that ordered containers of symbols are
+         * sorted like containers of strings. */
+        bool operator<(const FrameSymbol& other) const
+        {
+            return name != other.name && *name < *other.name;
+        }
+
+        std::size_t hash() const { return std::hash<const FrameId*>()(name); }
+
+    private:
+        explicit FrameSymbol(const FrameId* name) : name(name) {}
+
+        const FrameId* name;
+    };
+
+    inline bool operator==(const FrameSymbol& a, const FrameId& b) { return a.str() == b; }
+    inline bool operator==(const FrameId& a, const FrameSymbol& b) { return a == b.str(); }
+    inline bool operator==(const FrameSymbol& a, const char* b) { return a.str() == b; }
+    inline bool operator==(const char* a, const FrameSymbol& b) { return a == b.str(); }
+    inline bool operator!=(const FrameSymbol& a, const FrameId& b) { return !(a == b); }
+    inline bool operator!=(const FrameId& a, const FrameSymbol& b) { return !(a == b); }
+    inline bool operator!=(const FrameSymbol& a, const char* b) { return !(a == b); }
+    inline bool operator!=(const char* a, const FrameSymbol& b) { return !(a == b); }
+
+    inline std::ostream& operator<<(std::ostream& out, const FrameSymbol& symbol)
+    {
+        return out << symbol.str();
+    }
+}}
+
+namespace std
+{
+    template <>
+    struct hash<envire::core::FrameSymbol>
+    {
+        std::size_t operator()(const envire::core::FrameSymbol& symbol) const
+        {
+            return symbol.hash();
+        }
+    };
+}
@@ -37,11 +37,10 @@
 #include <string>
 #include <type_traits>
 #include <typeindex>
+#include <envire_core/items/FrameSymbol.hpp>
 
 namespace envire { namespace core
 {
-    using FrameId = std::string;
-
     /**@class ItemBase
     *
     * The ItemBase class is a abstract interface class of all
@@ -0,0 +1,76 @@
+//
+// Copyright (c) 2015, Deutsches Forschungszentrum für Künstliche Intelligenz GmbH.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+/**\file benchmark.hpp
+ * Minimal helpers shared by the benchmark executables in this directory.
+ * The benchmarks are not part of the test suite, run them manually
+ * on a release build. */
+#pragma once
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+
+namespace envire { namespace core { namespace benchmark
+{
+    /**Prevents the compiler from optimizing away the computation of @p value */
+    template <class T>
+    inline void doNotOptimize(const T& value)
+    {
+        asm volatile("" : : "g"(&value) : "memory");
+    }
+
+    /**Runs @p func @p iterations times and returns the mean duration of a
+     * single call in nanoseconds. @p func is called a few times before the
+     * measurement starts to warm up caches. */
+    template <class FUNC>
+    double measure(const size_t iterations, FUNC func)
+    {
+        for(size_t i = 0; i < iterations / 10 + 1; ++i)
+            func();
+
+        const auto start = std::chrono::steady_clock::now();
+        for(size_t i = 0; i < iterations; ++i)
+            func();
+        const auto end = std::chrono::steady_clock::now();
+        return std::chrono::duration<double, std::nano>(end - start).count() / iterations;
+    }
+
+    /**Prints one result line: name, baseline time, new time and speedup */
+    inline void report(const std::string& name, const double baselineNs, const double optimizedNs)
+    {
+        std::printf("%-40s %12.1f ns %12.1f ns %8.2fx\n", name.c_str(),
+                    baselineNs, optimizedNs, baselineNs / optimizedNs);
+    }
+
+    /**Prints the header for report() */
+    inline void reportHeader(const std::string& title, const std::string& baseline,
+                             const std::string& optimized)
+    {
+        std::printf("%s\n%-40s %15s %15s %9s\n", title.c_str(), "",
+                    baseline.c_str(), optimized.c_str(), "speedup");
+    }
+}}}
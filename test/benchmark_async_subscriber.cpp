@@ -0,0 +1,98 @@
+//
+// Copyright (c) 2015, Deutsches Forschungszentrum für Künstliche Intelligenz GmbH.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+
+
+/**Measures the cost of updateTransform() with a slow subscriber that is
+ * notified synchronously and with one that is bound to a thread via an
+ * AsyncGraphEventSubscriber. */
+
+#include <envire_core/graph/EnvireGraph.hpp>
+#include <envire_core/events/GraphEventDispatcher.hpp>
+#include <envire_core/events/AsyncGraphEventSubscriber.hpp>
+#include <envire_core/events/EdgeEvents.hpp>
+#include "benchmark.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <thread>
+
+using namespace envire::core;
+using namespace envire::core::benchmark;
+
+namespace
+{
+    /**Simulates a logger or visualization that needs some time per event */
+    class SlowSubscriber : public GraphEventDispatcher
+    {
+    public:
+        explicit SlowSubscriber(const std::chrono::microseconds delay) : delay(delay), count(0) {}
+
+        virtual void edgeModified(const EdgeModifiedEvent& e) override
+        {
+            const auto end = std::chrono::steady_clock::now() + delay;
+            while(std::chrono::steady_clock::now() < end) {}
+            ++count;
+        }
+
+        std::chrono::microseconds delay;
+        std::size_t count;
+    };
+}
+
+int main()
+{
+    const std::size_t iterations = 2000;
+    reportHeader("updateTransform() with a slow subscriber", "synchronous", "asynchronous");
+
+    for(const int delay : {1, 10, 50})
+    {
+        EnvireGraph graph;
+        Transform tf;
+        graph.addTransform("a", "b", tf);
+
+        double syncNs, asyncNs;
+        {
+            SlowSubscriber subscriber{std::chrono::microseconds(delay)};
+            subscriber.subscribe(&graph);
+            syncNs = measure(iterations, [&]() { graph.updateTransform("a", "b", tf); });
+        }
+        {
+            ThreadPoolExecutor pool(1);
+            SlowSubscriber subscriber{std::chrono::microseconds(delay)};
+            AsyncGraphEventSubscriber async(&graph, subscriber, pool);
+            asyncNs = measure(iterations, [&]() { graph.updateTransform("a", "b", tf); });
+            async.wait();
+            doNotOptimize(subscriber.count);
+        }
+        char name[64];
+        std::snprintf(name, sizeof(name), "subscriber delay %d us", delay);
+        report(name, syncNs, asyncNs);
+    }
+    std::printf("\nThe asynchronous time is the time of the writer only, the events are "
+                "delivered on the pool thread.\n");
+    return 0;
+}
@@ -0,0 +1,140 @@
+//
+// Copyright (c) 2015, Deutsches Forschungszentrum für Künstliche Intelligenz GmbH.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+
+/**Measures the getTransform() throughput of 1 to N reader threads while one
+ * writer updates a transform at 1 kHz. Compares an EnvireGraph behind a
+ * single std::mutex with the ConcurrentEnvireGraph. The reported time is
+ * the wall time per query of all readers together, it only drops with more
+ * readers if the queries run in parallel. */
+
+#include <envire_core/graph/ConcurrentEnvireGraph.hpp>
+#include "benchmark.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace envire::core;
+using namespace envire::core::benchmark;
+
+static const int numFrames = 1000;
+static const std::chrono::milliseconds duration(300);
+
+/**The usual workaround: one mutex for everything */
+struct LockedGraph
+{
+    EnvireGraph graph;
+    mutable std::mutex mutex;
+
+    Transform getTransform(const FrameId& origin, const FrameId& target) const
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return graph.getTransform(origin, target);
+    }
+
+    void updateTransform(const FrameId& origin, const FrameId& target, const Transform& tf)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        graph.updateTransform(origin, target, tf);
+    }
+
+    void addTransform(const FrameId& origin, const FrameId& target, const Transform& tf)
+    {
+        graph.addTransform(origin, target, tf);
+    }
+};
+
+template <class GRAPH>
+double run(GRAPH& graph, const int numReaders)
+{
+    std::atomic<int> running(numReaders);
+    std::atomic<size_t> queries(0);
+    std::vector<std::thread> readers;
+    const auto start = std::chrono::steady_clock::now();
+    for(int r = 0; r < numReaders; ++r)
+    {
+        //the readers stop on their own, a starved writer must not keep them running
+        readers.emplace_back([&, r]()
+        {
+            size_t count = 0;
+            unsigned next = r;
+            while(std::chrono::steady_clock::now() - start < duration)
+            {
+                const std::string target = "frame_" + std::to_string(1 + (next * 7919u) % (numFrames - 1));
+                doNotOptimize(graph.getTransform("frame_0", target));
+                ++next;
+                ++count;
+            }
+            queries += count;
+            --running;
+        });
+    }
+    Transform tf(base::Position(1, 0, 0), base::Orientation::Identity());
+    while(running > 0)
+    {
+        graph.updateTransform("frame_0", "frame_1", tf);
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    for(std::thread& reader : readers)
+    {
+        reader.join();
+    }
+    const double ns = std::chrono::duration<double, std::nano>(duration).count();
+    return ns / std::max<size_t>(queries, 1);
+}
+
+template <class GRAPH>
+void buildGraph(GRAPH& graph)
+{
+    Transform tf(base::Position(1, 0, 0), base::Orientation::Identity());
+    for(int i = 1; i < numFrames; ++i)
+    {
+        graph.addTransform("frame_" + std::to_string(i / 3), "frame_" + std::to_string(i), tf);
+    }
+}
+
+int main()
+{
+    LockedGraph locked;
+    ConcurrentEnvireGraph concurrent;
+    buildGraph(locked);
+    buildGraph(concurrent);
+
+    const int maxReaders = std::max(4, static_cast<int>(std::thread::hardware_concurrency()));
+    reportHeader("getTransform, 1k frames, one writer at 1 kHz", "std::mutex", "concurrent");
+    for(int readers = 1; readers <= maxReaders; readers *= 2)
+    {
+        const double lockedNs = run(locked, readers);
+        const double concurrentNs = run(concurrent, readers);
+        report(std::to_string(readers) + " readers", lockedNs, concurrentNs);
+    }
+    return 0;
+}
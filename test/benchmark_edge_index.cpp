@@ -0,0 +1,98 @@
+//
+// Copyright (c) 2015, Deutsches Forschungszentrum für Künstliche Intelligenz GmbH.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+/**Measures edge lookups on a star shaped graph with 10k leaves.
+ * The baseline is boost::edge() which scans the out edges of the source,
+ * the graph uses the EdgeIndex of its storage policy. */
+
+#include <envire_core/graph/TransformGraph.hpp>
+#include "benchmark.hpp"
+
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace envire::core;
+using namespace envire::core::benchmark;
+
+class FrameProp
+{
+public:
+    std::string id;
+    const std::string& getId() const {return id;}
+    void setId(const std::string& _id) {id = _id;}
+    const std::string toString() const {return id;}
+    template<class Archive>
+    void serialize(Archive &ar, const unsigned int version) {ar & id;}
+};
+
+static const int numLeaves = 10000;
+
+template <class GRAPH>
+void run(const std::string& name)
+{
+    GRAPH graph;
+    Transform tf;
+    tf.transform.translation << 1, 0, 0;
+    tf.transform.orientation = base::Orientation::Identity();
+    for(int i = 0; i < numLeaves; ++i)
+        graph.addTransform("world", "leaf_" + std::to_string(i), tf);
+
+    const auto hub = graph.getVertex("world");
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<int> leaf(0, numLeaves - 1);
+    std::vector<GraphTraits::vertex_descriptor> leaves;
+    for(int i = 0; i < 64; ++i)
+        leaves.push_back(graph.getVertex("leaf_" + std::to_string(leaf(rng))));
+
+    size_t next = 0;
+    const double scanNs = measure(2000, [&]()
+    {
+        doNotOptimize(boost::edge(hub, leaves[next++ % leaves.size()], graph));
+    });
+    next = 0;
+    const double indexNs = measure(200000, [&]()
+    {
+        doNotOptimize(graph.findEdge(hub, leaves[next++ % leaves.size()]));
+    });
+    next = 0;
+    const double updateNs = measure(20000, [&]()
+    {
+        graph.updateTransform(hub, leaves[next++ % leaves.size()], tf);
+    });
+
+    reportHeader(name + ", star with 10k leaves", "boost::edge", "EdgeIndex");
+    report("edge(hub, leaf)", scanNs, indexNs);
+    std::printf("%-40s %12.1f ns\n", "updateTransform(hub, leaf)", updateNs);
+}
+
+int main()
+{
+    run<TransformGraph<FrameProp, ListStorage>>("ListStorage");
+    run<TransformGraph<FrameProp, DenseStorage>>("DenseStorage");
+    return 0;
+}
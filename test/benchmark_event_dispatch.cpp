@@ -0,0 +1,193 @@
+//
+// Copyright (c) 2015, Deutsches Forschungszentrum für Künstliche Intelligenz GmbH.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+
+
+/**Measures the cost of delivering a single event to a dispatcher. The
+ * baselines cast the events with dynamic_cast, like the dispatchers used
+ * to do. The dispatchers now rely on the event type and use static_cast. */
+
+#include <envire_core/events/GraphEventDispatcher.hpp>
+#include <envire_core/events/GraphItemEventDispatcher.hpp>
+#include <envire_core/events/EdgeEvents.hpp>
+#include <envire_core/events/FrameEvents.hpp>
+#include <envire_core/items/Item.hpp>
+#include "benchmark.hpp"
+
+#include <memory>
+#include <vector>
+
+using namespace envire::core;
+using namespace envire::core::benchmark;
+
+namespace
+{
+    const std::size_t iterations = 2000000;
+
+    class CountingDispatcher : public GraphEventDispatcher
+    {
+    public:
+        std::size_t count = 0;
+    protected:
+        void edgeAdded(const EdgeAddedEvent& e) override { count += e.edge != GraphTraits::edge_descriptor(); }
+        void edgeModified(const EdgeModifiedEvent& e) override { ++count; }
+        void frameAdded(const FrameAddedEvent& e) override { ++count; }
+        void itemAdded(const ItemAddedEvent& e) override { count += e.item != nullptr; }
+    };
+
+    /**The dispatch of GraphEventDispatcher using dynamic_cast */
+    class CastingDispatcher : public GraphEventSubscriber
+    {
+    public:
+        std::size_t count = 0;
+
+        void notifyGraphEvent(const GraphEvent& event) override
+        {
+            switch(event.getType())
+            {
+            case GraphEvent::EDGE_ADDED:
+                edgeAdded(dynamic_cast<const EdgeAddedEvent&>(event));
+                break;
+            case GraphEvent::EDGE_MODIFIED:
+                edgeModified(dynamic_cast<const EdgeModifiedEvent&>(event));
+                break;
+            case GraphEvent::FRAME_ADDED:
+                frameAdded(dynamic_cast<const FrameAddedEvent&>(event));
+                break;
+            case GraphEvent::ITEM_ADDED_TO_FRAME:
+                itemAdded(dynamic_cast<const ItemAddedEvent&>(event));
+                break;
+            default:
+                break;
+            }
+        }
+    protected:
+        virtual void edgeAdded(const EdgeAddedEvent& e) { count += e.edge != GraphTraits::edge_descriptor(); }
+        virtual void edgeModified(const EdgeModifiedEvent& e) { ++count; }
+        virtual void frameAdded(const FrameAddedEvent& e) { ++count; }
+        virtual void itemAdded(const ItemAddedEvent& e) { count += e.item != nullptr; }
+    };
+
+    class TypedDispatcher : public GraphItemEventDispatcher<Item<int>>
+    {
+    public:
+        std::size_t count = 0;
+    protected:
+        void itemAdded(const TypedItemAddedEvent<Item<int>>& e) override { count += e.item->getData(); }
+    };
+
+    /**The dispatch of GraphItemEventDispatcher using dynamic casts */
+    class CastingTypedDispatcher : public GraphEventSubscriber
+    {
+    public:
+        std::size_t count = 0;
+        std::type_index itemType = typeid(Item<int>);
+
+        void notifyGraphEvent(const GraphEvent& event) override
+        {
+            if(event.getType() == GraphEvent::ITEM_ADDED_TO_FRAME)
+            {
+                const ItemAddedEvent& itemEvent = dynamic_cast<const ItemAddedEvent&>(event);
+                if(itemEvent.item->getTypeIndex() == itemType)
+                    itemAdded(TypedItemAddedEvent<Item<int>>(itemEvent.frame,
+                              boost::dynamic_pointer_cast<Item<int>>(itemEvent.item)));
+            }
+        }
+    protected:
+        virtual void itemAdded(const TypedItemAddedEvent<Item<int>>& e) { count += e.item->getData(); }
+    };
+
+    /**EdgeEvent::mergeable() using dynamic_cast */
+    bool castingMergeable(const EdgeEvent& queued, const GraphEvent& event)
+    {
+        if((event.getType() == GraphEvent::EDGE_MODIFIED && queued.getType() == GraphEvent::EDGE_MODIFIED) ||
+           event.getType() == GraphEvent::EDGE_REMOVED)
+        {
+            const EdgeEvent& edgeEvent = dynamic_cast<const EdgeEvent&>(event);
+            return (queued.origin == edgeEvent.origin && queued.target == edgeEvent.target) ||
+                   (queued.origin == edgeEvent.target && queued.target == edgeEvent.origin);
+        }
+        return false;
+    }
+
+    template <class BASELINE, class DISPATCHER>
+    void compare(const char* name, const std::vector<std::unique_ptr<GraphEvent>>& events)
+    {
+        BASELINE baseline;
+        DISPATCHER dispatcher;
+        std::size_t i = 0;
+        const double baselineNs = measure(iterations, [&]()
+        {
+            baseline.notifyGraphEvent(*events[i++ % events.size()]);
+        });
+        i = 0;
+        const double dispatcherNs = measure(iterations, [&]()
+        {
+            dispatcher.notifyGraphEvent(*events[i++ % events.size()]);
+        });
+        doNotOptimize(baseline.count);
+        doNotOptimize(dispatcher.count);
+        report(name, baselineNs, dispatcherNs);
+    }
+}
+
+int main()
+{
+    const FrameSymbol a("a");
+    const FrameSymbol b("b");
+    const GraphTraits::edge_descriptor edge;
+    ItemBase::Ptr intItem(new Item<int>(1));
+    ItemBase::Ptr doubleItem(new Item<double>(1.0));
+
+    std::vector<std::unique_ptr<GraphEvent>> mixed;
+    mixed.emplace_back(new EdgeAddedEvent(a, b, edge));
+    mixed.emplace_back(new EdgeModifiedEvent(a, b, edge, edge));
+    mixed.emplace_back(new FrameAddedEvent(a));
+    mixed.emplace_back(new ItemAddedEvent(a, intItem));
+
+    std::vector<std::unique_ptr<GraphEvent>> items;
+    items.emplace_back(new ItemAddedEvent(a, intItem));
+    items.emplace_back(new ItemAddedEvent(b, doubleItem));
+
+    reportHeader("Dispatch of a single event", "dynamic_cast", "static");
+    compare<CastingDispatcher, CountingDispatcher>("GraphEventDispatcher, mixed events", mixed);
+    compare<CastingTypedDispatcher, TypedDispatcher>("GraphItemEventDispatcher", items);
+
+    EdgeModifiedEvent queued(a, b, edge, edge);
+    std::size_t i = 0, merged = 0;
+    const double baselineNs = measure(iterations, [&]()
+    {
+        merged += castingMergeable(queued, *mixed[i++ % 2]);
+    });
+    i = 0;
+    const double staticNs = measure(iterations, [&]()
+    {
+        merged += queued.mergeable(*mixed[i++ % 2]);
+    });
+    doNotOptimize(merged);
+    report("EdgeEvent::mergeable()", baselineNs, staticNs);
+    return 0;
+}
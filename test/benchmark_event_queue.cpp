@@ -0,0 +1,148 @@
+//
+// Copyright (c) 2015, Deutsches Forschungszentrum für Künstliche Intelligenz GmbH.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+
+/**Compares the indexed GraphEventQueue with a plain list that calls
+ * mergeable() on every queued event, like the queue used to do.
+ * Events are queued in windows of increasing size and flushed afterwards. */
+
+#include <envire_core/events/GraphEventQueue.hpp>
+#include <envire_core/events/EdgeEvents.hpp>
+#include <envire_core/events/ItemAddedEvent.hpp>
+#include <envire_core/items/Item.hpp>
+#include "benchmark.hpp"
+
+#include <list>
+#include <string>
+#include <vector>
+
+using namespace envire::core;
+using namespace envire::core::benchmark;
+
+/**The old implementation */
+class ListQueue
+{
+public:
+    ~ListQueue()
+    {
+        for(GraphEvent* event : queue)
+            delete event;
+    }
+
+    void notifyGraphEvent(const GraphEvent& event)
+    {
+        bool skip = false;
+        for(auto it = queue.begin(); it != queue.end();)
+        {
+            if((*it)->mergeable(event))
+            {
+                if(((*it)->getType() == GraphEvent::EDGE_ADDED && event.getType() == GraphEvent::EDGE_REMOVED) ||
+                   ((*it)->getType() == GraphEvent::ITEM_ADDED_TO_FRAME && event.getType() == GraphEvent::ITEM_REMOVED_FROM_FRAME))
+                    skip = true;
+                delete *it;
+                it = queue.erase(it);
+            }
+            else
+                ++it;
+        }
+        if(!skip)
+            queue.push_back(event.clone());
+    }
+
+    void flush()
+    {
+        for(GraphEvent* event : queue)
+        {
+            doNotOptimize(event);
+            delete event;
+        }
+        queue.clear();
+    }
+
+private:
+    std::list<GraphEvent*> queue;
+};
+
+class IndexedQueue : public GraphEventQueue
+{
+public:
+    virtual void process(const GraphEvent& event) override
+    {
+        doNotOptimize(&event);
+    }
+};
+
+/**A window of sensor data: every item is added once, 16 edges are updated
+ * over and over */
+struct Window
+{
+    explicit Window(const int size)
+    {
+        std::vector<FrameSymbol> frames;
+        for(int i = 0; i < 17; ++i)
+            frames.emplace_back("frame_" + std::to_string(i));
+        for(int i = 0; i < size; ++i)
+        {
+            if(i % 2 == 0)
+                items.emplace_back(frames[i % 16], ItemBase::Ptr(new Item<int>(i)));
+            else
+                edges.emplace_back(frames[16], frames[i % 16], GraphTraits::edge_descriptor(),
+                                   GraphTraits::edge_descriptor());
+        }
+    }
+
+    template <class QUEUE>
+    void queue(QUEUE& queue) const
+    {
+        for(std::size_t i = 0; i < items.size() || i < edges.size(); ++i)
+        {
+            if(i < items.size())
+                queue.notifyGraphEvent(items[i]);
+            if(i < edges.size())
+                queue.notifyGraphEvent(edges[i]);
+        }
+        queue.flush();
+    }
+
+    std::vector<ItemAddedEvent> items;
+    std::vector<EdgeModifiedEvent> edges;
+};
+
+int main()
+{
+    reportHeader("queue and flush, ns per event", "std::list", "indexed");
+    for(int size : {16, 256, 4096})
+    {
+        const Window window(size);
+        ListQueue list;
+        IndexedQueue indexed;
+        const int repetitions = 200000 / size;
+        const double listNs = measure(repetitions, [&]() { window.queue(list); }) / size;
+        const double indexedNs = measure(repetitions, [&]() { window.queue(indexed); }) / size;
+        report(std::to_string(size) + " events per flush", listNs, indexedNs);
+    }
+    return 0;
+}
@@ -0,0 +1,97 @@
+//
+// Copyright (c) 2015, Deutsches Forschungszentrum für Künstliche Intelligenz GmbH.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+
+/**Compares the deep copy of an EnvireGraph with GraphSnapshotBuilder
+ * snapshots on a graph with 5k frames. A reader thread needs one of them
+ * to access the graph while it is modified. */
+
+#include <envire_core/graph/EnvireGraph.hpp>
+#include <envire_core/graph/GraphSnapshot.hpp>
+#include "benchmark.hpp"
+
+#include <string>
+#include <vector>
+
+using namespace envire::core;
+using namespace envire::core::benchmark;
+
+static const int numFrames = 5000;
+
+int main()
+{
+    EnvireGraph graph;
+    Transform tf(base::Position(1, 0, 0), base::Orientation::Identity());
+    for(int i = 1; i < numFrames; ++i)
+    {
+        graph.addTransform("frame_" + std::to_string(i / 4), "frame_" + std::to_string(i), tf);
+    }
+
+    const double copyNs = measure(20, [&]()
+    {
+        EnvireGraph copy(graph);
+        doNotOptimize(copy);
+    });
+
+    //updates without snapshots only pay for the event
+    std::vector<std::pair<std::string, std::string>> edges;
+    for(const int frame : {1, 17, 1234, 4999})
+    {
+        edges.emplace_back("frame_" + std::to_string(frame / 4), "frame_" + std::to_string(frame));
+    }
+    size_t next = 0;
+    const double updateNs = measure(20000, [&]()
+    {
+        const auto& edge = edges[next++ % edges.size()];
+        graph.updateTransform(edge.first, edge.second, tf);
+    });
+
+    GraphSnapshotBuilder builder(graph);
+    const double snapshotNs = measure(20000, [&]()
+    {
+        doNotOptimize(builder.snapshot());
+    });
+    const double builderUpdateNs = measure(20000, [&]()
+    {
+        const auto& edge = edges[next++ % edges.size()];
+        graph.updateTransform(edge.first, edge.second, tf);
+    });
+    //the worst case: each update is followed by a snapshot, thus every
+    //update copies a chunk and the chunk list
+    const double updateAndSnapshotNs = measure(20000, [&]()
+    {
+        const auto& edge = edges[next++ % edges.size()];
+        graph.updateTransform(edge.first, edge.second, tf);
+        doNotOptimize(builder.snapshot());
+    });
+
+    reportHeader("5k frames", "copy ctor", "snapshot");
+    report("create a copy", copyNs, snapshotNs);
+    reportHeader("updateTransform", "no builder", "builder");
+    report("update only", updateNs, builderUpdateNs);
+    report("update + copy / snapshot", updateNs + copyNs, updateAndSnapshotNs);
+    return 0;
+}
@@ -0,0 +1,111 @@
+//
+// Copyright (c) 2015, Deutsches Forschungszentrum für Künstliche Intelligenz GmbH.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+/**Compares ListStorage and DenseStorage on a graph with 50k frames.
+ * The graph is a random tree with one hub frame that has many children. */
+
+#include <envire_core/graph/TransformGraph.hpp>
+#include "benchmark.hpp"
+
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace envire::core;
+using namespace envire::core::benchmark;
+
+class FrameProp
+{
+public:
+    std::string id;
+    const std::string& getId() const {return id;}
+    void setId(const std::string& _id) {id = _id;}
+    const std::string toString() const {return id;}
+    template<class Archive>
+    void serialize(Archive &ar, const unsigned int version) {ar & id;}
+};
+
+static const int numFrames = 50000;
+static const int hubChildren = 5000;
+
+template <class GRAPH>
+void buildGraph(GRAPH& graph)
+{
+    std::mt19937 rng(42);
+    Transform tf;
+    tf.transform.translation << 1, 0, 0;
+    tf.transform.orientation = base::Orientation::Identity();
+    for(int i = 1; i < numFrames; ++i)
+    {
+        const int parent = i <= hubChildren ? 0 : std::uniform_int_distribution<int>(0, i - 1)(rng);
+        graph.addTransform("frame_" + std::to_string(parent), "frame_" + std::to_string(i), tf);
+    }
+}
+
+template <class GRAPH>
+void run(const std::string& name, double& traversalNs, double& lookupNs)
+{
+    GRAPH graph;
+    buildGraph(graph);
+
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<int> frame(0, numFrames - 1);
+    std::vector<std::pair<GraphTraits::vertex_descriptor, GraphTraits::vertex_descriptor>> pairs;
+    for(int i = 0; i < 64; ++i)
+    {
+        pairs.emplace_back(graph.getVertex("frame_" + std::to_string(frame(rng))),
+                           graph.getVertex("frame_" + std::to_string(frame(rng))));
+    }
+    size_t next = 0;
+    traversalNs = measure(200, [&]()
+    {
+        const auto& p = pairs[next++ % pairs.size()];
+        doNotOptimize(graph.getTransform(p.first, p.second));
+    });
+
+    const auto hub = graph.getVertex("frame_0");
+    std::vector<GraphTraits::vertex_descriptor> children;
+    std::uniform_int_distribution<int> child(1, hubChildren);
+    for(int i = 0; i < 64; ++i)
+        children.push_back(graph.getVertex("frame_" + std::to_string(child(rng))));
+    next = 0;
+    lookupNs = measure(20000, [&]()
+    {
+        doNotOptimize(graph.getEdge(hub, children[next++ % children.size()]));
+    });
+}
+
+int main()
+{
+    double listTraversal, listLookup, denseTraversal, denseLookup;
+    run<TransformGraph<FrameProp, ListStorage>>("list", listTraversal, listLookup);
+    run<TransformGraph<FrameProp, DenseStorage>>("dense", denseTraversal, denseLookup);
+
+    reportHeader("50k frames, hub with 5k children", "ListStorage", "DenseStorage");
+    report("getTransform random pair", listTraversal, denseTraversal);
+    report("getEdge(hub, child)", listLookup, denseLookup);
+    return 0;
+}
@@ -0,0 +1,103 @@
+//
+// Copyright (c) 2015, Deutsches Forschungszentrum für Künstliche Intelligenz GmbH.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+
+/**Measures how item ingestion scales with the number of producer threads.
+ * Every producer adds items to its own frame, like a sensor driver.
+ * Compares an EnvireGraph behind a single std::mutex with the per frame
+ * item locks of the EnvireGraph. The reported time is the wall time per
+ * item of all producers together, it only drops with more producers if
+ * they run in parallel. */
+
+#include <envire_core/graph/EnvireGraph.hpp>
+#include <envire_core/items/Item.hpp>
+#include "benchmark.hpp"
+
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace envire::core;
+using namespace envire::core::benchmark;
+
+static const int itemsPerProducer = 50000;
+
+template <class ADD>
+double run(const int numProducers, ADD add)
+{
+    std::vector<Item<int>::Ptr> items;
+    for(int i = 0; i < numProducers * itemsPerProducer; ++i)
+        items.emplace_back(new Item<int>(i));
+
+    const auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> producers;
+    for(int p = 0; p < numProducers; ++p)
+    {
+        producers.emplace_back([&, p]()
+        {
+            const FrameId frame = "frame_" + std::to_string(p);
+            for(int i = 0; i < itemsPerProducer; ++i)
+                add(frame, items[p * itemsPerProducer + i]);
+        });
+    }
+    for(std::thread& producer : producers)
+        producer.join();
+    const double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    return ns / (numProducers * itemsPerProducer);
+}
+
+void addFrames(EnvireGraph& graph, const int numProducers)
+{
+    for(int p = 0; p < numProducers; ++p)
+        graph.addFrame("frame_" + std::to_string(p));
+}
+
+int main()
+{
+    reportHeader("addItemToFrame, one frame per producer", "std::mutex", "frame locks");
+    for(int producers = 1; producers <= 8; producers *= 2)
+    {
+        EnvireGraph locked;
+        addFrames(locked, producers);
+        std::mutex mutex;
+        const double lockedNs = run(producers, [&](const FrameId& frame, const ItemBase::Ptr& item)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            locked.addItemToFrame(frame, item);
+        });
+
+        EnvireGraph concurrent;
+        addFrames(concurrent, producers);
+        const double concurrentNs = run(producers, [&](const FrameId& frame, const ItemBase::Ptr& item)
+        {
+            concurrent.addItemToFrame(frame, item);
+        });
+        report(std::to_string(producers) + " producers", lockedNs, concurrentNs);
+    }
+    return 0;
+}
@@ -0,0 +1,102 @@
+//
+// Copyright (c) 2015, Deutsches Forschungszentrum für Künstliche Intelligenz GmbH.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+
+
+/**Measures auto updating paths: 5000 paths between random frames of a
+ * binary tree with 1023 frames. Removing an edge near a leaf affects few
+ * paths, removing an edge near the root affects many. getPath() is called
+ * for pairs that have a path already. */
+
+#include <envire_core/graph/EnvireGraph.hpp>
+#include "benchmark.hpp"
+
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace envire::core;
+using namespace envire::core::benchmark;
+
+namespace
+{
+    const int numFrames = 1023;
+    const int numPaths = 5000;
+
+    FrameId frame(const int i)
+    {
+        return "f" + std::to_string(i);
+    }
+}
+
+int main()
+{
+    EnvireGraph graph;
+    Transform tf;
+    for(int i = 2; i <= numFrames; ++i)
+        graph.addTransform(frame(i / 2), frame(i), tf);
+
+    std::mt19937 random(42);
+    std::uniform_int_distribution<int> frames(1, numFrames);
+    std::vector<std::pair<FrameId, FrameId>> pairs;
+    std::vector<Path::Ptr> paths;
+    for(int i = 0; i < numPaths; ++i)
+    {
+        pairs.emplace_back(frame(frames(random)), frame(frames(random)));
+        paths.push_back(graph.getPath(pairs.back().first, pairs.back().second, true));
+    }
+
+    std::size_t i = 0;
+    const double getPathNs = measure(20000, [&]()
+    {
+        const auto& pair = pairs[i++ % pairs.size()];
+        doNotOptimize(graph.getPath(pair.first, pair.second, true));
+    });
+
+    //the leaf f1000 hangs below f500
+    const double removeLeafNs = measure(20000, [&]()
+    {
+        graph.removeTransform(frame(500), frame(1000));
+        graph.addTransform(frame(500), frame(1000), tf);
+    });
+    //f2 and f3 are the children of the root
+    const double removeRootNs = measure(2000, [&]()
+    {
+        graph.removeTransform(frame(1), frame(2));
+        graph.addTransform(frame(1), frame(2), tf);
+    });
+
+    std::size_t dirty = 0;
+    for(const Path::Ptr& path : paths)
+        dirty += path->isDirty();
+
+    std::printf("%d auto updating paths, %zu dirty after the benchmark\n", numPaths, dirty);
+    std::printf("%-40s %12.1f ns\n", "getPath of a registered pair", getPathNs);
+    std::printf("%-40s %12.1f ns\n", "remove/add a leaf edge", removeLeafNs);
+    std::printf("%-40s %12.1f ns\n", "remove/add an edge below the root", removeRootNs);
+    return 0;
+}
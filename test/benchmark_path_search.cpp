@@ -0,0 +1,107 @@
+//
+// Copyright (c) 2015, Deutsches Forschungszentrum für Künstliche Intelligenz GmbH.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+/**Compares the exception based GraphBFSVisitor path search with PathSearch
+ * for chains of increasing depth. */
+
+#include <envire_core/graph/TransformGraph.hpp>
+#include <envire_core/graph/GraphVisitors.hpp>
+#include "benchmark.hpp"
+
+#include <string>
+
+using namespace envire::core;
+using namespace envire::core::benchmark;
+
+class FrameProp
+{
+public:
+    std::string id;
+    const std::string& getId() const {return id;}
+    void setId(const std::string& _id) {id = _id;}
+    const std::string toString() const {return id;}
+    template<class Archive>
+    void serialize(Archive &ar, const unsigned int version) {ar & id;}
+};
+
+class BenchmarkGraph : public TransformGraph<FrameProp>
+{
+public:
+    /**The transform lookup as it was implemented before PathSearch existed */
+    Transform getTransformUsingVisitor(const vertex_descriptor origin,
+                                       const vertex_descriptor target) const
+    {
+        Transform tf(base::Position::Zero(), base::Orientation::Identity());
+        GraphBFSVisitor<vertex_descriptor> visit(target, graph());
+        try
+        {
+            breadthFirstSearch(origin, boost::visitor(visit));
+        }
+        catch(const FoundFrameException& e)
+        {
+            std::deque<vertex_descriptor>::iterator it = visit.tree->begin();
+            for(; (it + 1) != visit.tree->end(); ++it)
+            {
+                EdgePair pair = boost::edge(*it, *(it + 1), graph());
+                tf.transform = tf.transform * (*this)[pair.first].transform;
+            }
+            return tf;
+        }
+        throw UnknownTransformException(getFrameId(origin), getFrameId(target));
+    }
+};
+
+int main()
+{
+    Transform tf;
+    tf.transform.translation << 1, 0, 0;
+    tf.transform.orientation = base::Orientation::Identity();
+
+    reportHeader("getTransform along a chain", "visitor+throw", "PathSearch");
+    for(int depth : {2, 5, 10, 20, 50})
+    {
+        BenchmarkGraph graph;
+        for(int i = 0; i < depth; ++i)
+        {
+            graph.addTransform("frame_" + std::to_string(i),
+                               "frame_" + std::to_string(i + 1), tf);
+        }
+        const auto origin = graph.getVertex("frame_0");
+        const auto target = graph.getVertex("frame_" + std::to_string(depth));
+
+        const size_t iterations = 200000 / depth;
+        const double visitorNs = measure(iterations, [&]()
+        {
+            doNotOptimize(graph.getTransformUsingVisitor(origin, target));
+        });
+        const double searchNs = measure(iterations, [&]()
+        {
+            doNotOptimize(graph.getTransform(origin, target));
+        });
+        report("depth " + std::to_string(depth), visitorNs, searchNs);
+    }
+    return 0;
+}
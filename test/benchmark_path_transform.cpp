@@ -0,0 +1,88 @@
+//
+// Copyright (c) 2015, Deutsches Forschungszentrum für Künstliche Intelligenz GmbH.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+/**Measures getTransform() of an auto updating path with 10 hops in a chain
+ * of 100 frames. The path is either unchanged or one of its edges has been
+ * updated since the last call. Updates of edges that are not part of the
+ * path are measured as well. */
+
+#include <envire_core/graph/EnvireGraph.hpp>
+#include "benchmark.hpp"
+
+#include <cstdio>
+#include <string>
+
+using namespace envire::core;
+using namespace envire::core::benchmark;
+
+namespace
+{
+    const int numFrames = 100;
+    const int pathLength = 10;
+
+    FrameId frame(const int i)
+    {
+        return "f" + std::to_string(i);
+    }
+}
+
+int main()
+{
+    EnvireGraph graph;
+    Transform tf;
+    tf.transform.translation << 1, 0, 0;
+    for(int i = 1; i < numFrames; ++i)
+        graph.addTransform(frame(i - 1), frame(i), tf);
+
+    Path::Ptr path = graph.getPath(frame(0), frame(pathLength), true);
+
+    const double cleanNs = measure(200000, [&]()
+    {
+        doNotOptimize(graph.getTransform(path));
+    });
+
+    const double modifiedNs = measure(100000, [&]()
+    {
+        graph.updateTransform(frame(4), frame(5), tf);
+        doNotOptimize(graph.getTransform(path));
+    });
+
+    //the updates alone, to tell them apart from getTransform()
+    const double updateOnPathNs = measure(100000, [&]()
+    {
+        graph.updateTransform(frame(4), frame(5), tf);
+    });
+    const double updateOffPathNs = measure(100000, [&]()
+    {
+        graph.updateTransform(frame(50), frame(51), tf);
+    });
+
+    std::printf("%-44s %12.1f ns\n", "getTransform of an unchanged path", cleanNs);
+    std::printf("%-44s %12.1f ns\n", "update an edge on the path + getTransform", modifiedNs);
+    std::printf("%-44s %12.1f ns\n", "update an edge on the path", updateOnPathNs);
+    std::printf("%-44s %12.1f ns\n", "update an edge off the path", updateOffPathNs);
+    return 0;
+}
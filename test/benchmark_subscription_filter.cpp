@@ -0,0 +1,117 @@
+//
+// Copyright (c) 2015, Deutsches Forschungszentrum für Künstliche Intelligenz GmbH.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+
+
+/**Measures the fan-out of events to 1000 typed item dispatchers that are
+ * only interested in a few of them. The baseline resets the subscription
+ * filters, thus every event is delivered to every subscriber and dropped by
+ * the subscriber itself, like before the publisher routed events.
+ * Auto updating paths are measured by benchmark_path_registry. */
+
+#include <envire_core/graph/EnvireGraph.hpp>
+#include <envire_core/events/GraphItemEventDispatcher.hpp>
+#include <envire_core/items/Item.hpp>
+#include "benchmark.hpp"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace envire::core;
+using namespace envire::core::benchmark;
+
+namespace
+{
+    const int numSubscribers = 1000;
+
+    template <int N>
+    struct Tag {};
+
+    template <int N>
+    class Counter : public GraphItemEventDispatcher<Item<Tag<N>>>
+    {
+    public:
+        explicit Counter(EnvireGraph& graph, bool filtered) :
+            GraphItemEventDispatcher<Item<Tag<N>>>(&graph), count(0)
+        {
+            if(!filtered)
+                this->setSubscriptionFilter(SubscriptionFilter());
+        }
+        virtual void itemAdded(const TypedItemAddedEvent<Item<Tag<N>>>& e) override { ++count; }
+        std::size_t count;
+    };
+
+    /**Creates numSubscribers dispatchers for 10 item types */
+    std::vector<std::shared_ptr<GraphEventSubscriber>> createDispatchers(EnvireGraph& graph, bool filtered)
+    {
+        std::vector<std::shared_ptr<GraphEventSubscriber>> dispatchers;
+        for(int i = 0; i < numSubscribers / 10; ++i)
+        {
+            dispatchers.emplace_back(new Counter<0>(graph, filtered));
+            dispatchers.emplace_back(new Counter<1>(graph, filtered));
+            dispatchers.emplace_back(new Counter<2>(graph, filtered));
+            dispatchers.emplace_back(new Counter<3>(graph, filtered));
+            dispatchers.emplace_back(new Counter<4>(graph, filtered));
+            dispatchers.emplace_back(new Counter<5>(graph, filtered));
+            dispatchers.emplace_back(new Counter<6>(graph, filtered));
+            dispatchers.emplace_back(new Counter<7>(graph, filtered));
+            dispatchers.emplace_back(new Counter<8>(graph, filtered));
+            dispatchers.emplace_back(new Counter<9>(graph, filtered));
+        }
+        return dispatchers;
+    }
+
+    double measureItems(bool filtered, bool interesting)
+    {
+        EnvireGraph graph;
+        graph.addFrame("a");
+        auto dispatchers = createDispatchers(graph, filtered);
+        if(interesting)
+        {
+            Item<Tag<0>>::Ptr item(new Item<Tag<0>>());
+            return measure(20000, [&]()
+            {
+                graph.addItemToFrame("a", item);
+                graph.removeItemFromFrame(item);
+            });
+        }
+        Item<int>::Ptr item(new Item<int>(42));
+        return measure(20000, [&]()
+        {
+            graph.addItemToFrame("a", item);
+            graph.removeItemFromFrame(item);
+        });
+    }
+}
+
+int main()
+{
+    reportHeader("1000 subscribers", "unfiltered", "routed");
+    report("add/remove item, 100 interested", measureItems(false, true), measureItems(true, true));
+    report("add/remove item, none interested", measureItems(false, false), measureItems(true, false));
+    return 0;
+}
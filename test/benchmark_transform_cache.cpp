@@ -0,0 +1,135 @@
+//
+// Copyright (c) 2015, Deutsches Forschungszentrum für Künstliche Intelligenz GmbH.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+
+/**Measures the transform cache on a robot like kinematic tree.
+ * The tree has 100 frames, 10% of the edges are joints that are updated
+ * every cycle. The joints connect the moving links to the static body. Each cycle queries the same set of frame pairs, e.g.
+ * sensor to body transforms that are needed by the perception pipeline. */
+
+#include <envire_core/graph/TransformGraph.hpp>
+#include "benchmark.hpp"
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace envire::core;
+using namespace envire::core::benchmark;
+
+class FrameProp
+{
+public:
+    std::string id;
+    const std::string& getId() const {return id;}
+    void setId(const std::string& _id) {id = _id;}
+    const std::string toString() const {return id;}
+    template<class Archive>
+    void serialize(Archive &ar, const unsigned int version) {ar & id;}
+};
+
+using Tfg = TransformGraph<FrameProp>;
+using vertex_descriptor = GraphTraits::vertex_descriptor;
+
+static const int numFrames = 100;
+static const int staticFrames = 90;
+static const int numQueries = 40;
+
+struct Robot
+{
+    Tfg graph;
+    std::vector<std::pair<vertex_descriptor, vertex_descriptor>> joints;
+    std::vector<std::pair<vertex_descriptor, vertex_descriptor>> queries;
+};
+
+void buildRobot(Robot& robot)
+{
+    std::mt19937 rng(42);
+    Transform tf;
+    tf.transform.translation << 0.1, 0, 0.05;
+    tf.transform.orientation = base::AngleAxisd(0.1, base::Vector3d::UnitX());
+    for(int i = 1; i < numFrames; ++i)
+    {
+        //the static body and sensor mounts, the last 10% are moving links
+        const int parent = std::uniform_int_distribution<int>(0, std::min(i, staticFrames) - 1)(rng);
+        robot.graph.addTransform("frame_" + std::to_string(parent), "frame_" + std::to_string(i), tf);
+        if(i >= staticFrames)
+        {
+            robot.joints.emplace_back(robot.graph.getVertex("frame_" + std::to_string(parent)),
+                                      robot.graph.getVertex("frame_" + std::to_string(i)));
+        }
+    }
+    std::uniform_int_distribution<int> frame(0, numFrames - 1);
+    for(int i = 0; i < numQueries; ++i)
+    {
+        robot.queries.emplace_back(robot.graph.getVertex("frame_" + std::to_string(frame(rng))),
+                                   robot.graph.getVertex("frame_" + std::to_string(frame(rng))));
+    }
+}
+
+/** @return the duration of one cycle.
+ *  @param updateJoints if false the graph does not change at all */
+double runCycles(Robot& robot, const bool updateJoints)
+{
+    Transform joint;
+    double angle = 0;
+    return measure(2000, [&]()
+    {
+        if(updateJoints)
+        {
+            angle += 0.001;
+            joint.transform.orientation = base::AngleAxisd(angle, base::Vector3d::UnitZ());
+            for(const auto& j : robot.joints)
+                robot.graph.updateTransform(j.first, j.second, joint);
+        }
+        for(const auto& q : robot.queries)
+            doNotOptimize(robot.graph.getTransform(q.first, q.second));
+    });
+}
+
+int main()
+{
+    Robot robot;
+    buildRobot(robot);
+    const double uncachedStatic = runCycles(robot, false);
+    const double uncached = runCycles(robot, true);
+    robot.graph.enableTransformCache();
+    const double cachedStatic = runCycles(robot, false);
+    const Tfg::Cache& cache = *robot.graph.getTransformCache();
+    const double staticHits = cache.getHits();
+    const double staticMisses = cache.getMisses();
+    const double cached = runCycles(robot, true);
+    const double hits = cache.getHits() - staticHits;
+    const double misses = cache.getMisses() - staticMisses;
+
+    reportHeader("100 frames, 10 joints updated per cycle, 40 queries per cycle",
+                 "uncached", "cached");
+    report("query only cycle", uncachedStatic, cachedStatic);
+    report("update and query cycle", uncached, cached);
+    std::printf("cache hit rate with updates %.1f%%\n", 100.0 * hits / (hits + misses));
+    return 0;
+}
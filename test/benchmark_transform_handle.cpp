@@ -0,0 +1,81 @@
+//
+// Copyright (c) 2015, Deutsches Forschungszentrum für Künstliche Intelligenz GmbH.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+/**Simulates a joint state stream of 100 joints at 1 kHz.
+ * Compares updateTransform(FrameId, FrameId, tf) with updates through
+ * TransformHandles. One cycle updates all joints once. */
+
+#include <envire_core/graph/EnvireGraph.hpp>
+#include "benchmark.hpp"
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+using namespace envire::core;
+using namespace envire::core::benchmark;
+
+static const int numJoints = 100;
+
+int main()
+{
+    EnvireGraph graph;
+    Transform tf;
+    tf.transform.translation << 0.1, 0, 0;
+    tf.transform.orientation = base::Orientation::Identity();
+    //a map frame with many static children and a robot with a chain of joints
+    for(int i = 0; i < 1000; ++i)
+        graph.addTransform("map", "landmark_" + std::to_string(i), tf);
+    graph.addTransform("map", "body", tf);
+    std::vector<std::pair<FrameId, FrameId>> joints;
+    for(int i = 0; i < numJoints; ++i)
+    {
+        const FrameId parent = i == 0 ? "body" : "link_" + std::to_string(i - 1);
+        joints.emplace_back(parent, "link_" + std::to_string(i));
+        graph.addTransform(joints.back().first, joints.back().second, tf);
+    }
+
+    std::vector<TransformHandle> handles;
+    for(const auto& joint : joints)
+        handles.push_back(graph.getTransformHandle(joint.first, joint.second));
+
+    const double stringNs = measure(2000, [&]()
+    {
+        for(const auto& joint : joints)
+            graph.updateTransform(joint.first, joint.second, tf);
+    });
+    const double handleNs = measure(2000, [&]()
+    {
+        for(const TransformHandle& handle : handles)
+            graph.updateTransform(handle, tf);
+    });
+
+    reportHeader("100 joints, one cycle", "FrameId", "TransformHandle");
+    report("update all joints", stringNs, handleNs);
+    std::printf("share of a 1 kHz cycle: %.2f%% -> %.2f%%\n",
+                stringNs / 1e4, handleNs / 1e4);
+    return 0;
+}
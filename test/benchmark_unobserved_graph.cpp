@@ -0,0 +1,96 @@
+//
+// Copyright (c) 2015, Deutsches Forschungszentrum für Künstliche Intelligenz GmbH.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+
+
+/**Measures modifications of a graph that nobody observes. The baseline
+ * graph has a subscriber that accepts all events but does nothing, the
+ * difference is the cost of creating and publishing the events. */
+
+#include <envire_core/graph/EnvireGraph.hpp>
+#include <envire_core/events/GraphEventSubscriber.hpp>
+#include <envire_core/items/Item.hpp>
+#include "benchmark.hpp"
+
+#include <memory>
+
+using namespace envire::core;
+using namespace envire::core::benchmark;
+
+namespace
+{
+    const std::size_t iterations = 200000;
+
+    class NoOpSubscriber : public GraphEventSubscriber
+    {
+    public:
+        virtual void notifyGraphEvent(const GraphEvent& event) override {}
+    };
+
+    template <class FUNC>
+    void compare(const char* name, FUNC func)
+    {
+        EnvireGraph observed;
+        NoOpSubscriber subscriber;
+        subscriber.subscribe(&observed);
+        EnvireGraph unobserved;
+        const double observedNs = measure(iterations, [&]() { func(observed); });
+        const double unobservedNs = measure(iterations, [&]() { func(unobserved); });
+        report(name, observedNs, unobservedNs);
+    }
+}
+
+int main()
+{
+    Transform tf;
+    Item<int>::Ptr item(new Item<int>(42));
+
+    reportHeader("Modifications per call", "observed", "unobserved");
+    compare("updateTransform", [&](EnvireGraph& graph)
+    {
+        if(!graph.containsFrame("a"))
+            graph.addTransform("a", "b", tf);
+        graph.updateTransform("a", "b", tf);
+    });
+    compare("addItemToFrame + removeItemFromFrame", [&](EnvireGraph& graph)
+    {
+        if(!graph.containsFrame("a"))
+            graph.addFrame("a");
+        graph.addItemToFrame("a", item);
+        graph.removeItemFromFrame(item);
+    });
+    compare("addTransform + removeTransform", [&](EnvireGraph& graph)
+    {
+        graph.addTransform("a", "b", tf);
+        graph.removeTransform("a", "b");
+    });
+    compare("addFrame + removeFrame", [&](EnvireGraph& graph)
+    {
+        graph.addFrame("a");
+        graph.removeFrame("a");
+    });
+    return 0;
+}
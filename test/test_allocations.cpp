@@ -0,0 +1,94 @@
+#include <boost/test/unit_test.hpp>
+
+#include <envire_core/graph/TransformGraph.hpp>
+
+#include <cstdlib>
+#include <new>
+#include <string>
+
+using namespace envire::core;
+
+//the global operator new is replaced to count the allocations. This file
+//has its own test suite, thus the other tests are not affected.
+namespace
+{
+    /**Number of heap allocations of the current thread */
+    thread_local size_t allocationCount = 0;
+}
+
+void* operator new(std::size_t size)
+{
+    ++allocationCount;
+    void* p = std::malloc(size == 0 ? 1 : size);
+    if(p == nullptr)
+        throw std::bad_alloc();
+    return p;
+}
+
+void operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+namespace
+{
+    class WorkspaceFrame
+    {
+    public:
+        std::string id;
+        const std::string& getId() const {return id;}
+        void setId(const std::string& _id) {id = _id;}
+        const std::string toString() const {return id;}
+        template<class Archive>
+        void serialize(Archive &ar, const unsigned int version) {ar & id;}
+    };
+
+    struct CountingVisitor : public boost::default_bfs_visitor
+    {
+        CountingVisitor(size_t& count) : count(count) {}
+        template <class Vertex, class Graph>
+        void discover_vertex(Vertex, const Graph&) { ++count; }
+        size_t& count;
+    };
+}
+
+BOOST_AUTO_TEST_CASE(get_transform_does_not_allocate_test)
+{
+    TransformGraph<WorkspaceFrame> graph;
+    Transform tf;
+    tf.transform.translation << 1, 2, 3;
+    tf.transform.orientation = base::Orientation::Identity();
+    for(int i = 0; i < 20; ++i)
+    {
+        graph.addTransform("frame_" + std::to_string(i),
+                           "frame_" + std::to_string(i + 1), tf);
+        graph.addTransform("frame_" + std::to_string(i),
+                           "leaf_" + std::to_string(i), tf);
+    }
+    const auto origin = graph.getVertex("frame_0");
+    const auto target = graph.getVertex("frame_20");
+    const auto leaf = graph.getVertex("leaf_10");
+
+    //the first queries may grow the workspace
+    Transform result = graph.getTransform(origin, target);
+    result = graph.getTransform(target, leaf);
+    size_t visited = 0;
+    graph.breadthFirstSearch(origin, boost::visitor(CountingVisitor(visited)));
+
+    const size_t allocationsBefore = allocationCount;
+    BOOST_REQUIRE(allocationsBefore > 0); //the counter is active
+    for(int i = 0; i < 100; ++i)
+    {
+        result = graph.getTransform(origin, target);
+        result = graph.getTransform(target, leaf);
+        graph.breadthFirstSearch(origin, boost::visitor(CountingVisitor(visited)));
+    }
+    BOOST_CHECK_EQUAL(allocationCount, allocationsBefore);
+    BOOST_CHECK_EQUAL(visited, 101 * graph.num_vertices());
+    BOOST_CHECK(result.transform.translation.isApprox(base::Position(-9, -18, -27)));
+}
@@ -32,6 +32,11 @@
 #include <envire_core/events/GraphItemEventDispatcher.hpp>
 #include <envire_core/items/Item.hpp>
 #include <envire_core/graph/GraphDrawing.hpp>
+#include <envire_core/graph/GraphTransaction.hpp>
+#include <envire_core/graph/GraphSnapshot.hpp>
+#include <envire_core/graph/ConcurrentEnvireGraph.hpp>
+#include <atomic>
+#include <thread>
 #include <vector>
 
 
@@ -813,3 +818,365 @@ BOOST_AUTO_TEST_CASE(bfs_visitor_test)
     BOOST_CHECK_NO_THROW(graph.getFrames(a, a));
 }
 
+
+BOOST_AUTO_TEST_CASE(envire_graph_transaction_abort_test)
+{
+    EnvireGraph graph;
+    const FrameId a = "a";
+    const FrameId b = "b";
+    Transform tf;
+    graph.addTransform(a, b, tf);
+    Item<string>::Ptr kept(new Item<string>("kept"));
+    Item<string>::Ptr removed(new Item<string>("removed"));
+    graph.addItemToFrame(a, kept);
+    graph.addItemToFrame(b, removed);
+    EnvireDispatcher d(graph);
+
+    {
+        GraphTransaction<EnvireGraph> transaction(graph);
+        Item<string>::Ptr added(new Item<string>("added"));
+        graph.addItemToFrame(a, added);
+        graph.removeItemFromFrame(kept);
+        graph.disconnectFrame(b);
+        graph.removeFrame(b);
+        BOOST_CHECK(!graph.containsFrame(b));
+    }
+    BOOST_CHECK(graph.containsEdge(a, b));
+    BOOST_CHECK_EQUAL(graph.getItemCount<Item<string>>(a), 1);
+    BOOST_CHECK(graph.getItem<Item<string>>(a)->getData() == "kept");
+    BOOST_CHECK_EQUAL(graph.getItemCount<Item<string>>(b), 1);
+    BOOST_CHECK(removed->getFrame() == b);
+    //the removed items are re-added, the added item cancels out
+    BOOST_CHECK_EQUAL(d.itemRemovedEvents.size(), 2);
+    BOOST_CHECK_EQUAL(d.itemAddedEvents.size(), 2);
+}
+
+BOOST_AUTO_TEST_CASE(envire_graph_snapshot_test)
+{
+    EnvireGraph graph;
+    Transform ab(base::Position(1, 0, 0), base::Orientation::Identity());
+    Transform bc(base::Position(0, 2, 0), base::Orientation(base::AngleAxisd(0.5, base::Vector3d::UnitZ())));
+    graph.addTransform("a", "b", ab);
+    graph.addTransform("b", "c", bc);
+    Item<string>::Ptr item(new Item<string>("item"));
+    graph.addItemToFrame("b", item);
+
+    //the builder copies the existing graph
+    GraphSnapshotBuilder builder(graph);
+    const GraphSnapshot first = builder.snapshot();
+    BOOST_CHECK_EQUAL(first.num_vertices(), 3);
+    BOOST_CHECK_EQUAL(first.num_edges(), 4);
+    BOOST_CHECK(first.containsEdge("c", "b"));
+    BOOST_CHECK(!first.containsEdge("a", "c"));
+    BOOST_CHECK(first.getTransform("a", "c").transform.translation.isApprox(
+                graph.getTransform("a", "c").transform.translation));
+    BOOST_CHECK(first.getTransform("c", "a").transform.orientation.isApprox(
+                graph.getTransform("c", "a").transform.orientation));
+    BOOST_CHECK_EQUAL(first.getItems("b", item->getTypeIndex()).size(), 1);
+    BOOST_CHECK_THROW(first.getItems("a", item->getTypeIndex()), NoItemsOfTypeInFrameException);
+    BOOST_CHECK_THROW(first.getTransform("a", "x"), UnknownFrameException);
+
+    //later modifications do not change the first snapshot
+    Transform moved(base::Position(5, 0, 0), base::Orientation::Identity());
+    graph.updateTransform("a", "b", moved);
+    graph.addTransform("x", "y", ab);
+    graph.removeItemFromFrame(item);
+    graph.disconnectFrame("c");
+    graph.removeFrame("c");
+    const GraphSnapshot second = builder.snapshot();
+
+    BOOST_CHECK(first.containsFrame("c"));
+    BOOST_CHECK(!first.containsFrame("x"));
+    BOOST_CHECK_EQUAL(first.getTransform("b", "a").transform.translation.x(), -1);
+    BOOST_CHECK_EQUAL(first.getTotalItemCount("b"), 1);
+
+    BOOST_CHECK(!second.containsFrame("c"));
+    BOOST_CHECK_EQUAL(second.num_vertices(), 4);
+    BOOST_CHECK_EQUAL(second.getTransform("b", "a").transform.translation.x(), -5);
+    BOOST_CHECK_EQUAL(second.getTotalItemCount("b"), 0);
+    BOOST_CHECK_THROW(second.getTransform("a", "x"), UnknownTransformException);
+
+    //frames and edges that have been removed and added again
+    graph.addTransform("b", "c", bc);
+    BOOST_CHECK(builder.snapshot().getTransform("a", "c").transform.translation.isApprox(
+                graph.getTransform("a", "c").transform.translation));
+}
+
+BOOST_AUTO_TEST_CASE(envire_graph_snapshot_threads_test)
+{
+    EnvireGraph graph;
+    Transform tf(base::Position(0, 0, 0), base::Orientation::Identity());
+    for(int i = 1; i < 200; ++i)
+    {
+        graph.addTransform("frame_" + std::to_string(i / 2), "frame_" + std::to_string(i), tf);
+    }
+    GraphSnapshotBuilder builder(graph);
+    std::shared_ptr<const GraphSnapshot> published(new GraphSnapshot(builder.snapshot()));
+    std::atomic<bool> done(false);
+    std::atomic<int> errors(0);
+
+    //the readers check that each snapshot is consistent: all edges on the
+    //path have been written in the same round
+    std::vector<std::thread> readers;
+    for(int r = 0; r < 3; ++r)
+    {
+        readers.emplace_back([&]()
+        {
+            while(!done)
+            {
+                std::shared_ptr<const GraphSnapshot> snapshot = std::atomic_load(&published);
+                const Transform path = snapshot->getTransform("frame_0", "frame_199");
+                //the 8 edges between frame_0 and frame_199 translate by
+                //(round, round^2). sum(x)^2 == 8 * sum(y) iff all rounds are equal
+                const double x = path.transform.translation.x();
+                const double y = path.transform.translation.y();
+                if(x * x != 8 * y)
+                    ++errors;
+            }
+        });
+    }
+    for(int round = 1; round <= 200; ++round)
+    {
+        tf.transform.translation.x() = round;
+        tf.transform.translation.y() = round * round;
+        for(int i = 1; i < 200; ++i)
+        {
+            graph.updateTransform("frame_" + std::to_string(i / 2), "frame_" + std::to_string(i), tf);
+        }
+        std::atomic_store(&published, std::shared_ptr<const GraphSnapshot>(new GraphSnapshot(builder.snapshot())));
+    }
+    done = true;
+    for(std::thread& reader : readers)
+    {
+        reader.join();
+    }
+    BOOST_CHECK_EQUAL(errors, 0);
+}
+
+/**Queries the graph while the events are delivered */
+class ConcurrentSubscriber : public GraphEventDispatcher
+{
+public:
+    ConcurrentSubscriber(ConcurrentEnvireGraph& graph) : graph(graph) {}
+    ConcurrentEnvireGraph& graph;
+    vector<size_t> itemCounts;
+    int framesAdded = 0;
+    int edgesAdded = 0;
+
+    void frameAdded(const FrameAddedEvent& e) override { ++framesAdded; }
+    void edgeAdded(const EdgeAddedEvent& e) override { ++edgesAdded; }
+    void itemAdded(const ItemAddedEvent& e) override
+    {
+        //this would deadlock if the events were delivered under the lock
+        itemCounts.push_back(graph.getTotalItemCount(e.frame.str()));
+        if(itemCounts.size() == 1)
+        {
+            //modifications of subscribers are delivered afterwards
+            graph.addItemToFrame(e.frame.str(), Item<string>::Ptr(new Item<string>("nested")));
+        }
+    }
+};
+
+BOOST_AUTO_TEST_CASE(concurrent_envire_graph_test)
+{
+    ConcurrentEnvireGraph graph;
+    Transform tf(base::Position(1, 0, 0), base::Orientation::Identity());
+    graph.addTransform("a", "b", tf);
+
+    ConcurrentSubscriber subscriber(graph);
+    subscriber.subscribe(&graph, true);
+    BOOST_CHECK_EQUAL(subscriber.framesAdded, 2);
+    BOOST_CHECK_EQUAL(subscriber.edgesAdded, 1);
+
+    graph.addItemToFrame("b", Item<string>::Ptr(new Item<string>("item")));
+    BOOST_CHECK_EQUAL(subscriber.itemCounts.size(), 2);
+    BOOST_CHECK_EQUAL(subscriber.itemCounts[0], 1);
+    BOOST_CHECK_EQUAL(subscriber.itemCounts[1], 2);
+    BOOST_CHECK_EQUAL(graph.getItems("b", typeid(Item<string>)).size(), 2);
+
+    //events of failed modifications are delivered as well
+    BOOST_CHECK_THROW(graph.write([](EnvireGraph& g)
+    {
+        g.addFrame("c");
+        g.removeFrame("x");
+    }), UnknownFrameException);
+    BOOST_CHECK_EQUAL(subscriber.framesAdded, 3);
+    BOOST_CHECK(graph.read([](const EnvireGraph& g) { return g.containsFrame("c"); }));
+
+    //readers run while one thread modifies the graph
+    std::atomic<bool> done(false);
+    std::atomic<int> errors(0);
+    std::vector<std::thread> readers;
+    for(int r = 0; r < 3; ++r)
+    {
+        readers.emplace_back([&]()
+        {
+            while(!done)
+            {
+                const Transform ab = graph.getTransform("a", "b");
+                if(ab.transform.translation.y() != 0)
+                    ++errors;
+                graph.containsEdge("a", "b");
+            }
+        });
+    }
+    for(int i = 0; i < 200; ++i)
+    {
+        tf.transform.translation.x() = i;
+        graph.updateTransform("a", "b", tf);
+        graph.addTransform("b", "d", tf);
+        graph.removeTransform("b", "d");
+        graph.removeFrame("d");
+    }
+    done = true;
+    for(std::thread& reader : readers)
+    {
+        reader.join();
+    }
+    BOOST_CHECK_EQUAL(errors, 0);
+    BOOST_CHECK_EQUAL(graph.getTransform("b", "a").transform.translation.x(), -199);
+    BOOST_CHECK_EQUAL(subscriber.edgesAdded, 201);
+    BOOST_CHECK_EQUAL(graph.num_vertices(), 3);
+}
+
+/**Throws when a frame is added */
+class ThrowingFrameSubscriber : public GraphEventDispatcher
+{
+public:
+    int framesAdded = 0;
+    void frameAdded(const FrameAddedEvent& e) override
+    {
+        ++framesAdded;
+        throw std::runtime_error("frameAdded");
+    }
+};
+
+BOOST_AUTO_TEST_CASE(concurrent_envire_graph_failure_test)
+{
+    ConcurrentEnvireGraph graph;
+    ThrowingFrameSubscriber subscriber;
+    subscriber.subscribe(&graph);
+
+    //the exception of the subscriber is passed on if the modification succeeded
+    BOOST_CHECK_THROW(graph.addFrame("a"), std::runtime_error);
+    BOOST_CHECK_EQUAL(subscriber.framesAdded, 1);
+
+    //otherwise the events are delivered and the exception of the modification is passed on
+    BOOST_CHECK_THROW(graph.write([](EnvireGraph& g)
+    {
+        g.addFrame("b");
+        g.removeFrame("x");
+    }), UnknownFrameException);
+    BOOST_CHECK_EQUAL(subscriber.framesAdded, 2);
+    BOOST_CHECK(graph.containsFrame("b"));
+
+    //caches that readers would fill in parallel are disabled again
+    const int value = graph.write([](EnvireGraph& g)
+    {
+        g.enableLazyInverseEdges();
+        g.enableTransformCache();
+        return 42;
+    });
+    BOOST_CHECK_EQUAL(value, 42);
+    BOOST_CHECK(!graph.read([](const EnvireGraph& g) { return g.isLazyInverseEdgesEnabled(); }));
+    BOOST_CHECK(!graph.read([](const EnvireGraph& g) { return g.isTransformCacheEnabled(); }));
+}
+
+class CountingItemSubscriber : public GraphEventDispatcher
+{
+public:
+    std::atomic<int> added;
+    std::atomic<int> removed;
+    CountingItemSubscriber() : added(0), removed(0) {}
+    void itemAdded(const ItemAddedEvent& e) override { ++added; }
+    void itemRemoved(const ItemRemovedEvent& e) override { ++removed; }
+};
+
+BOOST_AUTO_TEST_CASE(concurrent_item_ingestion_test)
+{
+    EnvireGraph graph;
+    const int numFrames = 4;
+    const int itemsPerThread = 2000;
+    for(int i = 0; i < numFrames; ++i)
+        graph.addFrame("frame_" + std::to_string(i));
+    CountingItemSubscriber subscriber;
+    subscriber.subscribe(&graph);
+
+    //two producers per frame, every second item is removed again
+    std::vector<std::thread> producers;
+    for(int p = 0; p < 2 * numFrames; ++p)
+    {
+        producers.emplace_back([&graph, p, itemsPerThread]()
+        {
+            const FrameId frame = "frame_" + std::to_string(p % numFrames);
+            for(int i = 0; i < itemsPerThread; ++i)
+            {
+                Item<int>::Ptr item(new Item<int>(i));
+                graph.addItemToFrame(frame, item);
+                if(i % 2 == 0)
+                    graph.removeItemFromFrame(item);
+            }
+        });
+    }
+    for(std::thread& producer : producers)
+        producer.join();
+
+    for(int i = 0; i < numFrames; ++i)
+    {
+        BOOST_CHECK_EQUAL(graph.getItemCount<Item<int>>("frame_" + std::to_string(i)), itemsPerThread);
+    }
+    BOOST_CHECK_EQUAL(subscriber.added, 2 * numFrames * itemsPerThread);
+    BOOST_CHECK_EQUAL(subscriber.removed, numFrames * itemsPerThread);
+
+    //the facade adds items under the shared lock
+    ConcurrentEnvireGraph concurrent;
+    concurrent.addFrame("a");
+    concurrent.addFrame("b");
+    CountingItemSubscriber facadeSubscriber;
+    facadeSubscriber.subscribe(&concurrent);
+    std::vector<std::thread> drivers;
+    for(const FrameId& frame : {"a", "b"})
+    {
+        drivers.emplace_back([&concurrent, frame, itemsPerThread]()
+        {
+            for(int i = 0; i < itemsPerThread; ++i)
+                concurrent.addItemToFrame(frame, Item<int>::Ptr(new Item<int>(i)));
+        });
+    }
+    for(std::thread& driver : drivers)
+        driver.join();
+    BOOST_CHECK_EQUAL(concurrent.getTotalItemCount("a"), itemsPerThread);
+    BOOST_CHECK_EQUAL(concurrent.getItems("b", typeid(Item<int>)).size(), itemsPerThread);
+    BOOST_CHECK_EQUAL(facadeSubscriber.added, 2 * itemsPerThread);
+}
+
+BOOST_AUTO_TEST_CASE(subscribe_during_concurrent_notify_test)
+{
+    EnvireGraph graph;
+    graph.addFrame("a");
+    graph.addFrame("b");
+    CountingItemSubscriber subscriber;
+    subscriber.subscribe(&graph);
+
+    //subscribers come and go while items are added from several threads
+    const int itemsPerThread = 2000;
+    std::vector<std::thread> producers;
+    for(const FrameId& frame : {"a", "b"})
+    {
+        producers.emplace_back([&graph, frame, itemsPerThread]()
+        {
+            for(int i = 0; i < itemsPerThread; ++i)
+                graph.addItemToFrame(frame, Item<int>::Ptr(new Item<int>(i)));
+        });
+    }
+    for(int i = 0; i < 200; ++i)
+    {
+        CountingItemSubscriber temporary;
+        temporary.setSubscriptionFilter(SubscriptionFilter().addFrame("b"));
+        temporary.subscribe(&graph);
+        temporary.unsubscribe();
+    }
+    for(std::thread& producer : producers)
+        producer.join();
+    BOOST_CHECK_EQUAL(subscriber.added, 2 * itemsPerThread);
+}
@@ -0,0 +1,120 @@
+#include <boost/test/unit_test.hpp>
+#define protected public
+#include <envire_core/items/FrameSymbol.hpp>
+#include <envire_core/graph/EnvireGraph.hpp>
+#include <envire_core/events/GraphEventDispatcher.hpp>
+#include <envire_core/events/FrameEvents.hpp>
+#include <envire_core/events/EdgeEvents.hpp>
+#include <envire_core/graph/Path.hpp>
+
+#include <boost/archive/binary_oarchive.hpp>
+#include <boost/archive/binary_iarchive.hpp>
+#include <sstream>
+#include <unordered_set>
+
+using namespace envire::core;
+
+BOOST_AUTO_TEST_CASE(frame_symbol_interning_test)
+{
+    const FrameSymbol a("symbol_test_a");
+    const FrameSymbol b(std::string("symbol_test_a"));
+    const FrameSymbol c("symbol_test_c");
+    BOOST_CHECK(a == b);
+    BOOST_CHECK(&a.str() == &b.str());
+    BOOST_CHECK(a != c);
+    BOOST_CHECK(a == "symbol_test_a");
+    BOOST_CHECK(std::string("symbol_test_a") == a);
+    BOOST_CHECK(a < c);
+    BOOST_CHECK_EQUAL(a.hash(), b.hash());
+    BOOST_CHECK(FrameSymbol().empty());
+    BOOST_CHECK(FrameSymbol("") == FrameSymbol());
+
+    const std::size_t size = FrameSymbol::tableSize();
+    BOOST_CHECK(FrameSymbol::lookup("symbol_test_never_interned").empty());
+    BOOST_CHECK_EQUAL(FrameSymbol::tableSize(), size);
+    BOOST_CHECK(FrameSymbol::lookup("symbol_test_c") == c);
+
+    std::unordered_set<FrameSymbol> set = {a, b, c};
+    BOOST_CHECK_EQUAL(set.size(), 2);
+
+    std::stringstream out;
+    out << c;
+    BOOST_CHECK_EQUAL(out.str(), "symbol_test_c");
+}
+
+class SymbolRecorder : public GraphEventDispatcher
+{
+public:
+    SymbolRecorder(GraphEventPublisher* graph) : GraphEventDispatcher(graph) {}
+    virtual void frameAdded(const FrameAddedEvent& e) { frames.push_back(e.frame); }
+    virtual void edgeAdded(const EdgeAddedEvent& e) { edges.push_back(e.origin); }
+    std::vector<FrameSymbol> frames;
+    std::vector<FrameSymbol> edges;
+};
+
+BOOST_AUTO_TEST_CASE(graph_events_share_frame_symbols_test)
+{
+    EnvireGraph graph;
+    SymbolRecorder recorder(&graph);
+    graph.addTransform("symbol_origin", "symbol_target", Transform());
+
+    BOOST_CHECK_EQUAL(recorder.frames.size(), 2);
+    BOOST_CHECK(recorder.frames[0] == "symbol_origin");
+    BOOST_CHECK(recorder.edges[0] == recorder.frames[0]);
+    const GraphTraits::vertex_descriptor origin = graph.getVertex("symbol_origin");
+    BOOST_CHECK(&graph.getFrameSymbol(origin).str() == &recorder.frames[0].str());
+    BOOST_CHECK(graph.getFrameSymbol(origin) == graph.getFrameProperty("symbol_origin").id);
+
+    //the symbols survive copies and removals of other frames
+    graph.addFrame("symbol_other");
+    graph.removeFrame("symbol_other");
+    EnvireGraph copy(graph);
+    BOOST_CHECK(copy.getFrameSymbol(copy.getVertex("symbol_target")) == "symbol_target");
+    BOOST_CHECK_THROW(graph.getFrameSymbol(EnvireGraph::null_vertex()), NullVertexException);
+}
+
+/**The layout of Frame before the id was interned */
+struct StringFrame
+{
+    FrameId id;
+    Frame::ItemMap items;
+    template<class Archive>
+    void serialize(Archive & ar, const unsigned int version)
+    {
+        ar & BOOST_SERIALIZATION_NVP(id);
+        ar & BOOST_SERIALIZATION_NVP(items);
+    }
+};
+
+BOOST_AUTO_TEST_CASE(frame_symbol_serialization_test)
+{
+    //the interned id is serialized exactly like the string it replaces
+    const Frame frame("symbol_serialized");
+    StringFrame stringFrame;
+    stringFrame.id = "symbol_serialized";
+    std::stringstream frameStream;
+    {
+        boost::archive::binary_oarchive oa(frameStream);
+        oa << frame;
+    }
+    std::stringstream stringStream;
+    {
+        boost::archive::binary_oarchive oa(stringStream);
+        oa << stringFrame;
+    }
+    BOOST_CHECK(frameStream.str() == stringStream.str());
+
+    Frame loadedFrame;
+    {
+        boost::archive::binary_iarchive ia(stringStream);
+        ia >> loadedFrame;
+    }
+    BOOST_CHECK(loadedFrame.id == frame.id);
+
+    EnvireGraph graph;
+    graph.addFrame("symbol_serialized");
+    graph.saveToFile("frame_symbol_test_graph");
+    EnvireGraph loaded;
+    loaded.loadFromFile("frame_symbol_test_graph");
+    BOOST_CHECK(loaded.getFrameSymbol(loaded.getVertex("symbol_serialized")) == frame.id);
+}
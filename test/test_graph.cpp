@@ -35,8 +35,15 @@
 #include <envire_core/graph/Graph.hpp>
 #include <envire_core/events/GraphEventDispatcher.hpp>
 #include <envire_core/graph/GraphDrawing.hpp>
+#include <envire_core/graph/GraphTransaction.hpp>
 #include <envire_core/events/GraphEventQueue.hpp>
+#include <envire_core/events/ConcurrentGraphEventQueue.hpp>
+#include <envire_core/events/AsyncGraphEventSubscriber.hpp>
 #include <vector>
+#include <atomic>
+#include <thread>
+#include <memory>
+#include <stdexcept>
 #include <string>
  
 using namespace envire::core;
@@ -155,6 +162,21 @@ public:
     vector<GraphEvent> events;
 };
 
+class ConcurrentEventQueue : public ConcurrentGraphEventQueue
+{
+public:
+    ConcurrentEventQueue(Gra& graph, std::size_t capacity, OverflowPolicy policy) :
+        ConcurrentGraphEventQueue(&graph, capacity, policy) {}
+
+    virtual void process(const GraphEvent& event)
+    {
+        dispatcher.notifyGraphEvent(event);
+    }
+
+    Dispatcher dispatcher;
+};
+
+
 BOOST_AUTO_TEST_CASE(simple_add_remove_edge_test)
 {
     FrameId a = "frame_a";
@@ -980,6 +1002,58 @@ BOOST_AUTO_TEST_CASE(get_updating_path2_test)
 
 
 
+BOOST_AUTO_TEST_CASE(path_registry_test)
+{
+    std::shared_ptr<Path> detached;
+    {
+        Gra graph;
+        EdgeProp ep;
+        graph.add_edge("A", "B", ep);
+        graph.add_edge("B", "C", ep);
+        graph.addFrame("D");
+        BOOST_CHECK(graph.getPathRegistry() == nullptr);
+
+        //paths with the same origin and target are shared
+        std::shared_ptr<Path> ac = graph.getPath("A", "C", true);
+        BOOST_CHECK(graph.getPath("A", "C", true) == ac);
+        std::shared_ptr<Path> ca = graph.getPath("C", "A", true);
+        BOOST_CHECK(ca != ac);
+        std::shared_ptr<Path> ad = graph.getPath("A", "D", true);
+        BOOST_CHECK(ad->isEmpty());
+        BOOST_REQUIRE(graph.getPathRegistry() != nullptr);
+        BOOST_CHECK_EQUAL(graph.getPathRegistry()->size(), 3);
+
+        //both directions of the removed edge are noticed
+        graph.remove_edge("A", "B");
+        BOOST_CHECK(ac->isDirty());
+        BOOST_CHECK(ca->isDirty());
+        BOOST_CHECK(!ad->isDirty());
+
+        //dirty and empty paths are searched again
+        graph.add_edge("A", "B", ep);
+        graph.add_edge("C", "D", ep);
+        BOOST_CHECK(graph.getPath("A", "C", true) == ac);
+        BOOST_CHECK(!ac->isDirty());
+        BOOST_CHECK_EQUAL(ac->getSize(), 3);
+        BOOST_CHECK(graph.getPath("A", "D", true) == ad);
+        BOOST_CHECK_EQUAL(ad->getSize(), 4);
+        graph.remove_edge("C", "D");
+        BOOST_CHECK(ad->isDirty());
+        BOOST_CHECK(!ac->isDirty());
+
+        //dropped paths are unregistered
+        ca.reset();
+        ad.reset();
+        BOOST_CHECK_EQUAL(graph.getPathRegistry()->size(), 1);
+        detached = ac;
+    }
+    //the graph is gone
+    BOOST_CHECK(!detached->isAutoUpdating());
+    BOOST_CHECK(!detached->isDirty());
+    BOOST_CHECK_EQUAL(detached->getSize(), 3);
+}
+
+
 BOOST_AUTO_TEST_CASE(remove_unknown_frame_test)
 {
     FrameId a = "frame_a";
@@ -1623,5 +1697,633 @@ BOOST_AUTO_TEST_CASE(event_queue_test)
     BOOST_CHECK(queue.dispatcher.edgeRemovedEvents.size() == 0);
 }
 
+BOOST_AUTO_TEST_CASE(event_queue_statistics_test)
+{
+    Gra graph;
+    EventQueue queue(graph);
+    EdgeProp ep;
+
+    graph.add_edge("a", "b", ep);
+    BOOST_CHECK_EQUAL(queue.size(), 3);
+    for(int i = 0; i < 1000; ++i)
+    {
+        graph.setEdgeProperty("a", "b", ep);
+        graph.setEdgeProperty("b", "a", ep);
+    }
+    //only the last modification is kept, no matter the direction
+    BOOST_CHECK_EQUAL(queue.size(), 4);
+    BOOST_CHECK_EQUAL(queue.getMaxSize(), 4);
+    BOOST_CHECK_EQUAL(queue.getMergeCount(), 1999);
+
+    //the frame and all events of the edge cancel out
+    graph.addFrame("c");
+    graph.add_edge("a", "c", ep);
+    graph.setEdgeProperty("a", "c", ep);
+    BOOST_CHECK_EQUAL(queue.size(), 7);
+    graph.remove_edge("a", "c");
+    graph.removeFrame("c");
+    BOOST_CHECK_EQUAL(queue.size(), 4);
+    BOOST_CHECK_EQUAL(queue.getMaxSize(), 7);
+    BOOST_CHECK_EQUAL(queue.getMergeCount(), 1999 + 5);
+
+    queue.flush();
+    BOOST_CHECK_EQUAL(queue.size(), 0);
+    BOOST_CHECK_EQUAL(queue.dispatcher.frameAddedEvents.size(), 2);
+    BOOST_CHECK_EQUAL(queue.dispatcher.edgeAddedEvents.size(), 1);
+    BOOST_CHECK_EQUAL(queue.dispatcher.edgeModifiedEvents.size(), 1);
+    BOOST_CHECK(queue.dispatcher.frameRemovedEvents.empty());
+    BOOST_CHECK(queue.dispatcher.edgeRemovedEvents.empty());
+
+    //the slots are reused after the flush
+    queue.resetStatistics();
+    graph.setEdgeProperty("a", "b", ep);
+    BOOST_CHECK_EQUAL(queue.size(), 1);
+    BOOST_CHECK_EQUAL(queue.getMaxSize(), 1);
+    BOOST_CHECK_EQUAL(queue.getMergeCount(), 0);
+    queue.flush();
+    BOOST_CHECK_EQUAL(queue.dispatcher.edgeModifiedEvents.size(), 2);
+}
+
+
+
+
+BOOST_AUTO_TEST_CASE(concurrent_event_queue_block_test)
+{
+    Gra graph;
+    ConcurrentEventQueue queue(graph, 16, ConcurrentGraphEventQueue::BLOCK);
+    BOOST_CHECK_EQUAL(queue.getCapacity(), 16);
+    EdgeProp ep;
+
+    std::atomic<bool> done(false);
+    std::thread consumer([&]()
+    {
+        while(!done)
+            queue.flush();
+        queue.flush();
+    });
+    graph.add_edge("a", "b", ep);
+    for(int i = 0; i < 2000; ++i)
+        graph.setEdgeProperty("a", "b", ep);
+    done = true;
+    consumer.join();
+
+    //nothing is lost, the producer waited for the consumer
+    BOOST_CHECK_EQUAL(queue.dispatcher.frameAddedEvents.size(), 2);
+    BOOST_CHECK_EQUAL(queue.dispatcher.edgeAddedEvents.size(), 1);
+    BOOST_CHECK_EQUAL(queue.dispatcher.edgeModifiedEvents.size(), 2000);
+    BOOST_CHECK_EQUAL(queue.getDropCount(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(concurrent_event_queue_drop_oldest_test)
+{
+    Gra graph;
+    ConcurrentEventQueue queue(graph, 3, ConcurrentGraphEventQueue::DROP_OLDEST);
+    BOOST_CHECK_EQUAL(queue.getCapacity(), 4);
+    EdgeProp ep;
+
+    //3 events
+    graph.add_edge("a", "b", ep);
+    for(int i = 0; i < 10; ++i)
+        graph.setEdgeProperty("a", "b", ep);
+    BOOST_CHECK_EQUAL(queue.getDropCount(), 9);
+    BOOST_CHECK_EQUAL(queue.flush(), 4);
+    BOOST_CHECK(queue.dispatcher.frameAddedEvents.empty());
+    BOOST_CHECK_EQUAL(queue.dispatcher.edgeModifiedEvents.size(), 4);
+    BOOST_CHECK_EQUAL(queue.flush(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(concurrent_event_queue_coalesce_test)
+{
+    Gra graph;
+    ConcurrentEventQueue queue(graph, 4, ConcurrentGraphEventQueue::COALESCE);
+    EdgeProp ep;
+
+    graph.add_edge("a", "b", ep);
+    for(int i = 0; i < 1000; ++i)
+        graph.setEdgeProperty("a", "b", ep);
+    //the frame and edge cancel out in the overflow queue
+    graph.addFrame("c");
+    graph.add_edge("a", "c", ep);
+    graph.remove_edge("a", "c");
+    graph.removeFrame("c");
+
+    BOOST_CHECK_EQUAL(queue.getDropCount(), 0);
+    BOOST_CHECK_EQUAL(queue.getOverflowCount(), 999 + 4);
+    BOOST_CHECK_EQUAL(queue.getMergeCount(), 998 + 4);
+    BOOST_CHECK_EQUAL(queue.flush(), 5);
+    BOOST_CHECK_EQUAL(queue.dispatcher.frameAddedEvents.size(), 2);
+    BOOST_CHECK_EQUAL(queue.dispatcher.edgeAddedEvents.size(), 1);
+    BOOST_CHECK_EQUAL(queue.dispatcher.edgeModifiedEvents.size(), 2);
+    BOOST_CHECK(queue.dispatcher.frameRemovedEvents.empty());
+    //the edges might be gone, the descriptors are not queued
+    BOOST_CHECK(queue.dispatcher.edgeAddedEvents[0].edge == GraphTraits::edge_descriptor());
+    BOOST_CHECK(queue.dispatcher.edgeModifiedEvents[1].inverseEdge == GraphTraits::edge_descriptor());
+
+    //the ring is used again after the flush
+    graph.setEdgeProperty("a", "b", ep);
+    BOOST_CHECK_EQUAL(queue.getOverflowCount(), 999 + 4);
+    BOOST_CHECK_EQUAL(queue.flush(), 1);
+
+    //the overflow queues take turns, the merges add up
+    for(int round = 1; round <= 2; ++round)
+    {
+        for(int i = 0; i < 10; ++i)
+            graph.setEdgeProperty("a", "b", ep);
+        BOOST_CHECK_EQUAL(queue.getOverflowCount(), 999 + 4 + round * 6);
+        BOOST_CHECK_EQUAL(queue.getMergeCount(), 998 + 4 + round * 5);
+        BOOST_CHECK_EQUAL(queue.flush(), 5);
+    }
+}
+
+
+BOOST_AUTO_TEST_CASE(async_subscriber_test)
+{
+    Gra graph;
+    ThreadPoolExecutor pool(2);
+    Dispatcher first;
+    Dispatcher second;
+    std::unique_ptr<AsyncGraphEventSubscriber> asyncFirst(new AsyncGraphEventSubscriber(&graph, first, pool));
+    AsyncGraphEventSubscriber asyncSecond(&graph, second, pool);
+    //synchronous subscribers are not affected
+    Dispatcher sync(graph);
+    EdgeProp ep;
+
+    for(int i = 0; i < 100; ++i)
+    {
+        const std::string origin = "a" + boost::lexical_cast<std::string>(i);
+        graph.add_edge(origin, "b", ep);
+        graph.setEdgeProperty(origin, "b", ep);
+        BOOST_CHECK_EQUAL(sync.edgeModifiedEvents.size(), i + 1);
+    }
+    graph.remove_edge("a0", "b");
+
+    //the destructor waits for the pending events
+    asyncFirst.reset();
+    asyncSecond.wait();
+    for(const Dispatcher* d : {&first, &second})
+    {
+        BOOST_CHECK_EQUAL(d->frameAddedEvents.size(), 101);
+        BOOST_CHECK_EQUAL(d->edgeAddedEvents.size(), 100);
+        BOOST_CHECK_EQUAL(d->edgeRemovedEvents.size(), 1);
+        BOOST_REQUIRE_EQUAL(d->edgeModifiedEvents.size(), 100);
+        //in order
+        for(int i = 0; i < 100; ++i)
+            BOOST_CHECK(d->edgeModifiedEvents[i].origin == "a" + boost::lexical_cast<std::string>(i));
+        //the edges might be gone, the descriptors are not delivered
+        BOOST_CHECK(d->edgeAddedEvents[0].edge == GraphTraits::edge_descriptor());
+        BOOST_CHECK(d->edgeModifiedEvents[0].inverseEdge == GraphTraits::edge_descriptor());
+    }
+
+    //no events after the async subscriber has been destroyed
+    graph.setEdgeProperty("a1", "b", ep);
+    asyncSecond.wait();
+    BOOST_CHECK_EQUAL(first.edgeModifiedEvents.size(), 100);
+    BOOST_CHECK_EQUAL(second.edgeModifiedEvents.size(), 101);
+}
+
+BOOST_AUTO_TEST_CASE(strand_order_test)
+{
+    ThreadPoolExecutor pool(4);
+    std::vector<int> values;
+    {
+        Strand strand(pool);
+        for(int i = 0; i < 1000; ++i)
+            strand.post([&values, i]() { values.push_back(i); });
+        //exceptions do not stop the strand
+        strand.post([]() { throw std::runtime_error("test"); });
+        strand.post([]() { throw 42; });
+        strand.post([&values]() { values.push_back(1000); });
+    }
+    BOOST_REQUIRE_EQUAL(values.size(), 1001);
+    for(int i = 0; i <= 1000; ++i)
+        BOOST_CHECK_EQUAL(values[i], i);
+}
+
+
+/**Records the order in which the subscribers are notified */
+class OrderRecorder : public GraphEventSubscriber
+{
+public:
+    OrderRecorder(int id, std::vector<int>& order) : id(id), order(order) {}
+    virtual void notifyGraphEvent(const GraphEvent& event) { order.push_back(id); }
+    int id;
+    std::vector<int>& order;
+};
+
+BOOST_AUTO_TEST_CASE(subscription_filter_test)
+{
+    Gra graph;
+    EdgeProp ep;
+    Dispatcher edgesOfA;
+    edgesOfA.setSubscriptionFilter(SubscriptionFilter().setEvents({GraphEvent::EDGE_ADDED,
+                                                                   GraphEvent::EDGE_MODIFIED}).addFrame("a"));
+    edgesOfA.subscribe(&graph);
+    Dispatcher frames;
+    frames.setSubscriptionFilter(SubscriptionFilter().setEvents({GraphEvent::FRAME_ADDED}));
+    frames.subscribe(&graph);
+    Dispatcher all(graph);
+
+    graph.add_edge("a", "b", ep);
+    graph.add_edge("c", "a", ep);
+    graph.add_edge("c", "d", ep);
+    BOOST_CHECK_EQUAL(edgesOfA.edgeAddedEvents.size(), 2);
+    BOOST_CHECK(edgesOfA.frameAddedEvents.empty());
+    BOOST_CHECK_EQUAL(frames.frameAddedEvents.size(), 4);
+    BOOST_CHECK(frames.edgeAddedEvents.empty());
+    BOOST_CHECK_EQUAL(all.edgeAddedEvents.size(), 3);
+
+    //batched events are split for subscribers that filter frames
+    std::vector<Gra::EdgePropertyUpdate> updates(2);
+    updates[0] = {graph.getVertex("a"), graph.getVertex("b"), ep};
+    updates[1] = {graph.getVertex("c"), graph.getVertex("d"), ep};
+    graph.setEdgeProperties(updates);
+    BOOST_REQUIRE_EQUAL(edgesOfA.edgeModifiedEvents.size(), 1);
+    BOOST_CHECK(edgesOfA.edgeModifiedEvents[0].origin == "a");
+    BOOST_CHECK_EQUAL(all.edgeModifiedEvents.size(), 2);
+    BOOST_CHECK(frames.edgeModifiedEvents.empty());
+
+    //changing the filter of a subscribed subscriber
+    edgesOfA.setSubscriptionFilter(SubscriptionFilter().setEvents({GraphEvent::EDGE_REMOVED}).addFrame("d"));
+    graph.setEdgeProperty("a", "b", ep);
+    graph.remove_edge("a", "b");
+    graph.remove_edge("c", "d");
+    BOOST_CHECK_EQUAL(edgesOfA.edgeModifiedEvents.size(), 1);
+    BOOST_REQUIRE_EQUAL(edgesOfA.edgeRemovedEvents.size(), 1);
+    BOOST_CHECK(edgesOfA.edgeRemovedEvents[0].target == "d");
+
+    //the publisher applies the filter when publishing the current state
+    Dispatcher late;
+    late.setSubscriptionFilter(SubscriptionFilter().setEvents({GraphEvent::FRAME_ADDED}).addFrame("c"));
+    late.subscribe(&graph, true);
+    BOOST_CHECK_EQUAL(late.frameAddedEvents.size(), 1);
+    BOOST_CHECK(late.edgeAddedEvents.empty());
+}
+
+BOOST_AUTO_TEST_CASE(subscription_filter_order_test)
+{
+    Gra graph;
+    EdgeProp ep;
+    std::vector<int> order;
+    OrderRecorder unfiltered(0, order);
+    OrderRecorder byFrame(1, order);
+    byFrame.setSubscriptionFilter(SubscriptionFilter().addFrame("a").addFrame("b"));
+    OrderRecorder prioritized(2, order);
+    prioritized.setSubscriptionFilter(SubscriptionFilter().addFrame("b"));
+    OrderRecorder byEvent(3, order);
+    byEvent.setSubscriptionFilter(SubscriptionFilter().setEvents({GraphEvent::EDGE_ADDED}));
+
+    unfiltered.subscribe(&graph);
+    byFrame.subscribe(&graph);
+    byEvent.subscribe(&graph);
+    prioritized.subscribe(&graph, false, true);
+
+    graph.addFrame("a");
+    graph.addFrame("b");
+    order.clear();
+    //subscribers are notified once and in the order of subscription,
+    //prioritized subscribers first
+    graph.add_edge("a", "b", ep);
+    const std::vector<int> expected{2, 0, 1, 3};
+    BOOST_CHECK_EQUAL_COLLECTIONS(order.begin(), order.end(), expected.begin(), expected.end());
+
+    //batched events are split for the subscribers that filter frames,
+    //the prioritized ones are still notified first
+    order.clear();
+    std::vector<Gra::EdgePropertyUpdate> updates{{graph.getVertex("a"), graph.getVertex("b"), ep}};
+    graph.setEdgeProperties(updates);
+    const std::vector<int> expectedBatch{2, 0, 1};
+    BOOST_CHECK_EQUAL_COLLECTIONS(order.begin(), order.end(), expectedBatch.begin(), expectedBatch.end());
+}
+
+
+BOOST_AUTO_TEST_CASE(observed_event_types_test)
+{
+    Gra graph;
+    EdgeProp ep;
+    BOOST_CHECK(!graph.isObserved(GraphEvent::EDGE_ADDED));
+    graph.add_edge("a", "b", ep);
+
+    Dispatcher frames;
+    frames.setSubscriptionFilter(SubscriptionFilter().setEvents({GraphEvent::FRAME_ADDED}));
+    frames.subscribe(&graph);
+    BOOST_CHECK(graph.isObserved(GraphEvent::FRAME_ADDED));
+    BOOST_CHECK(!graph.isObserved(GraphEvent::EDGE_MODIFIED));
+    BOOST_CHECK(!graph.isObserved(GraphEvent::EDGES_MODIFIED));
+
+    //batched events are split for subscribers that filter frames
+    Dispatcher edgesOfA;
+    edgesOfA.setSubscriptionFilter(SubscriptionFilter().setEvents({GraphEvent::EDGE_MODIFIED}).addFrame("a"));
+    edgesOfA.subscribe(&graph);
+    BOOST_CHECK(graph.isObserved(GraphEvent::EDGE_MODIFIED));
+    BOOST_CHECK(graph.isObserved(GraphEvent::EDGES_MODIFIED));
+    graph.setEdgeProperty("a", "b", ep);
+    BOOST_CHECK_EQUAL(edgesOfA.edgeModifiedEvents.size(), 1);
+
+    edgesOfA.unsubscribe();
+    frames.unsubscribe();
+    BOOST_CHECK(!graph.isObserved(GraphEvent::FRAME_ADDED));
+    BOOST_CHECK(!graph.isObserved(GraphEvent::EDGE_MODIFIED));
+
+    //events of a transaction are not queued if nobody observes them
+    graph.beginTransaction();
+    graph.add_edge("c", "d", ep);
+    Dispatcher late(graph);
+    graph.commitTransaction();
+    BOOST_CHECK(late.edgeAddedEvents.empty());
+}
+
+
+BOOST_AUTO_TEST_CASE(lazy_inverse_edges_test)
+{
+    Gra graph;
+    graph.enableLazyInverseEdges();
+    EdgeProp ep;
+    graph.add_edge("a", "b", ep);
+    graph.add_edge("b", "c", ep);
+    const GraphTraits::edge_descriptor ba = graph.getEdge("b", "a");
+    const std::size_t baIndex = boost::get(boost::edge_index, graph.graph(), ba);
+
+    Dispatcher d(graph);
+    ep.value = 7;
+    graph.setEdgeProperty("a", "b", ep);
+    BOOST_CHECK(graph.staleEdges[baIndex]);
+    //the events are the same as without lazy inverse edges
+    BOOST_CHECK(d.edgeModifiedEvents.size() == 1);
+    BOOST_CHECK(d.edgeModifiedEvents[0].edge == graph.getEdge("a", "b"));
+    BOOST_CHECK(d.edgeModifiedEvents[0].inverseEdge == ba);
+
+    //the inverse is calculated on access
+    BOOST_CHECK_EQUAL(graph.getEdgeProperty("b", "a").value, -7);
+    BOOST_CHECK(graph.getEdgeProperty("b", "a").inverted);
+    BOOST_CHECK(!graph.staleEdges[baIndex]);
+
+    //updating the other direction makes the first one stale
+    ep.value = 3;
+    graph.setEdgeProperty("b", "a", ep);
+    BOOST_CHECK_EQUAL(graph[graph.getEdge("a", "b")].value, -3);
+
+    //copies, drawings and serialization see the calculated inverse
+    ep.value = 11;
+    graph.setEdgeProperty("c", "b", ep);
+    Gra copy(graph);
+    BOOST_CHECK(copy.isLazyInverseEdgesEnabled());
+    BOOST_CHECK_EQUAL(copy.graph()[copy.getEdge("b", "c")].value, -11);
+
+    ep.value = 5;
+    graph.setEdgeProperty("c", "b", ep);
+    std::stringstream stream;
+    boost::archive::binary_oarchive oa(stream);
+    oa << graph;
+    Gra loaded;
+    boost::archive::binary_iarchive ia(stream);
+    ia >> loaded;
+    BOOST_CHECK_EQUAL(loaded.getEdgeProperty("b", "c").value, -5);
+
+    //removing an edge with a stale inverse
+    ep.value = 1;
+    graph.setEdgeProperty("a", "b", ep);
+    graph.remove_edge("a", "b");
+    BOOST_CHECK(!graph.containsEdge("b", "a"));
+
+    graph.setEdgeProperty("b", "c", ep);
+    graph.disableLazyInverseEdges();
+    BOOST_CHECK_EQUAL(graph.graph()[graph.getEdge("c", "b")].value, -1);
+    graph.setEdgeProperty("b", "c", ep);
+    BOOST_CHECK(std::find(graph.staleEdges.begin(), graph.staleEdges.end(), true) == graph.staleEdges.end());
+}
+
+class BatchDispatcher : public GraphEventDispatcher
+{
+public:
+    BatchDispatcher(Gra& graph) : GraphEventDispatcher(&graph) {}
+    vector<size_t> batchSizes;
+
+    void edgesModified(const EdgesModifiedEvent& e) override
+    {
+        batchSizes.push_back(e.events.size());
+    }
+};
+
+class RawSubscriber : public GraphEventSubscriber
+{
+public:
+    RawSubscriber() : GraphEventSubscriber() {}
+    RawSubscriber(Gra& graph) : GraphEventSubscriber(&graph) {}
+    vector<GraphEvent::Type> types;
+
+    void notifyGraphEvent(const GraphEvent& event) override
+    {
+        types.push_back(event.getType());
+    }
+};
+
+BOOST_AUTO_TEST_CASE(set_edge_properties_test)
+{
+    Gra graph;
+    EdgeProp ep;
+    graph.add_edge("a", "b", ep);
+    graph.add_edge("a", "c", ep);
+    graph.add_edge("c", "d", ep);
+
+    Dispatcher perEdge(graph);
+    BatchDispatcher batch(graph);
+    RawSubscriber raw(graph);
+    EventQueue queue(graph);
+
+    std::vector<Gra::EdgePropertyUpdate> updates(3);
+    updates[0] = {graph.getVertex("a"), graph.getVertex("b"), ep};
+    updates[0].prop.value = 1;
+    updates[1] = {graph.getVertex("d"), graph.getVertex("c"), ep};
+    updates[1].prop.value = 2;
+    updates[2] = {graph.getVertex("a"), graph.getVertex("b"), ep};
+    updates[2].prop.value = 3;
+    graph.setEdgeProperties(updates);
+
+    BOOST_CHECK_EQUAL(graph.getEdgeProperty("a", "b").value, 3);
+    BOOST_CHECK_EQUAL(graph.getEdgeProperty("b", "a").value, -3);
+    BOOST_CHECK_EQUAL(graph.getEdgeProperty("c", "d").value, -2);
+
+    //one batched event for subscribers that support it
+    BOOST_CHECK_EQUAL(batch.batchSizes.size(), 1);
+    BOOST_CHECK_EQUAL(batch.batchSizes[0], 3);
+    //per edge events for all others
+    BOOST_CHECK_EQUAL(perEdge.edgeModifiedEvents.size(), 3);
+    BOOST_CHECK(perEdge.edgeModifiedEvents[1].origin == FrameId("d"));
+    BOOST_CHECK(perEdge.edgeModifiedEvents[1].edge == graph.getEdge("d", "c"));
+    BOOST_CHECK(perEdge.edgeModifiedEvents[1].inverseEdge == graph.getEdge("c", "d"));
+    BOOST_CHECK_EQUAL(raw.types.size(), 3);
+    BOOST_CHECK_EQUAL(raw.types[0], GraphEvent::EDGE_MODIFIED);
+    //the queue merges the split events
+    queue.flush();
+    BOOST_CHECK_EQUAL(queue.dispatcher.edgeModifiedEvents.size(), 2);
+
+    //nothing is modified if one of the edges does not exist
+    updates[1].target = graph.getVertex("b");
+    updates[0].prop.value = 4;
+    BOOST_CHECK_THROW(graph.setEdgeProperties(updates), UnknownEdgeException);
+    BOOST_CHECK_EQUAL(graph.getEdgeProperty("a", "b").value, 3);
+    BOOST_CHECK_EQUAL(batch.batchSizes.size(), 1);
+
+    //without subscribers no event is built, the edges are updated anyway
+    Gra unobserved;
+    unobserved.add_edge("a", "b", ep);
+    BOOST_CHECK(!unobserved.isObserved(GraphEvent::EDGES_MODIFIED));
+    updates.resize(1);
+    updates[0] = {unobserved.getVertex("b"), unobserved.getVertex("a"), ep};
+    updates[0].prop.value = 5;
+    unobserved.setEdgeProperties(updates);
+    BOOST_CHECK_EQUAL(unobserved.getEdgeProperty("b", "a").value, 5);
+    BOOST_CHECK_EQUAL(unobserved.getEdgeProperty("a", "b").value, -5);
+}
+
+BOOST_AUTO_TEST_CASE(graph_transaction_commit_test)
+{
+    Gra graph;
+    EdgeProp ep;
+    graph.add_edge("a", "b", ep);
+    TreeView view;
+    graph.getTree("a", true, &view);
+    int viewSignals = 0;
+    view.edgeAdded.connect([&viewSignals](GraphTraits::vertex_descriptor, GraphTraits::vertex_descriptor)
+                           { ++viewSignals; });
+
+    Dispatcher d(graph);
+    RawSubscriber cache;
+    cache.subscribe(&graph, false, true);
+
+    graph.beginTransaction();
+    BOOST_CHECK(graph.isInTransaction());
+    BOOST_CHECK_THROW(graph.beginTransaction(), TransactionException);
+    graph.add_edge("b", "c", ep);
+    graph.add_edge("c", "d", ep);
+    graph.add_edge("x", "y", ep);
+    graph.remove_edge("x", "y");
+    graph.removeFrame("y");
+    ep.value = 5;
+    graph.setEdgeProperty("a", "b", ep);
+    ep.value = 6;
+    graph.setEdgeProperty("a", "b", ep);
+
+    //queries work, but the views and unprioritized subscribers are not updated
+    BOOST_CHECK(graph.containsEdge("c", "d"));
+    BOOST_CHECK_EQUAL(graph.getEdgeProperty("b", "a").value, -6);
+    BOOST_CHECK_EQUAL(view.tree.size(), 2);
+    BOOST_CHECK_EQUAL(viewSignals, 0);
+    BOOST_CHECK(d.edgeAddedEvents.empty());
+    BOOST_CHECK(d.edgeModifiedEvents.empty());
+    BOOST_CHECK_EQUAL(cache.types.size(), 11);
+
+    graph.commitTransaction();
+    BOOST_CHECK(!graph.isInTransaction());
+    BOOST_CHECK_THROW(graph.commitTransaction(), TransactionException);
+    BOOST_CHECK(view.vertexExists(graph.getVertex("d")));
+    BOOST_CHECK(!view.vertexExists(graph.getVertex("x")));
+    BOOST_CHECK_EQUAL(viewSignals, 3);
+
+    //x-y cancel out, the modifications of a-b are merged
+    BOOST_CHECK_EQUAL(d.frameAddedEvents.size(), 3);
+    BOOST_CHECK(d.frameRemovedEvents.empty());
+    BOOST_CHECK_EQUAL(d.edgeAddedEvents.size(), 2);
+    BOOST_CHECK(d.edgeRemovedEvents.empty());
+    BOOST_CHECK_EQUAL(d.edgeModifiedEvents.size(), 1);
+    BOOST_CHECK(d.edgeModifiedEvents[0].edge == graph.getEdge("a", "b"));
+    //the prioritized subscriber does not get the events again
+    BOOST_CHECK_EQUAL(cache.types.size(), 11);
+
+    //the views are updated as usual after the transaction
+    graph.add_edge("d", "e", ep);
+    BOOST_CHECK(view.vertexExists(graph.getVertex("e")));
+    BOOST_CHECK_EQUAL(d.edgeAddedEvents.size(), 3);
+}
+
+BOOST_AUTO_TEST_CASE(graph_transaction_abort_test)
+{
+    Gra graph;
+    EdgeProp ep;
+    ep.value = 1;
+    graph.add_edge("a", "b", ep);
+    ep.value = 2;
+    graph.add_edge("b", "c", ep);
+    TreeView view;
+    graph.getTree("c", true, &view);
+    Dispatcher d(graph);
+
+    {
+        GraphTransaction<Gra> transaction(graph);
+        ep.value = 3;
+        graph.setEdgeProperty("b", "a", ep);
+        graph.add_edge("c", "d", ep);
+        graph.disconnectFrame("b");
+        graph.disconnectFrame("c");
+        graph.removeFrame("b");
+        graph.removeFrame("c");
+        BOOST_CHECK(!graph.containsFrame("b"));
+        //the transaction is aborted because it is not committed
+    }
+    BOOST_CHECK(!graph.isInTransaction());
+    BOOST_CHECK_EQUAL(graph.num_vertices(), 3);
+    BOOST_CHECK_EQUAL(graph.num_edges(), 4);
+    BOOST_CHECK(!graph.containsFrame("d"));
+    BOOST_CHECK_EQUAL(graph.getEdgeProperty("a", "b").value, 1);
+    BOOST_CHECK_EQUAL(graph.getEdgeProperty("b", "a").value, -1);
+    BOOST_CHECK_EQUAL(graph.getEdgeProperty("c", "b").value, -2);
+
+    //the view follows the restored root
+    BOOST_CHECK(view.root == graph.getVertex("c"));
+    BOOST_CHECK(view.vertexExists(graph.getVertex("a")));
+    BOOST_CHECK_EQUAL(view.tree.size(), 3);
+
+    //the restored elements are re-added, everything else cancels out
+    BOOST_CHECK_EQUAL(d.edgeRemovedEvents.size(), 2);
+    BOOST_CHECK_EQUAL(d.edgeAddedEvents.size(), 2);
+    BOOST_CHECK_EQUAL(d.frameRemovedEvents.size(), 2);
+    BOOST_CHECK_EQUAL(d.frameAddedEvents.size(), 2);
+    BOOST_CHECK(d.edgeAddedEvents.back().edge == graph.getEdge(d.edgeAddedEvents.back().origin.str(),
+                                                               d.edgeAddedEvents.back().target.str()));
+
+    //a committed scoped transaction is not rolled back
+    {
+        GraphTransaction<Gra> transaction(graph);
+        graph.add_edge("c", "d", ep);
+        transaction.commit();
+    }
+    BOOST_CHECK(graph.containsEdge("c", "d"));
+    BOOST_CHECK(view.vertexExists(graph.getVertex("d")));
+}
+
+/**Throws when an edge is added */
+class ThrowingDispatcher : public GraphEventDispatcher
+{
+public:
+    ThrowingDispatcher(Gra& graph) : GraphEventDispatcher(&graph) {}
+    virtual void edgeAdded(const EdgeAddedEvent& e)
+    {
+        throw std::runtime_error("edgeAdded");
+    }
+};
 
+BOOST_AUTO_TEST_CASE(graph_transaction_abort_throws_test)
+{
+    Gra graph;
+    EdgeProp ep;
+    graph.add_edge("a", "b", ep);
+    ThrowingDispatcher thrower(graph);
+
+    //the rollback re-adds the edge and the subscriber throws
+    graph.beginTransaction();
+    graph.remove_edge("a", "b");
+    BOOST_CHECK_THROW(graph.abortTransaction(), std::runtime_error);
+    BOOST_CHECK(!graph.isInTransaction());
+    BOOST_CHECK(graph.containsEdge("a", "b"));
 
+    //the scoped transaction drops the exception, it may be destroyed
+    //during stack unwinding
+    {
+        GraphTransaction<Gra> transaction(graph);
+        graph.remove_edge("a", "b");
+    }
+    BOOST_CHECK(!graph.isInTransaction());
+    BOOST_CHECK(graph.containsEdge("a", "b"));
+    graph.beginTransaction();
+    graph.commitTransaction();
+}
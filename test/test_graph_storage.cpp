@@ -0,0 +1,226 @@
+#include <boost/test/unit_test.hpp>
+#define protected public
+#include <envire_core/graph/TransformGraph.hpp>
+#include <envire_core/graph/GraphStorage.hpp>
+
+#include <string>
+#include <vector>
+
+using namespace envire::core;
+
+namespace
+{
+    class StorageFrame
+    {
+    public:
+        std::string id;
+        const std::string& getId() const {return id;}
+        void setId(const std::string& _id) {id = _id;}
+        const std::string toString() const {return id;}
+        template<class Archive>
+        void serialize(Archive &ar, const unsigned int version) {ar & id;}
+    };
+
+    using ListGraph = TransformGraph<StorageFrame, ListStorage>;
+    using DenseGraph = TransformGraph<StorageFrame, DenseStorage>;
+
+    Transform makeTransform(const double x)
+    {
+        Transform tf;
+        tf.transform.translation << x, 2 * x, -x;
+        tf.transform.orientation = base::AngleAxisd(x / 10.0, base::Vector3d::UnitY());
+        return tf;
+    }
+
+    /**Builds the same graph with some removed frames and edges */
+    template <class GRAPH>
+    void buildGraph(GRAPH& graph)
+    {
+        for(int i = 1; i < 40; ++i)
+        {
+            graph.addTransform("frame_" + std::to_string(i / 3),
+                               "frame_" + std::to_string(i), makeTransform(i));
+        }
+        graph.disconnectFrame("frame_7");
+        graph.removeFrame("frame_7");
+        graph.removeTransform("frame_4", "frame_13");
+        graph.addTransform("frame_20", "frame_13", makeTransform(0.5));
+        graph.addTransform("frame_38", "frame_3", makeTransform(0.25));
+    }
+
+    void compareTransforms(const Transform& a, const Transform& b)
+    {
+        BOOST_CHECK(a.transform.translation.isApprox(b.transform.translation));
+        BOOST_CHECK(a.transform.orientation.isApprox(b.transform.orientation));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(dense_storage_matches_list_storage_test)
+{
+    ListGraph list;
+    DenseGraph dense;
+    buildGraph(list);
+    buildGraph(dense);
+    BOOST_CHECK_EQUAL(list.num_vertices(), dense.num_vertices());
+    BOOST_CHECK_EQUAL(list.num_edges(), dense.num_edges());
+
+    const std::vector<std::string> frames = {"frame_0", "frame_2", "frame_13",
+                                             "frame_26", "frame_38", "frame_39"};
+    for(const std::string& origin : frames)
+    {
+        for(const std::string& target : frames)
+        {
+            compareTransforms(list.getTransform(origin, target),
+                              dense.getTransform(origin, target));
+            BOOST_CHECK(list.getFrames(origin, target) == dense.getFrames(origin, target));
+        }
+    }
+    BOOST_CHECK(dense.containsEdge("frame_20", "frame_13"));
+    BOOST_CHECK(!dense.containsEdge("frame_4", "frame_13"));
+    BOOST_CHECK_THROW(dense.getTransform("frame_0", "frame_21"), UnknownTransformException);
+
+    TreeView listTree = list.getTree("frame_0");
+    TreeView denseTree = dense.getTree("frame_0");
+    BOOST_CHECK_EQUAL(listTree.tree.size(), denseTree.tree.size());
+}
+
+BOOST_AUTO_TEST_CASE(dense_storage_reuses_indices_test)
+{
+    DenseGraph graph;
+    graph.addTransform("a", "b", makeTransform(1));
+    const std::size_t bound = graph.getStorage().vertexIndexBound(graph.graph());
+    for(int i = 0; i < 100; ++i)
+    {
+        graph.addTransform("b", "c", makeTransform(i));
+        graph.removeTransform("b", "c");
+        graph.removeFrame("c");
+    }
+    BOOST_CHECK_EQUAL(graph.getStorage().vertexIndexBound(graph.graph()), bound + 1);
+    BOOST_CHECK_EQUAL(graph.getStorage().edgeIndexBound(graph.graph()), 4);
+}
+
+BOOST_AUTO_TEST_CASE(dense_storage_handles_test)
+{
+    DenseGraph graph;
+    graph.addTransform("a", "b", makeTransform(1));
+    graph.addTransform("b", "c", makeTransform(2));
+
+    const VertexHandle c = graph.getHandle(graph.getVertex("c"));
+    const EdgeHandle bc = graph.getHandle(graph.getEdge("b", "c"));
+    BOOST_CHECK(graph.resolve(c) == graph.getVertex("c"));
+    BOOST_CHECK(graph.resolve(bc).second);
+    BOOST_CHECK(graph.resolve(bc).first == graph.getEdge("b", "c"));
+
+    graph.removeTransform("b", "c");
+    BOOST_CHECK(!graph.resolve(bc).second);
+    BOOST_CHECK(graph.resolve(c) == graph.getVertex("c"));
+
+    graph.removeFrame("c");
+    BOOST_CHECK(graph.resolve(c) == DenseGraph::null_vertex());
+
+    //the slots are reused but the old handles stay invalid
+    graph.addTransform("b", "d", makeTransform(3));
+    BOOST_CHECK(graph.resolve(c) == DenseGraph::null_vertex());
+    BOOST_CHECK(!graph.resolve(bc).second);
+    BOOST_CHECK(graph.resolve(graph.getHandle(graph.getVertex("d"))) == graph.getVertex("d"));
+}
+
+BOOST_AUTO_TEST_CASE(dense_storage_copy_test)
+{
+    DenseGraph graph;
+    buildGraph(graph);
+    DenseGraph copy(graph);
+    BOOST_CHECK_EQUAL(copy.num_edges(), graph.num_edges());
+    compareTransforms(copy.getTransform("frame_38", "frame_13"),
+                      graph.getTransform("frame_38", "frame_13"));
+
+    ListGraph list;
+    buildGraph(list);
+    ListGraph listCopy(list);
+    compareTransforms(listCopy.getTransform("frame_38", "frame_13"),
+                      list.getTransform("frame_38", "frame_13"));
+}
+
+BOOST_AUTO_TEST_CASE(edge_index_test)
+{
+    ListGraph list;
+    DenseGraph dense;
+    buildGraph(list);
+    buildGraph(dense);
+
+    //the index has to agree with boost::edge for all pairs
+    auto checkIndex = [](const ListGraph& graph)
+    {
+        ListGraph::vertex_iterator u, uEnd, v, vEnd;
+        for(boost::tie(u, uEnd) = graph.getVertices(); u != uEnd; ++u)
+        {
+            for(boost::tie(v, vEnd) = graph.getVertices(); v != vEnd; ++v)
+            {
+                const ListGraph::EdgePair expected = boost::edge(*u, *v, graph);
+                const ListGraph::EdgePair found = graph.findEdge(*u, *v);
+                BOOST_CHECK_EQUAL(found.second, expected.second);
+                if(found.second)
+                    BOOST_CHECK(found.first == expected.first);
+            }
+        }
+    };
+    checkIndex(list);
+    ListGraph copy(list);
+    checkIndex(copy);
+
+    list.removeTransform("frame_20", "frame_13");
+    BOOST_CHECK(!list.findEdge(list.getVertex("frame_20"), list.getVertex("frame_13")).second);
+    BOOST_CHECK(!list.findEdge(list.getVertex("frame_13"), list.getVertex("frame_20")).second);
+
+    DenseGraph denseCopy(dense);
+    BOOST_CHECK(denseCopy.findEdge(denseCopy.getVertex("frame_38"), denseCopy.getVertex("frame_3")).second);
+}
+
+BOOST_AUTO_TEST_CASE(list_storage_reuses_edge_slots_test)
+{
+    ListGraph graph;
+    graph.addTransform("a", "b", makeTransform(1));
+    const EdgeHandle ab = graph.getHandle(graph.getEdge("a", "b"));
+    for(int i = 0; i < 100; ++i)
+    {
+        graph.addTransform("b", "c", makeTransform(i));
+        graph.removeTransform("b", "c");
+    }
+    BOOST_CHECK_EQUAL(graph.getStorage().edgeIndexBound(graph.graph()), 4);
+    BOOST_CHECK(graph.resolve(ab).second);
+    BOOST_CHECK(graph.resolve(ab).first == graph.getEdge("a", "b"));
+
+    //the slots of a<->b are reused but the old handles stay invalid
+    const EdgeHandle removed = graph.getHandle(graph.getEdge("b", "a"));
+    graph.removeTransform("a", "b");
+    graph.addTransform("a", "c", makeTransform(2));
+    BOOST_CHECK(!graph.resolve(ab).second);
+    BOOST_CHECK(!graph.resolve(removed).second);
+    BOOST_CHECK(graph.resolve(graph.getHandle(graph.getEdge("a", "c"))).first == graph.getEdge("a", "c"));
+    BOOST_CHECK_EQUAL(graph.getStorage().edgeIndexBound(graph.graph()), 4);
+}
+
+BOOST_AUTO_TEST_CASE(list_storage_reuses_vertex_slots_test)
+{
+    ListGraph graph;
+    graph.addTransform("a", "b", makeTransform(1));
+    const std::size_t bound = graph.getVertexIndexBound();
+    for(int i = 0; i < 100; ++i)
+    {
+        graph.addTransform("b", "c", makeTransform(i));
+        graph.removeTransform("b", "c");
+        graph.removeFrame("c");
+    }
+    BOOST_CHECK_EQUAL(graph.getVertexIndexBound(), bound + 1);
+    BOOST_CHECK_EQUAL(graph.getStorage().edgeIndexBound(graph.graph()), 4);
+
+    //the reused slot is mapped to the new frame
+    graph.addTransform("b", "d", makeTransform(3));
+    BOOST_CHECK_EQUAL(graph.getVertexIndexBound(), bound + 1);
+    BOOST_CHECK(graph.getFrameSymbol(graph.getVertex("d")) == "d");
+    BOOST_CHECK_EQUAL(graph.getPath("a", "d", false)->getSize(), 3);
+
+    ListGraph copy(graph);
+    BOOST_CHECK_EQUAL(copy.getVertexIndexBound(), 3);
+    BOOST_CHECK(copy.getFrameSymbol(copy.getVertex("d")) == "d");
+}
@@ -30,6 +30,8 @@
 #include <boost/lexical_cast.hpp>
 #include <vector>
 #include <string>
+#include <atomic>
+#include <thread>
 #include <envire_core/graph/GraphDrawing.hpp>
 
 using namespace envire::core;
@@ -608,3 +610,627 @@ BOOST_AUTO_TEST_CASE(get_path_transform_dirty_exception_test)
     BOOST_CHECK_THROW(graph.getTransform(path), InvalidPathException);
 }
 
+BOOST_AUTO_TEST_CASE(get_path_transform_cache_test)
+{
+    Tfg graph;
+    
+    Transform tf;
+    tf.transform.translation << 0,3,0;
+    tf.transform.orientation = Eigen::Quaterniond(1,2,3,4);
+    graph.addTransform("A", "B", tf);
+    tf.transform.translation << 0,-1,42;
+    tf.transform.orientation = Eigen::Quaterniond(1,0,0,13);
+    graph.addTransform("B", "C", tf);
+    graph.addTransform("C", "D", tf);
+    
+    std::shared_ptr<Path> path = graph.getPath("A", "C", true);
+    compareTransform(graph.getTransform(path), graph.getTransform("A", "C"));
+    //the cached transform is returned until an edge of the path changes
+    compareTransform(graph.getTransform(path), graph.getTransform("A", "C"));
+    
+    //edges that are not part of the path do not invalidate the cache
+    tf.transform.translation << 7,7,7;
+    graph.updateTransform("C", "D", tf);
+    compareTransform(graph.getTransform(path), graph.getTransform("A", "C"));
+    
+    //modifying the inverse of an edge on the path invalidates the cache as well
+    tf.transform.translation << -5,1,13;
+    tf.transform.orientation = Eigen::Quaterniond(1,2,0,13);
+    graph.updateTransform("C", "B", tf);
+    compareTransform(graph.getTransform(path), graph.getTransform("A", "C"));
+    
+    tf.transform.translation << -5,12,10;
+    graph.updateTransform("A", "B", tf);
+    compareTransform(graph.getTransform(path), graph.getTransform("A", "C"));
+    
+    //removed edges force a new search and new edges
+    graph.remove_edge("A", "B");
+    graph.addTransform("A", "D", tf);
+    BOOST_CHECK(path->isDirty());
+    compareTransform(graph.getTransform(path), graph.getTransform("A", "C"));
+    BOOST_CHECK_EQUAL(path->getSize(), 3);
+}
+
+
+BOOST_AUTO_TEST_CASE(get_path_transform_concurrent_readers_test)
+{
+    Tfg graph;
+    Transform tf;
+    tf.transform.translation << 1, 2, 3;
+    tf.transform.orientation = base::AngleAxisd(0.5, base::Vector3d::UnitZ());
+    graph.addTransform("A", "B", tf);
+    graph.addTransform("B", "C", tf);
+    graph.addTransform("C", "D", tf);
+    std::shared_ptr<Path> path = graph.getPath("A", "D", true);
+
+    //the readers share the path and fill its caches concurrently, like
+    //readers of a ConcurrentEnvireGraph do under the shared lock
+    for(int round = 0; round < 20; ++round)
+    {
+        tf.transform.translation << round, 0, 1;
+        graph.updateTransform("B", "C", tf);
+        if(round % 2 == 0)
+        {
+            //forces the readers to search a new path
+            graph.removeTransform("C", "D");
+            graph.addTransform("C", "D", tf);
+        }
+        const Transform expected = graph.getTransform("A", "D");
+
+        std::atomic<int> wrong(0);
+        std::vector<std::thread> readers;
+        for(int r = 0; r < 4; ++r)
+        {
+            readers.emplace_back([&]()
+            {
+                for(int i = 0; i < 100; ++i)
+                {
+                    const Transform read = graph.getTransform(path);
+                    if(!read.transform.translation.isApprox(expected.transform.translation))
+                        ++wrong;
+                }
+            });
+        }
+        for(std::thread& reader : readers)
+            reader.join();
+        BOOST_CHECK_EQUAL(wrong, 0);
+    }
+
+    //readers get and drop the same shared path. A path that is being
+    //destroyed is replaced instead of blocking its registration.
+    path.reset();
+    std::atomic<int> failures(0);
+    std::vector<std::thread> readers;
+    for(int r = 0; r < 4; ++r)
+    {
+        readers.emplace_back([&]()
+        {
+            for(int i = 0; i < 1000; ++i)
+            {
+                try
+                {
+                    if(graph.getPath("A", "C", true)->getSize() != 3)
+                        ++failures;
+                }
+                catch(const std::exception&)
+                {
+                    ++failures;
+                }
+            }
+        });
+    }
+    for(std::thread& reader : readers)
+        reader.join();
+    BOOST_CHECK_EQUAL(failures, 0);
+    BOOST_CHECK_EQUAL(graph.getPathRegistry()->size(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(get_transform_long_chain_test)
+{
+    Tfg graph;
+    Transform tf;
+    tf.transform.translation << 1, -2, 0.5;
+    tf.transform.orientation = base::AngleAxisd(0.1, base::Vector3d::UnitZ());
+
+    const int depth = 30;
+    Transform expected(base::Position::Zero(), base::Orientation::Identity());
+    std::vector<FrameId> expectedFrames;
+    for(int i = 0; i < depth; ++i)
+    {
+        const FrameId origin = "frame_" + boost::lexical_cast<string>(i);
+        const FrameId target = "frame_" + boost::lexical_cast<string>(i + 1);
+        graph.addTransform(origin, target, tf);
+        expected.transform = expected.transform * tf.transform;
+        expectedFrames.push_back(origin);
+        //dead ends should not influence the result
+        graph.addTransform(origin, origin + "_leaf", tf);
+    }
+    expectedFrames.push_back("frame_" + boost::lexical_cast<string>(depth));
+
+    const FrameId last = expectedFrames.back();
+    compareTransform(graph.getTransform("frame_0", last), expected);
+    BOOST_CHECK(graph.getFrames("frame_0", last) == expectedFrames);
+
+    Transform inverse;
+    inverse.setTransform(expected.transform.inverse());
+    const Transform readInverse = graph.getTransform(last, "frame_0");
+    BOOST_CHECK(readInverse.transform.translation.isApprox(inverse.transform.translation));
+    BOOST_CHECK(readInverse.transform.orientation.isApprox(inverse.transform.orientation));
+
+    //the same frame is not a path but the identity
+    BOOST_CHECK(graph.getFrames(last, last).empty());
+    compareTransform(graph.getTransform(last, last),
+                     Transform(base::Position::Zero(), base::Orientation::Identity()));
+
+    //shortcuts are preferred over the long chain
+    graph.addTransform("frame_0", last, tf);
+    compareTransform(graph.getTransform("frame_0", last), tf);
+    BOOST_CHECK(graph.getFrames("frame_0", last).size() == 2);
+
+    graph.addFrame("unconnected");
+    BOOST_CHECK_THROW(graph.getTransform("frame_0", "unconnected"), UnknownTransformException);
+    BOOST_CHECK(graph.getFrames("frame_0", "unconnected").empty());
+}
+
+namespace
+{
+    /**Reads a transform whenever an edge is modified */
+    class TransformReader : public GraphEventDispatcher
+    {
+    public:
+        TransformReader(Tfg& graph, const FrameId& origin, const FrameId& target) :
+            GraphEventDispatcher(&graph), graph(graph), origin(origin), target(target) {}
+        virtual void edgeModified(const EdgeModifiedEvent& e) override
+        {
+            read = graph.getTransform(origin, target);
+        }
+        Tfg& graph;
+        FrameId origin;
+        FrameId target;
+        Transform read;
+    };
+}
+
+BOOST_AUTO_TEST_CASE(transform_cache_test)
+{
+    Tfg graph;
+    Transform tf;
+    tf.transform.translation << 1, 0, 0;
+    tf.transform.orientation = base::AngleAxisd(0.25, base::Vector3d::UnitZ());
+    graph.addTransform("root", "a", tf);
+    graph.addTransform("a", "b", tf);
+    graph.addTransform("root", "c", tf);
+    graph.addTransform("c", "d", tf);
+
+    //the reader subscribes before the cache is enabled but has to see the
+    //updated transform anyway
+    TransformReader reader(graph, "b", "d");
+    BOOST_CHECK(graph.getTransformCache() == nullptr);
+    graph.enableTransformCache();
+    const Tfg::Cache& cache = *graph.getTransformCache();
+
+    const Transform bd = graph.getTransform("b", "d");
+    compareTransform(graph.getTransform("b", "d"), bd);
+    graph.getTransform("a", "b");
+    graph.getTransform("c", "d");
+    BOOST_CHECK_EQUAL(cache.getHits(), 1);
+    BOOST_CHECK_EQUAL(cache.getMisses(), 3);
+    BOOST_CHECK_EQUAL(cache.size(), 3);
+
+    //only the pairs whose path crosses the modified edge are dropped
+    Transform moved = tf;
+    moved.transform.translation << 0, 2, 0;
+    graph.updateTransform("c", "d", moved);
+    BOOST_CHECK_EQUAL(cache.getInvalidations(), 2);
+    //the reader has cached (b, d) again
+    BOOST_CHECK_EQUAL(cache.size(), 2);
+    Tfg uncached(graph);
+    uncached.disableTransformCache();
+    compareTransform(reader.read, uncached.getTransform("b", "d"));
+    compareTransform(graph.getTransform("b", "d"), uncached.getTransform("b", "d"));
+    graph.getTransform("a", "b");
+    BOOST_CHECK_EQUAL(cache.getHits(), 3);
+
+    //adding a leaf does not affect any cached path
+    graph.addTransform("d", "e", tf);
+    BOOST_CHECK_EQUAL(cache.size(), 2);
+
+    //closing a cycle does
+    graph.addTransform("b", "d", moved);
+    BOOST_CHECK_EQUAL(cache.size(), 0);
+    compareTransform(graph.getTransform("b", "d"), moved);
+
+    graph.removeTransform("b", "d");
+    compareTransform(graph.getTransform("b", "d"), uncached.getTransform("b", "d"));
+    graph.removeTransform("a", "b");
+    BOOST_CHECK_EQUAL(cache.size(), 0);
+    BOOST_CHECK_THROW(graph.getTransform("b", "d"), UnknownTransformException);
+
+    graph.disableTransformCache();
+    BOOST_CHECK(!graph.isTransformCacheEnabled());
+}
+
+BOOST_AUTO_TEST_CASE(tree_view_transform_cache_test)
+{
+    /*       a
+     *     /   \
+     *    b     c
+     *   /     / \
+     *  d     e   f
+     */
+    Tfg graph;
+    Transform tf;
+    tf.transform.translation << 1, 2, 1;
+    tf.transform.orientation = base::AngleAxisd(0.25, base::Vector3d::UnitZ());
+    graph.addTransform("a", "b", tf);
+    graph.addTransform("b", "d", tf);
+    graph.addTransform("a", "c", tf);
+    graph.addTransform("c", "e", tf);
+    graph.addTransform("f", "c", tf);
+
+    TreeView view;
+    graph.getTree("a", true, &view);
+    const vertex_descriptor a = graph.getVertex("a");
+    const vertex_descriptor c = graph.getVertex("c");
+    const vertex_descriptor d = graph.getVertex("d");
+    const vertex_descriptor e = graph.getVertex("e");
+    const vertex_descriptor f = graph.getVertex("f");
+    BOOST_CHECK_EQUAL(view.getRelation(a).depth, 0);
+    BOOST_CHECK_EQUAL(view.getRelation(d).depth, 2);
+    BOOST_CHECK(view.getRelation(f).parentEdge == graph.getEdge(c, f));
+
+    auto compareWithGraph = [&](const FrameId& origin, const FrameId& target)
+    {
+        const Transform fromView = graph.getTransform(origin, target, view);
+        const Transform fromGraph = graph.getTransform(origin, target);
+        //some transforms are zero, thus isApprox() cannot be used
+        BOOST_CHECK_SMALL((fromView.transform.translation - fromGraph.transform.translation).norm(), 1e-9);
+        BOOST_CHECK(fromView.transform.orientation.isApprox(fromGraph.transform.orientation));
+    };
+
+    //the lowest common ancestor walk without cache
+    compareWithGraph("d", "e");
+    compareWithGraph("e", "f");
+    BOOST_CHECK(view.getCachedRootTransform(d) == nullptr);
+
+    view.enableTransformCache();
+    compareWithGraph("d", "e");
+    compareWithGraph("f", "a");
+    BOOST_CHECK(view.getCachedRootTransform(d) != nullptr);
+    BOOST_CHECK(view.getCachedRootTransform(c) != nullptr);
+
+    //modifying an edge drops the sub-tree below it
+    Transform moved = tf;
+    moved.transform.translation << -3, 0, 1;
+    graph.updateTransform("c", "a", moved);
+    BOOST_CHECK(view.getCachedRootTransform(c) == nullptr);
+    BOOST_CHECK(view.getCachedRootTransform(e) == nullptr);
+    BOOST_CHECK(view.getCachedRootTransform(d) != nullptr);
+    compareWithGraph("d", "e");
+    compareWithGraph("f", "d");
+
+    graph.removeTransform("c", "e");
+    BOOST_CHECK(view.getCachedRootTransform(e) == nullptr);
+    graph.addTransform("d", "e", moved);
+    BOOST_CHECK_EQUAL(view.getRelation(e).depth, 3);
+    compareWithGraph("e", "f");
+
+    //copies are not updated, thus they do not cache
+    TreeView copy(view);
+    BOOST_CHECK(!copy.isTransformCacheEnabled());
+
+    view.disableTransformCache();
+    BOOST_CHECK(view.getCachedRootTransform(d) == nullptr);
+}
+
+BOOST_AUTO_TEST_CASE(tree_view_transform_cache_transaction_test)
+{
+    Tfg graph;
+    Transform tf;
+    tf.transform.translation << 1, 2, 1;
+    tf.transform.orientation = base::AngleAxisd(0.25, base::Vector3d::UnitZ());
+    graph.addTransform("a", "b", tf);
+    graph.addTransform("b", "c", tf);
+    graph.addTransform("a", "d", tf);
+
+    TreeView view;
+    graph.getTree("a", true, &view);
+    view.enableTransformCache();
+    graph.getTransform("a", "c", view);
+    const vertex_descriptor c = graph.getVertex("c");
+    BOOST_CHECK(view.getCachedRootTransform(c) != nullptr);
+
+    graph.beginTransaction();
+    //the view is not updated inside the transaction, but the queries
+    //see the modified transforms
+    Transform moved = tf;
+    moved.transform.translation << -3, 0, 1;
+    graph.updateTransform("a", "b", moved);
+    BOOST_CHECK(graph.getTransform("a", "c", view).transform.translation.isApprox(
+                graph.getTransform("a", "c").transform.translation));
+
+    //the tree edge and its parentEdge descriptor are gone
+    graph.removeTransform("b", "c");
+    BOOST_CHECK(view.vertexExists(c));
+    BOOST_CHECK(graph.getTransform("d", "b", view).transform.translation.isApprox(
+                graph.getTransform("d", "b").transform.translation));
+    //the remaining edges would give a wrong transform
+    BOOST_CHECK_THROW(graph.getTransform("a", "c", view), UnknownTransformException);
+    BOOST_CHECK_THROW(graph.getTransform("c", "d", view), UnknownTransformException);
+    graph.removeFrame("c");
+
+    std::vector<TransformResult> transforms;
+    BOOST_CHECK_EQUAL(graph.getRootTransforms(view, transforms), 3);
+    BOOST_CHECK(transforms[graph.getVertexIndex(graph.getVertex("b"))].transform.transform.translation.isApprox(
+                moved.transform.translation));
+    graph.commitTransaction();
+
+    BOOST_CHECK_EQUAL(view.tree.size(), 3);
+    BOOST_CHECK(graph.getTransform("d", "b", view).transform.translation.isApprox(
+                graph.getTransform("d", "b").transform.translation));
+}
+
+BOOST_AUTO_TEST_CASE(batch_get_transforms_test)
+{
+    /* a - b - c - d   e - f   (g does not exist) */
+    Tfg graph;
+    Transform tf;
+    tf.transform.translation << 1, -2, 0.5;
+    tf.transform.orientation = base::AngleAxisd(0.3, base::Vector3d::UnitX());
+    graph.addTransform("a", "b", tf);
+    graph.addTransform("b", "c", tf);
+    graph.addTransform("c", "d", tf);
+    graph.addTransform("b", "d", tf);
+    graph.addTransform("e", "f", tf);
+
+    auto compare = [&](const TransformResult& result, const FrameId& origin, const FrameId& target)
+    {
+        BOOST_CHECK(result.ok());
+        const Transform expected = graph.getTransform(origin, target);
+        BOOST_CHECK(result.transform.transform.translation.isApprox(expected.transform.translation));
+        BOOST_CHECK(result.transform.transform.orientation.isApprox(expected.transform.orientation));
+    };
+
+    const std::vector<FrameId> targets = {"d", "b", "e", "a", "g", "c", "d"};
+    const std::vector<TransformResult> results = graph.getTransforms(FrameId("a"), targets);
+    BOOST_CHECK_EQUAL(results.size(), targets.size());
+    compare(results[0], "a", "d");
+    compare(results[1], "a", "b");
+    BOOST_CHECK_EQUAL(results[2].status, TransformResult::UNKNOWN_TRANSFORM);
+    BOOST_CHECK(results[3].ok());
+    BOOST_CHECK(results[3].transform.transform.orientation.isApprox(base::Orientation::Identity()));
+    BOOST_CHECK_EQUAL(results[4].status, TransformResult::UNKNOWN_FRAME);
+    compare(results[5], "a", "c");
+    compare(results[6], "a", "d");
+
+    const std::vector<std::pair<FrameId, FrameId>> queries = {{"d", "a"}, {"e", "f"}, {"g", "a"},
+                                                              {"d", "b"}, {"f", "c"}, {"f", "e"}};
+    const std::vector<TransformResult> pairResults = graph.getTransforms(queries);
+    BOOST_CHECK_EQUAL(pairResults.size(), queries.size());
+    compare(pairResults[0], "d", "a");
+    compare(pairResults[1], "e", "f");
+    BOOST_CHECK_EQUAL(pairResults[2].status, TransformResult::UNKNOWN_FRAME);
+    compare(pairResults[3], "d", "b");
+    BOOST_CHECK_EQUAL(pairResults[4].status, TransformResult::UNKNOWN_TRANSFORM);
+    compare(pairResults[5], "f", "e");
+
+    const std::vector<vertex_descriptor> vertices = {graph.getVertex("c"), graph.getVertex("a")};
+    const std::vector<TransformResult> vertexResults = graph.getTransforms(graph.getVertex("d"), vertices);
+    compare(vertexResults[0], "d", "c");
+    compare(vertexResults[1], "d", "a");
+}
+
+BOOST_AUTO_TEST_CASE(get_root_transforms_test)
+{
+    /*       a
+     *     /   \
+     *    b     c  -  e     g
+     *   /     /       \
+     *  d     f ------- h
+     */
+    Tfg graph;
+    Transform tf;
+    tf.transform.translation << 0.5, 1, -1;
+    tf.transform.orientation = base::AngleAxisd(0.4, base::Vector3d::UnitY());
+    graph.addTransform("a", "b", tf);
+    graph.addTransform("b", "d", tf);
+    graph.addTransform("c", "a", tf);
+    graph.addTransform("c", "e", tf);
+    graph.addTransform("c", "f", tf);
+    graph.addTransform("e", "h", tf);
+    graph.addTransform("f", "h", tf);
+    graph.addFrame("g");
+
+    auto check = [&](const std::vector<TransformResult>& transforms, const FrameId& frame)
+    {
+        const TransformResult& result = transforms[graph.getVertexIndex(graph.getVertex(frame))];
+        BOOST_CHECK(result.ok());
+        const Transform expected = graph.getTransform("a", frame);
+        BOOST_CHECK_SMALL((result.transform.transform.translation - expected.transform.translation).norm(), 1e-9);
+        BOOST_CHECK(result.transform.transform.orientation.isApprox(expected.transform.orientation));
+    };
+
+    std::vector<TransformResult> transforms;
+    BOOST_CHECK_EQUAL(graph.getRootTransforms("a", transforms), 7);
+    BOOST_CHECK_EQUAL(transforms.size(), graph.getVertexIndexBound());
+    for(const FrameId& frame : {"a", "b", "c", "d", "e", "f", "h"})
+        check(transforms, frame);
+    BOOST_CHECK_EQUAL(transforms[graph.getVertexIndex(graph.getVertex("g"))].status,
+                      TransformResult::UNKNOWN_TRANSFORM);
+
+    TreeView view = graph.getTree(graph.getVertex("a"));
+    BOOST_CHECK_EQUAL(graph.getRootTransforms(view, transforms), 7);
+    for(const FrameId& frame : {"a", "b", "c", "d", "e", "f", "h"})
+        check(transforms, frame);
+    BOOST_CHECK(!transforms[graph.getVertexIndex(graph.getVertex("g"))].ok());
+
+    BOOST_CHECK_THROW(graph.getRootTransforms("unknown", transforms), UnknownFrameException);
+}
+
+template <class GRAPH>
+void checkTransformHandles()
+{
+    GRAPH graph;
+    Transform tf;
+    tf.transform.translation << 1, 2, 3;
+    tf.transform.orientation = base::AngleAxisd(0.5, base::Vector3d::UnitZ());
+    graph.addTransform("a", "b", tf);
+    graph.addTransform("b", "c", tf);
+
+    const TransformHandle handle = graph.getTransformHandle("b", "c");
+    BOOST_CHECK(graph.isValid(handle));
+    BOOST_CHECK_THROW(graph.getTransformHandle("a", "c"), UnknownEdgeException);
+
+    TreeView view;
+    graph.getTree("a", true, &view);
+    view.enableTransformCache();
+    graph.getTransform("a", "c", view);
+
+    tf.transform.translation << -1, 0, 4;
+    graph.updateTransform(handle, tf);
+    BOOST_CHECK(graph.getTransform("b", "c").transform.translation.isApprox(tf.transform.translation));
+    BOOST_CHECK(graph.getTransform("c", "b").transform.translation.isApprox(tf.transform.inverse().translation));
+    BOOST_CHECK(graph.getTransform(handle).transform.translation.isApprox(tf.transform.translation));
+    //the update reaches the tree views
+    BOOST_CHECK(view.getCachedRootTransform(graph.getVertex("c")) == nullptr);
+
+    graph.removeTransform("b", "c");
+    BOOST_CHECK(!graph.isValid(handle));
+    BOOST_CHECK_THROW(graph.updateTransform(handle, tf), InvalidHandleException);
+    BOOST_CHECK_THROW(graph.getTransform(handle), InvalidHandleException);
+
+    //re-adding the edge does not revive old handles
+    graph.addTransform("b", "c", tf);
+    BOOST_CHECK(!graph.isValid(handle));
+    const TransformHandle newHandle = graph.getTransformHandle("c", "b");
+    BOOST_CHECK(graph.isValid(newHandle));
+    graph.updateTransform(newHandle, tf);
+    BOOST_CHECK(graph.getTransform("c", "b").transform.translation.isApprox(tf.transform.translation));
+}
+
+BOOST_AUTO_TEST_CASE(transform_handle_test)
+{
+    checkTransformHandles<Tfg>();
+    checkTransformHandles<TransformGraph<FrameProp, DenseStorage>>();
+}
+
+BOOST_AUTO_TEST_CASE(update_transforms_test)
+{
+    Tfg graph;
+    Transform tf;
+    tf.transform.translation << 1, 0, 0;
+    tf.transform.orientation = base::Orientation::Identity();
+    graph.addTransform("body", "joint_0", tf);
+    graph.addTransform("joint_0", "joint_1", tf);
+    graph.addTransform("body", "joint_2", tf);
+
+    std::vector<std::pair<TransformHandle, Transform>> updates;
+    for(const auto& joint : {std::make_pair("body", "joint_0"), std::make_pair("joint_0", "joint_1"),
+                             std::make_pair("body", "joint_2")})
+    {
+        updates.emplace_back(graph.getTransformHandle(joint.first, joint.second), tf);
+        updates.back().second.transform.translation << updates.size(), 1, 0;
+    }
+    graph.updateTransforms(updates);
+    BOOST_CHECK(graph.getTransform("body", "joint_1").transform.translation.isApprox(base::Vector3d(3, 2, 0)));
+    BOOST_CHECK(graph.getTransform("joint_2", "body").transform.translation.isApprox(base::Vector3d(-3, -1, 0)));
+
+    graph.removeTransform("body", "joint_2");
+    updates[0].second.transform.translation << 5, 0, 0;
+    BOOST_CHECK_THROW(graph.updateTransforms(updates), InvalidHandleException);
+    BOOST_CHECK(graph.getTransform("body", "joint_0").transform.translation.isApprox(base::Vector3d(1, 1, 0)));
+}
+
+BOOST_AUTO_TEST_CASE(seq_lock_transform_test)
+{
+    Tfg graph;
+    Transform tf;
+    tf.transform.translation << 1, 0, 0;
+    tf.transform.orientation = base::Orientation::Identity();
+    graph.addTransform("odometry", "body", tf);
+    graph.addTransform("body", "camera", tf);
+
+    std::shared_ptr<const SeqLockTransform> bodyInOdometry = graph.enableSeqLock("odometry", "body");
+    std::shared_ptr<const SeqLockTransform> odometryInBody = graph.enableSeqLock("body", "odometry");
+    BOOST_CHECK(graph.enableSeqLock("odometry", "body") == bodyInOdometry);
+    BOOST_CHECK(bodyInOdometry->isValid());
+    BOOST_CHECK(bodyInOdometry->load().transform.translation.isApprox(base::Vector3d(1, 0, 0)));
+    BOOST_CHECK_THROW(graph.enableSeqLock("odometry", "camera"), UnknownEdgeException);
+
+    tf.transform.translation << 2, 3, 4;
+    tf.time = base::Time::fromMicroseconds(42);
+    const std::uint32_t version = bodyInOdometry->getVersion();
+    graph.updateTransform("odometry", "body", tf);
+    BOOST_CHECK(bodyInOdometry->getVersion() != version);
+    BOOST_CHECK(bodyInOdometry->load().transform.translation.isApprox(base::Vector3d(2, 3, 4)));
+    BOOST_CHECK_EQUAL(bodyInOdometry->load().time.microseconds, 42);
+    BOOST_CHECK(odometryInBody->load().transform.translation.isApprox(base::Vector3d(-2, -3, -4)));
+
+    //batched updates and updates of the inverse edge are stored as well
+    tf.transform.translation << 5, 0, 0;
+    graph.updateTransforms({std::make_pair(graph.getTransformHandle("body", "odometry"), tf)});
+    BOOST_CHECK(bodyInOdometry->load().transform.translation.isApprox(base::Vector3d(-5, 0, 0)));
+
+    BOOST_CHECK(graph.disableSeqLock("body", "odometry"));
+    BOOST_CHECK(!graph.disableSeqLock("body", "odometry"));
+    BOOST_CHECK(!odometryInBody->isValid());
+
+    graph.removeTransform("odometry", "body");
+    BOOST_CHECK(!bodyInOdometry->isValid());
+    BOOST_CHECK(bodyInOdometry->load().transform.translation.isApprox(base::Vector3d(-5, 0, 0)));
+}
+
+BOOST_AUTO_TEST_CASE(seq_lock_transform_torn_read_test)
+{
+    //every value written is derived from a single counter, a torn read
+    //would mix values of different counters
+    auto makeTransform = [](const int64_t i)
+    {
+        Transform tf;
+        tf.time = base::Time::fromMicroseconds(i);
+        tf.transform.translation << i, 2.0 * i, 3.0 * i;
+        tf.transform.orientation = base::Orientation(i, i, i, i);
+        tf.transform.cov.setConstant(i);
+        return tf;
+    };
+    Tfg graph;
+    graph.addTransform("odometry", "body", makeTransform(0));
+    std::shared_ptr<const SeqLockTransform> transform = graph.enableSeqLock("odometry", "body");
+
+    const int numUpdates = 20000;
+    std::atomic<bool> done(false);
+    std::atomic<int> tornReads(0);
+    std::atomic<int> reads(0);
+    std::vector<std::thread> readers;
+    for(int r = 0; r < 3; ++r)
+    {
+        readers.emplace_back([&]()
+        {
+            int64_t last = 0;
+            while(!done || reads < 1000)
+            {
+                const Transform tf = transform->load();
+                const int64_t i = tf.time.microseconds;
+                const base::TransformWithCovariance& t = tf.transform;
+                const bool consistent = t.translation == base::Vector3d(i, 2.0 * i, 3.0 * i) &&
+                                        t.orientation.coeffs() == Eigen::Vector4d(i, i, i, i) &&
+                                        (t.cov.array() == static_cast<double>(i)).all();
+                //readers must never see an older transform than before
+                if(!consistent || i < last)
+                    ++tornReads;
+                last = i;
+                ++reads;
+            }
+        });
+    }
+    for(int i = 1; i <= numUpdates; ++i)
+    {
+        graph.updateTransform("odometry", "body", makeTransform(i));
+    }
+    done = true;
+    for(std::thread& reader : readers)
+        reader.join();
+
+    BOOST_CHECK_EQUAL(tornReads, 0);
+    BOOST_CHECK_EQUAL(transform->load().time.microseconds, numUpdates);
+}
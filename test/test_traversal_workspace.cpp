@@ -0,0 +1,38 @@
+#include <boost/test/unit_test.hpp>
+
+#include <envire_core/graph/TraversalWorkspace.hpp>
+
+using namespace envire::core;
+
+BOOST_AUTO_TEST_CASE(traversal_workspace_generation_test)
+{
+    TraversalWorkspace::Lease workspace = TraversalWorkspace::acquire();
+    workspace->reset(10);
+    BOOST_CHECK(!workspace->isVisited(3));
+    BOOST_CHECK(workspace->visit(3));
+    BOOST_CHECK(!workspace->visit(3));
+    BOOST_CHECK(workspace->isVisited(3));
+    workspace->setColor(5, boost::black_color);
+    BOOST_CHECK(workspace->getColor(5) == boost::black_color);
+
+    //a new traversal forgets everything
+    workspace->reset(20);
+    BOOST_CHECK(!workspace->isVisited(3));
+    BOOST_CHECK(workspace->getColor(5) == boost::white_color);
+    BOOST_CHECK(workspace->visit(15));
+}
+
+BOOST_AUTO_TEST_CASE(traversal_workspace_nested_lease_test)
+{
+    TraversalWorkspace* first = nullptr;
+    {
+        TraversalWorkspace::Lease outer = TraversalWorkspace::acquire();
+        TraversalWorkspace::Lease inner = TraversalWorkspace::acquire();
+        BOOST_CHECK(&*outer != &*inner);
+        first = &*outer;
+    }
+    //returned workspaces are reused
+    TraversalWorkspace::Lease a = TraversalWorkspace::acquire();
+    TraversalWorkspace::Lease b = TraversalWorkspace::acquire();
+    BOOST_CHECK(&*a == first || &*b == first);
+}